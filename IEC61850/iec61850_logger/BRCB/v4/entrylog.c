@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "entrylog.h"
+
+/* "EID1" */
+#define ENTRY_MAGIC 0x31444945u
+
+typedef struct {
+    uint8_t entryId[8];
+    uint32_t check;
+    uint32_t magic;
+} EntryRecord;
+
+struct sEntryLog {
+    char fileName[256];
+    FILE* file;
+    int appends;
+    uint8_t last[8];
+};
+
+/* FNV-1a over the EntryID */
+static uint32_t entryCheck(const uint8_t entryId[8])
+{
+    uint32_t h = 2166136261u;
+
+    for (int i = 0; i < 8; i++)
+        h = (h ^ entryId[i]) * 16777619u;
+
+    return h;
+}
+
+static void syncFile(FILE* f)
+{
+    fflush(f);
+
+#ifdef _WIN32
+    _commit(_fileno(f));
+#else
+    fsync(fileno(f));
+#endif
+}
+
+static int writeRecord(FILE* f, const uint8_t entryId[8])
+{
+    EntryRecord r;
+
+    memcpy(r.entryId, entryId, 8);
+    r.check = entryCheck(entryId);
+    r.magic = ENTRY_MAGIC;
+
+    int ok = fwrite(&r, sizeof(r), 1, f) == 1;
+    syncFile(f);
+
+    return ok;
+}
+
+/* Replace the journal by one holding only the newest record */
+static void checkpoint(EntryLog* l)
+{
+    char tmp[270];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", l->fileName);
+
+    FILE* f = fopen(tmp, "wb");
+
+    if (!f || !writeRecord(f, l->last)) {
+        printf("Cannot write %s\n", tmp);
+        if (f) fclose(f);
+        return;
+    }
+
+    fclose(f);
+    fclose(l->file);
+
+#ifdef _WIN32
+    int replaced = MoveFileExA(tmp, l->fileName, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    int replaced = rename(tmp, l->fileName) == 0;
+#endif
+
+    if (!replaced)
+        printf("Cannot replace %s\n", l->fileName);
+
+    l->file = fopen(l->fileName, "ab");
+    l->appends = 0;
+}
+
+EntryLog* entryLogOpen(const char* fileName, uint8_t last[8], int* found)
+{
+    EntryLog* l = calloc(1, sizeof(EntryLog));
+    EntryRecord r;
+
+    strncpy(l->fileName, fileName, sizeof(l->fileName) - 1);
+    *found = 0;
+
+    FILE* f = fopen(fileName, "rb");
+    long size = 0;
+
+    if (f) {
+        while (fread(&r, sizeof(r), 1, f) == 1) {
+            if (r.magic == ENTRY_MAGIC && r.check == entryCheck(r.entryId)) {
+                memcpy(l->last, r.entryId, 8);
+                *found = 1;
+            }
+        }
+
+        size = ftell(f);
+        fclose(f);
+    }
+
+    memcpy(last, l->last, 8);
+
+    /* nothing usable in a journal that is not empty: start it again */
+    l->file = fopen(fileName, (*found || size == 0) ? "ab" : "wb");
+
+    if (!l->file) {
+        printf("Cannot open %s\n", fileName);
+        free(l);
+        return NULL;
+    }
+
+    /* a torn record at the end would offset every record after it */
+    if (*found)
+        checkpoint(l);
+
+    return l;
+}
+
+void entryLogAppend(EntryLog* l, const uint8_t entryId[8])
+{
+    memcpy(l->last, entryId, 8);
+
+    if (!l->file || !writeRecord(l->file, entryId))
+        printf("Cannot append to %s\n", l->fileName);
+
+    if (++l->appends >= ENTRY_LOG_CHECKPOINT)
+        checkpoint(l);
+}
+
+void entryLogClose(EntryLog* l)
+{
+    if (!l)
+        return;
+
+    if (l->file)
+        fclose(l->file);
+
+    free(l);
+}
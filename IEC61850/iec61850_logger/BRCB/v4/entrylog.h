@@ -0,0 +1,28 @@
+/*
+ * Last EntryID logged of a buffered RCB, kept on disk across restarts
+ *
+ * An append-only journal of 16-byte records (EntryID, check, magic), each
+ * append forced to disk. On open the newest complete record wins, so a
+ * record torn by a crash is simply ignored. Every ENTRY_LOG_CHECKPOINT
+ * appends the journal is replaced by one holding only the newest record
+ * (written aside, forced to disk, then renamed over the journal).
+ */
+
+#ifndef ENTRYLOG_H
+#define ENTRYLOG_H
+
+#include <stdint.h>
+
+/* Appends before the journal is compacted */
+#define ENTRY_LOG_CHECKPOINT 4096
+
+typedef struct sEntryLog EntryLog;
+
+/* *found is 1 and last holds the newest EntryID if the journal had one */
+EntryLog* entryLogOpen(const char* fileName, uint8_t last[8], int* found);
+
+void entryLogAppend(EntryLog* l, const uint8_t entryId[8]);
+
+void entryLogClose(EntryLog* l);
+
+#endif /* ENTRYLOG_H */
@@ -1,3 +1,4 @@
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -11,155 +12,520 @@
 #endif
 
 #include "iec61850_client.h"
+#include "hal_thread.h"
 #include "mms_value.h"
 
+#include "clock.h"
+#include "entrylog.h"
+#include "logsink.h"
+#include "mmsfmt.h"
+#include "reportqueue.h"
+
 #define IED_IP   "10.10.6.100"
 #define IED_PORT 102
 
 #define RCB_REFERENCE "DCSRelay/LLN0.BR.brcbEV101"
 #define RPT_ID "BRCB1"
 
+/* Output files are rotated past this size (--rotate-mb) */
+#define ROTATE_MB 64
+
+/* Buffered output is written out at least this often */
+#define FLUSH_INTERVAL_MS 1000
+
+/* How often report rates are printed */
+#define STATS_INTERVAL_MS 10000
+
+#define RECONNECT_INTERVAL_MS 10000
+
+/* Seconds the IED keeps the BRCB reserved for us after the association is lost */
+#define RESV_TMS 300
+
+/* Latest value of every member, rewritten after a GI and at most this often otherwise */
+#define SNAPSHOT_FILE "BRCB-SNAPSHOT.csv"
+#define SNAPSHOT_INTERVAL_MS 60000
+
+#define LINE_SIZE 2048
+
+/* Opened once in main, written by the report callback */
+static LogSink* csvSink = NULL;
+static LogSink* jsonSink = NULL;
+
+/* --quiet: no per-entry console output */
+static int quiet = 0;
 
-/* Simple helper to get ISO time for when we received the report (local log time) */
-static void iso_now_utc(char *buf, size_t len)
+/* --log-gi: GI and integrity entries go to the event log as well */
+static int logSnapshots = 0;
+
+static volatile int running = 1;
+
+/* receive thread -> report writer, see reportqueue.h */
+static ReportQueue* reportQueue = NULL;
+static volatile int writerRunning = 1;
+
+/* written by the report callback only */
+static volatile long droppedReports = 0;
+static volatile long callbackCount = 0;
+static volatile int64_t callbackUsTotal = 0;
+static volatile int64_t callbackUsMax = 0;
+
+/* written by the report writer only */
+static volatile long reportCount = 0;
+static volatile long entryCount = 0;
+static volatile long snapshotCount = 0;
+
+/* EntryID of the last report handed to the sinks (8 bytes as one word), 0 if none yet */
+static uint64_t lastWrittenEntryId = 0;
+
+/* the IED lost buffered events (BufOvfl): the main loop sends a GI */
+static volatile int giRequested = 0;
+
+/* reports carry the RCB's own RptID, RPT_ID only if it has none */
+static char rptId[130];
+
+static void sigintHandler(int signalId)
 {
-    time_t t = time(NULL);
-    struct tm tm;
-#ifdef _WIN32
-    gmtime_s(&tm, &t);
-#else
-    gmtime_r(&t, &tm);
-#endif
-    strftime(buf, (int)len, "%Y-%m-%dT%H:%M:%SZ", &tm);
+    (void) signalId;
+    running = 0;
+}
+
+
+/* ISO time with ms of a log record; the date and time text is cached per second by fmtTime */
+static void iso_utc_ms(int64_t ms, char *buf, size_t len)
+{
+    *fmtTime(buf, buf + len, ms, 1) = 0;
+}
+
+/* t of a data object entry (the UTC time element of its structure), 0 if it has none */
+static int64_t entrySourceMs(MmsValue *v)
+{
+    if (MmsValue_getType(v) == MMS_UTC_TIME)
+        return (int64_t) MmsValue_getUtcTimeInMs(v);
+
+    if (MmsValue_getType(v) != MMS_STRUCTURE)
+        return 0;
+
+    for (int i = (int) MmsValue_getArraySize(v) - 1; i >= 0; i--) {
+        MmsValue *e = MmsValue_getElement(v, i);
+
+        if (e && MmsValue_getType(e) == MMS_UTC_TIME)
+            return (int64_t) MmsValue_getUtcTimeInMs(e);
+    }
+
+    return 0;
 }
 
 /* ============================
    Utility: print MMS value
    ============================
-   Convert an MmsValue element into text (safe fallback if unknown) */
+   Convert an MmsValue element into text; structures in one pass, see mmsfmt.h */
 static void mmsValueToString(MmsValue *v, char *out, int outLen)
 {
-    if (!v) {
-        strncpy(out, "<null>", outLen - 1);
-        out[outLen-1] = '\0';
-        return;
-    }
+    *fmtMmsValue(out, out + outLen, v) = 0;
+}
 
-    MmsType type = MmsValue_getType(v);
+/* ============================
+   Data set columns
+   ============================
+   Resolved once when reporting is enabled: entry i of every report is the
+   data set's member i, with its CSV and JSON keys rendered in advance */
 
-    switch (type) {
-        case MMS_BOOLEAN:
-            snprintf(out, outLen, "%s", MmsValue_getBoolean(v) ? "TRUE" : "FALSE");
-            break;
+typedef struct {
+    char csvKey[140];       /* "GenericIO/GGIO1.SPCSO1.stVal[ST]" */
+    char jsonKey[160];      /* "\",\"tag\":\"GenericIO/GGIO1.SPCSO1.stVal[ST]" */
+} DataSetColumn;
 
-        case MMS_INTEGER:
-            snprintf(out, outLen, "%lld", (long long) MmsValue_toInt64(v));
-            break;
+static DataSetColumn* columns = NULL;
+static int columnCount = 0;
 
-        case MMS_UNSIGNED:
-            /* older API uses toInt64 for unsigned too; print as unsigned-looking */
-            snprintf(out, outLen, "%llu", (unsigned long long) MmsValue_toInt64(v));
-            break;
+/* Text of every ReasonForInclusion bit combination, "dchg|qchg" */
+static char reasonText[64][48];
 
-        case MMS_FLOAT:
-            snprintf(out, outLen, "%f", MmsValue_toFloat(v));
-            break;
+static void buildReasonTexts(void)
+{
+    static const char* names[] = { "dchg", "qchg", "dupd", "integrity", "gi", "app" };
+
+    for (int bits = 0; bits < 64; bits++) {
+        char* end = reasonText[bits] + sizeof(reasonText[bits]);
+        char* p = reasonText[bits];
 
-        case MMS_VISIBLE_STRING:
-        case MMS_OCTET_STRING:
-        case MMS_STRING: {
-            const char *s = MmsValue_toString(v);
-            if (s && s[0] != '\0') {
-                strncpy(out, s, outLen - 1);
-                out[outLen-1] = '\0';
-            } else {
-                snprintf(out, outLen, "<empty>");
+        for (int k = 0; k < 6; k++) {
+            if (bits & (1 << k)) {
+                if (p != reasonText[bits])
+                    p = fmtText(p, end, "|");
+                p = fmtText(p, end, names[k]);
             }
-            break;
         }
 
-        case MMS_UTC_TIME: {
-            uint64_t ms = MmsValue_getUtcTimeInMs(v);
-            time_t sec = (time_t)(ms / 1000);
-            struct tm tm;
+        *p = 0;
+    }
+}
+
+static void setColumn(DataSetColumn* c, const char* tag)
+{
+    char* end = c->csvKey + sizeof(c->csvKey);
+    *fmtText(c->csvKey, end, tag) = 0;
+
+    end = c->jsonKey + sizeof(c->jsonKey);
+    char* p = fmtText(c->jsonKey, end, "\",\"tag\":\"");
+    *fmtText(p, end, tag) = 0;
+}
+
+/* dataSetRef as the RCB holds it, "GenericIO/LLN0$Events" */
+static void resolveDataSetColumns(IedConnection con, const char* dataSetRef)
+{
+    char ref[130];
+    IedClientError err;
+    bool deletable;
+
+    strncpy(ref, dataSetRef ? dataSetRef : "", sizeof(ref) - 1);
+    ref[sizeof(ref) - 1] = 0;
+
+    for (char* c = ref; *c; c++)
+        if (*c == '$') *c = '.';
+
+    LinkedList directory = IedConnection_getDataSetDirectory(con, &err, ref, &deletable);
+
+    if (err != IED_ERROR_OK || directory == NULL) {
+        printf("Cannot read data set %s (%d), entries are logged by index\n", ref, err);
+        return;
+    }
+
+    columnCount = 0;
+    for (LinkedList e = LinkedList_getNext(directory); e; e = LinkedList_getNext(e))
+        columnCount++;
+
+    columns = calloc(columnCount, sizeof(DataSetColumn));
+
+    int i = 0;
+    for (LinkedList e = LinkedList_getNext(directory); e; e = LinkedList_getNext(e))
+        setColumn(&columns[i++], (const char*) LinkedList_getData(e));
+
+    LinkedList_destroy(directory);
+
+    printf("Data set %s: %d members\n", ref, columnCount);
+}
+
+/* The column of a data set index; entries the directory did not list are named by index */
+static const DataSetColumn* columnOf(int index)
+{
+    static __thread DataSetColumn unnamed;
+
+    if (index < columnCount)
+        return &columns[index];
+
+    char name[16];
+    char* end = name + sizeof(name);
+    char* p = fmtText(name, end, "[");
+    p = fmtInt64(p, end, index);
+    *fmtText(p, end, "]") = 0;
+
+    setColumn(&unnamed, name);
+    return &unnamed;
+}
+
+/* ============================
+   Snapshot channel
+   ============================
+   Entries sent only because of a GI or an integrity period restate values
+   the log already has. They update the latest value of their member, which
+   is checkpointed to SNAPSHOT_FILE; only data changes (dchg, qchg, dupd,
+   app) go to the event log */
+
+#define EVENT_REASONS (IEC61850_REASON_DATA_CHANGE | IEC61850_REASON_QUALITY_CHANGE | \
+                       IEC61850_REASON_DATA_UPDATE | IEC61850_REASON_UNKNOWN)
+
+typedef struct {
+    char value[256];
+    char source[32];
+    char time[32];
+    uint8_t reasons;
+    uint8_t known;
+} LatestValue;
+
+/* written by the report writer only */
+static LatestValue* latest = NULL;
+static int latestCount = 0;
+static int snapshotDirty = 0;
+static int snapshotAfterGi = 0;
+static int64_t snapshotWrittenMs = 0;
+
+static int isSnapshotEntry(int reasons)
+{
+    return (reasons & (IEC61850_REASON_GI | IEC61850_REASON_INTEGRITY)) != 0 && (reasons & EVENT_REASONS) == 0;
+}
+
+static void updateLatest(int index, const char* value, const char* source, const char* time, int reasons)
+{
+    if (index >= latestCount) {
+        int n = index < columnCount ? columnCount : index + 1;
+
+        latest = realloc(latest, n * sizeof(LatestValue));
+        memset(latest + latestCount, 0, (n - latestCount) * sizeof(LatestValue));
+        latestCount = n;
+    }
+
+    LatestValue* l = &latest[index];
+
+    *fmtText(l->value, l->value + sizeof(l->value), value) = 0;
+    *fmtText(l->source, l->source + sizeof(l->source), source) = 0;
+    *fmtText(l->time, l->time + sizeof(l->time), time) = 0;
+    l->reasons = (uint8_t) reasons;
+    l->known = 1;
+
+    snapshotDirty = 1;
+    if (reasons & IEC61850_REASON_GI)
+        snapshotAfterGi = 1;
+}
+
+/* One line per member, written aside and renamed over the last checkpoint */
+static void writeSnapshot(void)
+{
+    const char* tmp = SNAPSHOT_FILE ".tmp";
+    FILE* f = fopen(tmp, "w");
+
+    if (!f) {
+        printf("Cannot write %s\n", tmp);
+        return;
+    }
+
+    fprintf(f, "tag,value,sourceTime,time,reason\n");
+
+    for (int i = 0; i < latestCount; i++) {
+        LatestValue* l = &latest[i];
+
+        if (l->known)
+            fprintf(f, "%s,%s,%s,%s,%s\n", columnOf(i)->csvKey, l->value, l->source, l->time, reasonText[l->reasons & 63]);
+    }
+
+    fclose(f);
+
 #ifdef _WIN32
-            gmtime_s(&tm, &sec);
+    if (!MoveFileExA(tmp, SNAPSHOT_FILE, MOVEFILE_REPLACE_EXISTING))
 #else
-            gmtime_r(&sec, &tm);
+    if (rename(tmp, SNAPSHOT_FILE) != 0)
 #endif
-            strftime(out, outLen, "%Y-%m-%dT%H:%M:%SZ", &tm);
+        printf("Cannot replace %s\n", SNAPSHOT_FILE);
+
+    snapshotDirty = 0;
+    snapshotAfterGi = 0;
+    snapshotWrittenMs = clockWallMs();
+}
+
+/* Called when the queue is empty, so a GI is checkpointed once it is complete */
+static void checkpointSnapshot(void)
+{
+    if (snapshotDirty && (snapshotAfterGi || clockWallMs() - snapshotWrittenMs >= SNAPSHOT_INTERVAL_MS))
+        writeSnapshot();
+}
+
+/* ============================
+   Report writer thread
+   ============================
+   Decodes and formats the reports queued by the callback, off the receive thread */
+
+static void writeReport(ReportRecord* r)
+{
+    /* local receive time; entries without their own t get the report's TimeOfEntry */
+    char now[32];
+    iso_utc_ms(r->receiveUs / 1000, now, sizeof(now));
+
+    if (!quiet)
+        printf("Report %s received %s (%d entries):\n", r->rptId, now, r->entryCount);
+
+    int pos = 0;
+
+    for (int i = 0; i < r->entryCount; i++) {
+        /* the values were encoded back to back; bufferLength is counted from pos */
+        MmsValue* val = MmsValue_decodeMmsData(r->payload, pos, r->payloadLength - pos, &pos);
+
+        if (val == NULL) {
+            printf("Report %s: undecodable entry %d\n", r->rptId, r->entries[i]);
             break;
         }
-		case MMS_BIT_STRING:
-			MmsValue_printToBuffer(v, out, (int)outLen);
-			break;
-
-        case MMS_STRUCTURE:
-        case MMS_ARRAY: {
-            /* stringify members into a compact {...} representation */
-			out[0] = '\0';
-            strncat(out, "{", outLen-1);
-            int n = MmsValue_getArraySize(v);
-            for (int i = 0; i < n; ++i) {
-                MmsValue *e = MmsValue_getElement(v, i);
-                char tmp[256];
-                mmsValueToString(e, tmp, sizeof(tmp));
-                strncat(out, tmp, outLen - strlen(out) - 1);
-                if (i != n-1) strncat(out, ",", outLen - strlen(out) - 1);
-            }
-            strncat(out, "}", outLen - strlen(out) - 1);
-            break;
+
+        const DataSetColumn* column = columnOf(r->entries[i]);
+        const char* reason = reasonText[r->reasons[i] & 63];
+        int snapshot = isSnapshotEntry(r->reasons[i]);
+
+        char valbuf[1024];
+        mmsValueToString(val, valbuf, sizeof(valbuf));
+
+        char source[32] = "";
+        int64_t sourceMs = entrySourceMs(val);
+
+        if (sourceMs == 0)
+            sourceMs = r->timeOfEntryMs;
+        if (sourceMs != 0)
+            iso_utc_ms(sourceMs, source, sizeof(source));
+
+        MmsValue_delete(val);
+
+        updateLatest(r->entries[i], valbuf, source, now, r->reasons[i]);
+
+        if (snapshot) {
+            snapshotCount++;
+
+            if (!logSnapshots)
+                continue;
         }
 
-        default:
-            /* fallback: ask library to print if available */
-            if (MmsValue_printToBuffer(v, out, outLen) != 0) {
-                snprintf(out, outLen, "UNSUPPORTED(%d)", type);
-            }
+        if (!quiet)
+            printf("  %s = %s  (%s, t %s)\n", column->csvKey, valbuf, reason, source);
+
+        /* the lines are pieced together, no format string is parsed per entry */
+        char line[LINE_SIZE];
+        char* end = line + sizeof(line);
+        char* p = fmtText(line, end, now);
+        p = fmtText(p, end, ",");
+        p = fmtText(p, end, column->csvKey);
+        p = fmtText(p, end, ",");
+        p = fmtText(p, end, reason);
+        p = fmtText(p, end, ",");
+        p = fmtText(p, end, valbuf);
+        p = fmtText(p, end, ",");
+        p = fmtText(p, end, source);
+        p = fmtText(p, end, "\n");
+        logSinkWrite(csvSink, line, (int) (p - line));
+
+        p = fmtText(line, end, "{\"time\":\"");
+        p = fmtText(p, end, now);
+        p = fmtText(p, end, column->jsonKey);
+        p = fmtText(p, end, "\",\"reason\":\"");
+        p = fmtText(p, end, reason);
+        p = fmtText(p, end, "\",\"value\":\"");
+        p = fmtText(p, end, valbuf);
+        p = fmtText(p, end, "\",\"t\":\"");
+        p = fmtText(p, end, source);
+        p = fmtText(p, end, "\"}\n");
+        logSinkWrite(jsonSink, line, (int) (p - line));
+    }
+
+    if (!quiet)
+        printf("----\n");
+
+    entryCount += r->entryCount;
+    reportCount++;
+
+    if (r->hasEntryId) {
+        uint64_t id;
+        memcpy(&id, r->entryId, 8);
+        __atomic_store_n(&lastWrittenEntryId, id, __ATOMIC_RELEASE);
+    }
+
+    if (r->bufOvfl) {
+        printf("Report %s: IED buffer overflowed, events lost\n", r->rptId);
+        giRequested = 1;
+    }
+}
+
+static void*
+reportWriter(void* parameter)
+{
+    (void) parameter;
+
+    while (1) {
+        ReportRecord* r = reportQueuePeek(reportQueue);
+
+        if (r) {
+            writeReport(r);
+            reportQueueRelease(reportQueue);
+            continue;
+        }
+
+        checkpointSnapshot();
+
+        if (writerRunning)
+            Thread_sleep(1);
+        else
             break;
     }
+
+    if (snapshotDirty)
+        writeSnapshot();
+
+    return NULL;
 }
 
 /* ============================
    Report callback (v1.6 SAFE)
-   ============================ */
+   ============================
+   Runs on the MMS receive thread: copy the report into the queue and return */
 
 static void
 reportCallback(void* parameter, ClientReport report)
 {
     (void) parameter;
 
+    int64_t startUs = clockWallUs();
+
     MmsValue* values = ClientReport_getDataSetValues(report);
 
-    if (values == NULL) {
-        printf("Report received with no dataset values\n");
+    if (values == NULL || MmsValue_getType(values) != MMS_ARRAY) {
+        printf("Report received without data set values\n");
         return;
     }
 
-    if (MmsValue_getType(values) != MMS_ARRAY) {
-        printf("Unexpected dataset type: %d\n", MmsValue_getType(values));
+    ReportRecord* r = reportQueueReserve(reportQueue);
+
+    if (r == NULL) {
+        droppedReports++;
         return;
     }
 
-    int count = MmsValue_getArraySize(values);
+    r->receiveUs = startUs;
 
-    printf("Report received (%d entries):\n", count);
-     
-    FILE* csv = fopen("BRCB-LOG.csv", "a");
-    FILE* json = fopen("BRCB-LOG.json", "a");
+    const char* reportRptId = ClientReport_getRptId(report);
+    strncpy(r->rptId, reportRptId ? reportRptId : "", sizeof(r->rptId) - 1);
+    r->rptId[sizeof(r->rptId) - 1] = 0;
 
-    for (int i = 0; i < count; i++) {
-        MmsValue* val = MmsValue_getElement(values, i);
-        printf("  [%d] ", i);
-		char valbuf[1024];
-        mmsValueToString(val, valbuf, sizeof(valbuf));
-        printf("%s\n", valbuf);
-        fprintf(csv, "%s\n", valbuf);
-        fprintf(json, "{\"value\":\"%s\"}\n", valbuf);
+    r->hasSeqNum = ClientReport_hasSeqNum(report);
+    r->seqNum = r->hasSeqNum ? (uint32_t) ClientReport_getSeqNum(report) : 0;
+
+    MmsValue* entryId = ClientReport_getEntryId(report);
+    r->hasEntryId = entryId != NULL && MmsValue_getOctetStringSize(entryId) == 8;
+    if (r->hasEntryId)
+        memcpy(r->entryId, MmsValue_getOctetStringBuffer(entryId), 8);
+
+    r->timeOfEntryMs = ClientReport_hasTimestamp(report) ? (int64_t) ClientReport_getTimestamp(report) : 0;
+    r->bufOvfl = ClientReport_hasBufOvfl(report) && ClientReport_getBufOvfl(report);
+
+    /* only the entries this report includes; the others hold older values, or none yet */
+    int hasReasons = ClientReport_hasReasonForInclusion(report);
+    int size = MmsValue_getArraySize(values);
+    int pos = 0;
+
+    r->entryCount = 0;
+
+    for (int i = 0; i < size && r->entryCount < REPORT_MAX_ENTRIES; i++) {
+        ReasonForInclusion reason = hasReasons ? ClientReport_getReasonForInclusion(report, i) : IEC61850_REASON_NOT_INCLUDED;
+        MmsValue* value = MmsValue_getElement(values, i);
+
+        if (value == NULL || (hasReasons && reason == IEC61850_REASON_NOT_INCLUDED))
+            continue;
+
+        if (pos + MmsValue_encodeMmsData(value, NULL, 0, false) > REPORT_PAYLOAD_SIZE) {
+            droppedReports++;
+            return;
+        }
+
+        pos = MmsValue_encodeMmsData(value, r->payload, pos, true);
+
+        r->entries[r->entryCount] = (uint16_t) i;
+        r->reasons[r->entryCount] = (uint8_t) reason;
+        r->entryCount++;
     }
 
-    printf("----\n");
-    
+    r->payloadLength = pos;
+
+    reportQueuePublish(reportQueue);
+
+    int64_t us = clockWallUs() - startUs;
+
+    callbackCount++;
+    callbackUsTotal += us;
+    if (us > callbackUsMax)
+        callbackUsMax = us;
 }
 
 /* ============================
@@ -191,115 +557,306 @@ static void triggerGI(IedConnection con, ClientReportControlBlock rcb)
 }
 
 /* ============================
-   Main
-   ============================ */
+   Enable reporting
+   ============================
+   ResvTms, TrgOps/OptFlds, EntryID, then RptEna: the EntryID is set
+   after anything that purges the buffer. Resume from the last EntryID
+   logged while the IED still buffers it, GI only when it does not
+   (first run, EntryID refused) or when a report carries BufOvfl */
 
-int
-main(int argc, char** argv)
+static ClientReportControlBlock enableReporting(IedConnection con, const char* rcbRef, const uint8_t* resumeEntryId)
 {
-    (void) argc;
-    (void) argv;
-
     IedClientError error;
-    IedConnection con = IedConnection_create();
 
-    IedConnection_connect(con, &error, IED_IP, IED_PORT);
+    ClientReportControlBlock rcb = IedConnection_getRCBValues(con, &error, rcbRef, NULL);
 
-    if (error != IED_ERROR_OK) {
-        printf("Connection failed: %d\n", error);
-        IedConnection_destroy(con);
-        return -1;
+    if (error != IED_ERROR_OK || rcb == NULL) {
+        printf("Failed to read RCB: %d\n", error);
+        return NULL;
     }
 
-    printf("Connected to server\n");
-	
-    FILE* csv = fopen("BRCB-LOG.csv", "w");
-    FILE* json = fopen("BRCB-LOG.json", "w");
+    printf("RCB acquired\n");
+    printf("\tRptID  : %s\n", ClientReportControlBlock_getRptId(rcb));
+    printf("\tRptEna  : %i\n", ClientReportControlBlock_getRptEna(rcb));
+    printf("\tResv  : %i\n", ClientReportControlBlock_getResv(rcb));
+    printf("\tDataSet  : %s\n", ClientReportControlBlock_getDataSetReference(rcb));
+    printf("\tObjectReference  : %s\n", ClientReportControlBlock_getObjectReference(rcb));
 
-    fprintf(csv, "time,tag,value\n");
+    const char* rcbRptId = ClientReportControlBlock_getRptId(rcb);
+    strncpy(rptId, rcbRptId && rcbRptId[0] ? rcbRptId : RPT_ID, sizeof(rptId) - 1);
 
-    /* ---- BRCB path (v1.6 canonical form) ---- */
-    const char* rcbRef = RCB_REFERENCE;
+    /* column names, once */
+    if (columns == NULL)
+        resolveDataSetColumns(con, ClientReportControlBlock_getDataSetReference(rcb));
 
-    ClientReportControlBlock rcb =
-        IedConnection_getRCBValues(con, &error, rcbRef, NULL);
+    /* keep the BRCB (and its buffer) ours while we reconnect; Edition 1 IEDs refuse it */
+    ClientReportControlBlock_setResvTms(rcb, RESV_TMS);
+    IedConnection_setRCBValues(con, &error, rcb, RCB_ELEMENT_RESV_TMS, true);
 
-    if (error != IED_ERROR_OK || rcb == NULL) {
-        printf("Failed to read RCB: %d\n", error);
-        IedConnection_destroy(con);
-        return -1;
+    if (error != IED_ERROR_OK)
+        printf("ResvTms not accepted: %d\n", error);
+
+    /* Enable data-change, integrity and GI reports */
+    int trgOps = TRG_OPT_DATA_CHANGED | TRG_OPT_INTEGRITY | TRG_OPT_GI;
+
+    /* Optional fields: timestamp, reason, and what resuming needs */
+    int optFlds = RPT_OPT_TIME_STAMP | RPT_OPT_REASON_FOR_INCLUSION | RPT_OPT_SEQ_NUM |
+                  RPT_OPT_ENTRY_ID | RPT_OPT_BUFFER_OVERFLOW;
+
+    /* the IED purges its buffer when these are written, so before the EntryID and only if they differ */
+    if (ClientReportControlBlock_getTrgOps(rcb) != trgOps || ClientReportControlBlock_getOptFlds(rcb) != optFlds) {
+        ClientReportControlBlock_setTrgOps(rcb, trgOps);
+        ClientReportControlBlock_setOptFlds(rcb, optFlds);
+
+        IedConnection_setRCBValues(con, &error, rcb, RCB_ELEMENT_TRG_OPS | RCB_ELEMENT_OPT_FLDS, true);
+
+        if (error != IED_ERROR_OK) {
+            printf("Failed to set trigger options: %d\n", error);
+            ClientReportControlBlock_destroy(rcb);
+            return NULL;
+        }
+
+        printf("Trigger options and optional fields written, the IED's buffer is purged\n");
     }
 
-    printf("RCB acquired\n");
-    printf("\tRptID  : %s\n", ClientReportControlBlock_getRptId(rcb));
-	printf("\tRptEna  : %i\n", ClientReportControlBlock_getRptEna(rcb));
-	printf("\tResv  : %i\n", ClientReportControlBlock_getResv(rcb));
-	printf("\tDataSet  : %s\n", ClientReportControlBlock_getDataSetReference(rcb));
-	printf("\tObjectReference  : %s\n", ClientReportControlBlock_getObjectReference(rcb));
-	
-	/* Enable data-change and integrity reports */
-	ClientReportControlBlock_setTrgOps(
-		rcb,
-		TRG_OPT_DATA_CHANGED |
-		TRG_OPT_INTEGRITY
-	);
-
-	/* Optional fields: timestamp + reason */
-	ClientReportControlBlock_setOptFlds(
-		rcb,
-		RPT_OPT_TIME_STAMP |
-		RPT_OPT_REASON_FOR_INCLUSION
-	);
-	
-
-    /* ---- Enable reporting ---- */
-    ClientReportControlBlock_setRptEna(rcb, true);
+    /* the IED sends what it buffered after this entry; it refuses an entry it no longer has */
+    int resumed = 0;
 
-    /* ---- Write RCB values (v1.6 signature!) ---- */
-    IedConnection_setRCBValues(
+    if (resumeEntryId && ClientReportControlBlock_isBuffered(rcb)) {
+        MmsValue* entryId = MmsValue_newOctetString(8, 8);
+        MmsValue_setOctetString(entryId, (uint8_t*) resumeEntryId, 8);
+
+        ClientReportControlBlock_setEntryId(rcb, entryId);
+        MmsValue_delete(entryId);
+
+        IedConnection_setRCBValues(con, &error, rcb, RCB_ELEMENT_ENTRY_ID, true);
+        resumed = error == IED_ERROR_OK;
+
+        printf(resumed ? "Resuming after the last EntryID logged\n"
+                       : "EntryID no longer buffered by the IED, GI follows\n");
+    }
+
+    /* installed before RptEna, the buffered reports follow right away */
+    IedConnection_installReportHandler(
         con,
-        &error,
-        rcb,
-        RCB_ELEMENT_RPT_ENA |
-		RCB_ELEMENT_TRG_OPS |
-		RCB_ELEMENT_OPT_FLDS,
-        true   /* singleRequest */
+        rcbRef,
+        rptId,
+        reportCallback,
+        NULL
     );
 
+    /* RptEna alone: written together with other elements the IED could purge the buffer again */
+    ClientReportControlBlock_setRptEna(rcb, true);
+
+    IedConnection_setRCBValues(con, &error, rcb, RCB_ELEMENT_RPT_ENA, true);
+
     if (error != IED_ERROR_OK) {
         printf("Failed to enable reporting: %d\n", error);
+        IedConnection_uninstallReportHandler(con, rcbRef);
         ClientReportControlBlock_destroy(rcb);
-        IedConnection_destroy(con);
-        return -1;
+        return NULL;
     }
 
     printf("Reporting enabled\n");
 
-    /* ---- Add GI trigger ---- */
-    triggerGI(con, rcb);
+    if (!resumed)
+        triggerGI(con, rcb);
 
+    return rcb;
+}
 
-    /* ---- Install report handler ---- */
-    IedConnection_installReportHandler(
-        con,
-        rcbRef,
-		RPT_ID,
-        reportCallback,
-        NULL
-    );
-    printf("Report handler installed. Waiting for reports (Ctrl-C to stop)...\n");
+/* ============================
+   Main
+   ============================ */
+
+static uint64_t persistedEntryId = 0;
+
+/* Lines to disk first, then the EntryID of the last report among them */
+static void flushAndCheckpoint(EntryLog* entryLog)
+{
+    uint64_t id = __atomic_load_n(&lastWrittenEntryId, __ATOMIC_ACQUIRE);
+
+    if (entryLog && id != 0 && id != persistedEntryId) {
+        uint8_t entryId[8];
+        memcpy(entryId, &id, 8);
+
+        /* forced to disk like the journal: a checkpoint must never get ahead of the lines */
+        logSinkSync(csvSink);
+        logSinkSync(jsonSink);
+
+        entryLogAppend(entryLog, entryId);
+        persistedEntryId = id;
+    }
+    else {
+        logSinkFlush(csvSink);
+        logSinkFlush(jsonSink);
+    }
+}
+
+int
+main(int argc, char** argv)
+{
+    char host[128] = IED_IP;
+    int port = IED_PORT;
+    const char* rcbRef = RCB_REFERENCE;
+    int rotateMb = ROTATE_MB;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--ied") == 0 && i + 1 < argc) {
+            strncpy(host, argv[++i], sizeof(host) - 1);
+
+            char* colon = strchr(host, ':');
+            if (colon) {
+                *colon = 0;
+                port = atoi(colon + 1);
+            }
+        }
+        else if (strcmp(argv[i], "--rcb") == 0 && i + 1 < argc)
+            rcbRef = argv[++i];
+        else if (strcmp(argv[i], "--rotate-mb") == 0 && i + 1 < argc)
+            rotateMb = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--quiet") == 0)
+            quiet = 1;
+        else if (strcmp(argv[i], "--log-gi") == 0)
+            logSnapshots = 1;
+        else {
+            printf("Usage: %s [--ied host[:port]] [--rcb LD/LN.BR.rcb] [--rotate-mb n] [--log-gi] [--quiet]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    clockInit();
+    buildReasonTexts();
+
+    /* kept open for the whole run, see logsink.h */
+    csvSink = logSinkOpen("BRCB-LOG", "csv", "time,tag,reason,value,sourceTime\n", (long long) rotateMb << 20);
+    jsonSink = logSinkOpen("BRCB-LOG", "json", NULL, (long long) rotateMb << 20);
+
+    if (!csvSink || !jsonSink)
+        return -1;
+
+    /* BRCB-GenericIO_LLN0_BR_EventsBRCB01.entryid: last EntryID logged, see entrylog.h */
+    char rcbName[130];
+    strncpy(rcbName, rcbRef, sizeof(rcbName) - 1);
+    for (char* c = rcbName; *c; c++)
+        if (*c == '/' || *c == '.' || *c == '$') *c = '_';
+
+    char entryLogName[150];
+    snprintf(entryLogName, sizeof(entryLogName), "BRCB-%s.entryid", rcbName);
+
+    uint8_t resumeEntryId[8];
+    int haveEntryId;
+    EntryLog* entryLog = entryLogOpen(entryLogName, resumeEntryId, &haveEntryId);
+
+    if (haveEntryId) {
+        memcpy(&persistedEntryId, resumeEntryId, 8);
+        lastWrittenEntryId = persistedEntryId;
+    }
+
+    /* ---- Report writer, fed by the handler ---- */
+    reportQueue = reportQueueCreate();
+
+    Thread writer = Thread_create(reportWriter, NULL, false);
+    Thread_start(writer);
+
+    signal(SIGINT, sigintHandler);
+
+    int sinceStats = 0;
+    long lastReports = 0;
+
+    /* ---- Connect, enable, log until the association is lost; then again ---- */
+    while (running) {
+        IedClientError error;
+        IedConnection con = IedConnection_create();
+
+        IedConnection_connect(con, &error, host, port);
+
+        ClientReportControlBlock rcb = NULL;
+
+        if (error == IED_ERROR_OK) {
+            printf("Connected to server\n");
+
+            /* the newest EntryID on disk; after a reconnect that is the last one flushed */
+            flushAndCheckpoint(entryLog);
+
+            uint8_t entryId[8];
+            memcpy(entryId, &persistedEntryId, 8);
+
+            rcb = enableReporting(con, rcbRef, persistedEntryId != 0 ? entryId : NULL);
+        }
+        else
+            printf("Connection failed: %d\n", error);
+
+        if (rcb) {
+            printf("Waiting for reports (Ctrl-C to stop)...\n");
+            giRequested = 0;
+        }
+
+        /* ---- write the buffered lines out, print the rates ---- */
+        int waited = 0;
+
+        while (running) {
+            if (rcb && IedConnection_getState(con) != IED_STATE_CONNECTED) {
+                printf("Connection lost\n");
+                break;
+            }
+
+            if (!rcb && waited >= RECONNECT_INTERVAL_MS)
+                break;
+
+            Sleep(FLUSH_INTERVAL_MS);
+            waited += FLUSH_INTERVAL_MS;
+
+            flushAndCheckpoint(entryLog);
+
+            if (rcb && giRequested) {
+                giRequested = 0;
+                triggerGI(con, rcb);
+            }
+
+            sinceStats += FLUSH_INTERVAL_MS;
+
+            if (sinceStats >= STATS_INTERVAL_MS) {
+                long reports = reportCount;
+
+                printf("Reports: %ld (%.0f/s), %ld entries (%ld GI/integrity to the snapshot), %ld dropped, %lld bytes logged\n",
+                       reports, (reports - lastReports) * 1000.0 / sinceStats, (long) entryCount, (long) snapshotCount,
+                       (long) droppedReports, logSinkBytesWritten(csvSink) + logSinkBytesWritten(jsonSink));
+
+                if (callbackCount > 0)
+                    printf("Report handler: %.1f us mean, %lld us max on the receive thread\n",
+                           (double) callbackUsTotal / callbackCount, (long long) callbackUsMax);
+
+                lastReports = reports;
+                sinceStats = 0;
+            }
+        }
+
+        /* ---- Cleanup of this association ---- */
+        if (rcb) {
+            if (!running && IedConnection_getState(con) == IED_STATE_CONNECTED) {
+                ClientReportControlBlock_setRptEna(rcb, false);
+                IedConnection_setRCBValues(con, &error, rcb, RCB_ELEMENT_RPT_ENA, true);
+            }
+
+            IedConnection_uninstallReportHandler(con, rcbRef);
+            ClientReportControlBlock_destroy(rcb);
+        }
+
+        IedConnection_close(con);
+        IedConnection_destroy(con);
+    }
+
+    /* the writer empties the queue before it ends */
+    writerRunning = 0;
+    Thread_destroy(writer);
+    reportQueueDestroy(reportQueue);
 
-    /* ---- Run forever ---- */
-    while (1)
-        Sleep(1000);
+    flushAndCheckpoint(entryLog);
+    entryLogClose(entryLog);
 
-    /* ---- Cleanup (never reached) ---- */
-    ClientReportControlBlock_destroy(rcb);
-    
-	fclose(csv);
-    fclose(json);    
+    logSinkClose(csvSink);
+    logSinkClose(jsonSink);
 
-    IedConnection_close(con);
-    IedConnection_destroy(con);
     return 0;
 }
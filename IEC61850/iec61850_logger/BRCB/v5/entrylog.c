@@ -0,0 +1,337 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "hal_thread.h"
+
+#include "entrylog.h"
+
+/* "EID2" */
+#define ENTRY_MAGIC 0x32444945u
+
+typedef struct {
+    uint64_t key;
+    uint8_t entryId[8];
+    uint32_t check;
+    uint32_t magic;
+} EntryRecord;
+
+typedef struct {
+    uint64_t key;           /* 0: free */
+    uint8_t entryId[8];     /* newest set */
+    uint8_t committed[8];   /* newest on disk */
+    int hasCommitted;
+    int changed;            /* set since the last snapshot */
+} EntrySlot;
+
+struct sEntryLog {
+    char fileName[256];
+    FILE* file;
+    int appends;
+
+    Semaphore lock;         /* slots: workers find, the writer sets, the main loop snapshots */
+    EntrySlot* slots;       /* open addressing by key */
+    int capacity;           /* power of two */
+    int count;
+
+    EntryRecord* staged;    /* main loop only: the snapshot to commit */
+    int stagedCount;
+    int stagedCapacity;
+};
+
+/* FNV-1a */
+static uint64_t hashBytes(uint64_t h, const void* data, int length)
+{
+    const uint8_t* p = data;
+
+    for (int i = 0; i < length; i++)
+        h = (h ^ p[i]) * 1099511628211ull;
+
+    return h;
+}
+
+uint64_t entryLogKey(const char* ied, const char* rcbRef)
+{
+    uint64_t h = hashBytes(14695981039346656037ull, ied, (int) strlen(ied));
+    h = hashBytes(h, "/", 1);
+    h = hashBytes(h, rcbRef, (int) strlen(rcbRef));
+
+    /* 0 marks a free slot */
+    return h ? h : 1;
+}
+
+static uint32_t recordCheck(const EntryRecord* r)
+{
+    uint64_t h = hashBytes(14695981039346656037ull, &r->key, 8);
+    return (uint32_t) hashBytes(h, r->entryId, 8);
+}
+
+static void syncFile(FILE* f)
+{
+    fflush(f);
+
+#ifdef _WIN32
+    _commit(_fileno(f));
+#else
+    fsync(fileno(f));
+#endif
+}
+
+/* Called with the lock held, or before the log is shared */
+static EntrySlot* findSlot(EntryLog* l, uint64_t key, int add)
+{
+    if (add && 2 * (l->count + 1) > l->capacity) {
+        EntrySlot* old = l->slots;
+        int oldCapacity = l->capacity;
+
+        l->capacity = l->capacity ? 2 * l->capacity : 256;
+        l->slots = calloc(l->capacity, sizeof(EntrySlot));
+
+        for (int i = 0; i < oldCapacity; i++) {
+            if (old[i].key == 0)
+                continue;
+
+            int k = (int) (old[i].key & (l->capacity - 1));
+            while (l->slots[k].key != 0)
+                k = (k + 1) & (l->capacity - 1);
+
+            l->slots[k] = old[i];
+        }
+
+        free(old);
+    }
+
+    if (l->capacity == 0)
+        return NULL;
+
+    int k = (int) (key & (l->capacity - 1));
+
+    while (l->slots[k].key != 0) {
+        if (l->slots[k].key == key)
+            return &l->slots[k];
+        k = (k + 1) & (l->capacity - 1);
+    }
+
+    if (!add)
+        return NULL;
+
+    l->slots[k].key = key;
+    l->count++;
+
+    return &l->slots[k];
+}
+
+static int writeRecord(FILE* f, uint64_t key, const uint8_t entryId[8])
+{
+    EntryRecord r;
+
+    r.key = key;
+    memcpy(r.entryId, entryId, 8);
+    r.check = recordCheck(&r);
+    r.magic = ENTRY_MAGIC;
+
+    return fwrite(&r, sizeof(r), 1, f) == 1;
+}
+
+/* Replace the journal by one holding only the newest committed record of every RCB */
+static void checkpoint(EntryLog* l)
+{
+    char tmp[270];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", l->fileName);
+
+    FILE* f = fopen(tmp, "wb");
+    int ok = f != NULL;
+
+    Semaphore_wait(l->lock);
+
+    for (int i = 0; ok && i < l->capacity; i++)
+        if (l->slots[i].key != 0 && l->slots[i].hasCommitted)
+            ok = writeRecord(f, l->slots[i].key, l->slots[i].committed);
+
+    Semaphore_post(l->lock);
+
+    if (!ok) {
+        printf("Cannot write %s\n", tmp);
+        if (f) fclose(f);
+        return;
+    }
+
+    syncFile(f);
+    fclose(f);
+
+    if (l->file)
+        fclose(l->file);
+
+#ifdef _WIN32
+    int replaced = MoveFileExA(tmp, l->fileName, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    int replaced = rename(tmp, l->fileName) == 0;
+#endif
+
+    if (!replaced)
+        printf("Cannot replace %s\n", l->fileName);
+
+    l->file = fopen(l->fileName, "ab");
+    l->appends = 0;
+}
+
+EntryLog* entryLogOpen(const char* fileName)
+{
+    EntryLog* l = calloc(1, sizeof(EntryLog));
+    EntryRecord r;
+    int found = 0;
+
+    strncpy(l->fileName, fileName, sizeof(l->fileName) - 1);
+    l->lock = Semaphore_create(1);
+
+    FILE* f = fopen(fileName, "rb");
+    long size = 0;
+
+    if (f) {
+        while (fread(&r, sizeof(r), 1, f) == 1) {
+            if (r.magic != ENTRY_MAGIC || r.check != recordCheck(&r) || r.key == 0)
+                continue;
+
+            EntrySlot* slot = findSlot(l, r.key, 1);
+
+            memcpy(slot->entryId, r.entryId, 8);
+            memcpy(slot->committed, r.entryId, 8);
+            slot->hasCommitted = 1;
+            found++;
+        }
+
+        size = ftell(f);
+        fclose(f);
+    }
+
+    /* nothing usable in a journal that is not empty: start it again */
+    l->file = fopen(fileName, (found || size == 0) ? "ab" : "wb");
+
+    if (!l->file) {
+        printf("Cannot open %s\n", fileName);
+        Semaphore_destroy(l->lock);
+        free(l->slots);
+        free(l);
+        return NULL;
+    }
+
+    if (l->count > 0)
+        printf("EntryID journal %s: %d RCBs to resume\n", fileName, l->count);
+
+    /* a torn record at the end would offset every record after it */
+    if (found)
+        checkpoint(l);
+
+    return l;
+}
+
+int entryLogFind(EntryLog* l, uint64_t key, uint8_t entryId[8])
+{
+    Semaphore_wait(l->lock);
+
+    EntrySlot* slot = findSlot(l, key, 0);
+
+    if (slot)
+        memcpy(entryId, slot->entryId, 8);
+
+    Semaphore_post(l->lock);
+
+    return slot != NULL;
+}
+
+void entryLogSet(EntryLog* l, uint64_t key, const uint8_t entryId[8])
+{
+    Semaphore_wait(l->lock);
+
+    EntrySlot* slot = findSlot(l, key, 1);
+
+    memcpy(slot->entryId, entryId, 8);
+    slot->changed = 1;
+
+    Semaphore_post(l->lock);
+}
+
+int entryLogSnapshot(EntryLog* l)
+{
+    Semaphore_wait(l->lock);
+
+    l->stagedCount = 0;
+
+    for (int i = 0; i < l->capacity; i++) {
+        EntrySlot* slot = &l->slots[i];
+
+        if (slot->key == 0 || !slot->changed)
+            continue;
+
+        if (l->stagedCount == l->stagedCapacity) {
+            l->stagedCapacity = l->stagedCapacity ? 2 * l->stagedCapacity : 64;
+            l->staged = realloc(l->staged, l->stagedCapacity * sizeof(EntryRecord));
+        }
+
+        EntryRecord* r = &l->staged[l->stagedCount++];
+
+        r->key = slot->key;
+        memcpy(r->entryId, slot->entryId, 8);
+        slot->changed = 0;
+    }
+
+    Semaphore_post(l->lock);
+
+    return l->stagedCount;
+}
+
+void entryLogCommit(EntryLog* l)
+{
+    if (l->stagedCount == 0)
+        return;
+
+    int ok = l->file != NULL;
+
+    for (int i = 0; ok && i < l->stagedCount; i++)
+        ok = writeRecord(l->file, l->staged[i].key, l->staged[i].entryId);
+
+    if (!ok) {
+        printf("Cannot append to %s\n", l->fileName);
+        return;
+    }
+
+    syncFile(l->file);
+
+    Semaphore_wait(l->lock);
+
+    for (int i = 0; i < l->stagedCount; i++) {
+        EntrySlot* slot = findSlot(l, l->staged[i].key, 0);
+
+        memcpy(slot->committed, l->staged[i].entryId, 8);
+        slot->hasCommitted = 1;
+    }
+
+    Semaphore_post(l->lock);
+
+    l->appends += l->stagedCount;
+    l->stagedCount = 0;
+
+    if (l->appends >= ENTRY_LOG_CHECKPOINT)
+        checkpoint(l);
+}
+
+void entryLogClose(EntryLog* l)
+{
+    if (!l)
+        return;
+
+    if (l->file)
+        fclose(l->file);
+
+    Semaphore_destroy(l->lock);
+    free(l->slots);
+    free(l->staged);
+    free(l);
+}
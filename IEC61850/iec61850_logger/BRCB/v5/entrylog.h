@@ -0,0 +1,45 @@
+/*
+ * Last EntryID logged of every buffered RCB, kept on disk across restarts
+ *
+ * The journal of v4 for many RCBs in one file: an append-only journal of
+ * 24-byte records (RCB key, EntryID, check, magic). The report writer sets
+ * the EntryID of an RCB once the lines of its report are handed to the log
+ * sinks. Once a second the main loop takes a snapshot of the EntryIDs set
+ * since the last one, forces the sinks to disk and then commits the
+ * snapshot: one append, forced to disk, for all RCBs. On open the newest
+ * complete record of every RCB wins, so a record torn by a crash is simply
+ * ignored. Every ENTRY_LOG_CHECKPOINT records the journal is replaced by one
+ * holding only the newest committed record of every RCB (written aside,
+ * forced to disk, then renamed over the journal).
+ */
+
+#ifndef ENTRYLOG_H
+#define ENTRYLOG_H
+
+#include <stdint.h>
+
+/* Records appended before the journal is compacted */
+#define ENTRY_LOG_CHECKPOINT 4096
+
+typedef struct sEntryLog EntryLog;
+
+EntryLog* entryLogOpen(const char* fileName);
+
+/* Key of an RCB of an IED: ied "host:port", rcbRef "LD/LN.BR.RCB01" */
+uint64_t entryLogKey(const char* ied, const char* rcbRef);
+
+/* 1 and entryId set if an EntryID of the RCB was logged; the newest one, committed or not */
+int entryLogFind(EntryLog* l, uint64_t key, uint8_t entryId[8]);
+
+/* Report writer: the lines of the report with this EntryID are in the sinks */
+void entryLogSet(EntryLog* l, uint64_t key, const uint8_t entryId[8]);
+
+/* The EntryIDs set since the last snapshot, to be committed; returns how many */
+int entryLogSnapshot(EntryLog* l);
+
+/* Append the snapshot and force it to disk; call once the lines it covers are on disk */
+void entryLogCommit(EntryLog* l);
+
+void entryLogClose(EntryLog* l);
+
+#endif /* ENTRYLOG_H */
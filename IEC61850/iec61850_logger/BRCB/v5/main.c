@@ -0,0 +1,713 @@
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "iec61850_client.h"
+#include "hal_thread.h"
+#include "mms_value.h"
+
+#include "clock.h"
+#include "logsink.h"
+#include "mmsfmt.h"
+#include "reportqueue.h"
+#include "subscriber.h"
+
+#define SUBSCRIPTION_FILE "subscriptions.txt"
+
+/* Subscriber threads (--workers) */
+#define WORKERS 4
+
+/* Output files are rotated past this size (--rotate-mb) */
+#define ROTATE_MB 64
+
+/* Buffered output is written out at least this often */
+#define FLUSH_INTERVAL_MS 1000
+
+/* How often report rates are printed and the statistics file is rewritten */
+#define STATS_INTERVAL_MS 10000
+
+#define STATS_FILE "BRCB-STATS.txt"
+
+/* Last EntryID logged of every BRCB, see entrylog.h */
+#define ENTRY_LOG_FILE "BRCB-LOG.entryid"
+
+/* Latest value of every member, rewritten after a GI and at most this often otherwise */
+#define SNAPSHOT_FILE "BRCB-SNAPSHOT.csv"
+#define SNAPSHOT_INTERVAL_MS 60000
+
+#define LINE_SIZE 2048
+
+/* Opened once in main, written by the report writer */
+static LogSink* csvSink = NULL;
+static LogSink* jsonSink = NULL;
+
+/* --quiet: no per-entry console output */
+static int quiet = 0;
+
+/* --log-gi: GI and integrity entries go to the event log as well */
+static int logSnapshots = 0;
+
+static volatile int running = 1;
+
+static volatile int writerRunning = 1;
+
+/* written by the report writer only */
+static volatile long reportCount = 0;
+static volatile long entryCount = 0;
+static volatile long overflowCount = 0;
+static volatile long snapshotCount = 0;
+
+/* us; written by the report writer only, see metrics.h */
+static Histogram reportLatency;     /* receive time - the report's TimeOfEntry */
+static Histogram eventLatency;      /* receive time - the entry's own t */
+static Histogram queueDelay;        /* writer - receive time */
+static volatile long clockAhead = 0;    /* TimeOfEntry after our receive time: clocks apart */
+
+/* Ctrl-Break (Windows) or SIGUSR1: statistics file now */
+static volatile int dumpRequested = 0;
+
+static void sigintHandler(int signalId)
+{
+    (void) signalId;
+    running = 0;
+}
+
+static void dumpSignalHandler(int signalId)
+{
+    dumpRequested = 1;
+    signal(signalId, dumpSignalHandler);
+}
+
+
+/* ISO time with ms of a log record; the date and time text is cached per second by fmtTime */
+static void iso_utc_ms(int64_t ms, char *buf, size_t len)
+{
+    *fmtTime(buf, buf + len, ms, 1) = 0;
+}
+
+/* t of a data object entry (the UTC time element of its structure), 0 if it has none */
+static int64_t entrySourceMs(MmsValue *v)
+{
+    if (MmsValue_getType(v) == MMS_UTC_TIME)
+        return (int64_t) MmsValue_getUtcTimeInMs(v);
+
+    if (MmsValue_getType(v) != MMS_STRUCTURE)
+        return 0;
+
+    for (int i = (int) MmsValue_getArraySize(v) - 1; i >= 0; i--) {
+        MmsValue *e = MmsValue_getElement(v, i);
+
+        if (e && MmsValue_getType(e) == MMS_UTC_TIME)
+            return (int64_t) MmsValue_getUtcTimeInMs(e);
+    }
+
+    return 0;
+}
+
+/* ============================
+   Utility: print MMS value
+   ============================
+   Convert an MmsValue element into text; structures in one pass, see mmsfmt.h */
+static void mmsValueToString(MmsValue *v, char *out, int outLen)
+{
+    *fmtMmsValue(out, out + outLen, v) = 0;
+}
+
+/* ============================
+   Data set columns
+   ============================
+   Resolved by the worker when a subscription is first enabled, see subscriber.c */
+
+/* Text of every ReasonForInclusion bit combination, "dchg|qchg" */
+static char reasonText[64][48];
+
+static void buildReasonTexts(void)
+{
+    static const char* names[] = { "dchg", "qchg", "dupd", "integrity", "gi", "app" };
+
+    for (int bits = 0; bits < 64; bits++) {
+        char* end = reasonText[bits] + sizeof(reasonText[bits]);
+        char* p = reasonText[bits];
+
+        for (int k = 0; k < 6; k++) {
+            if (bits & (1 << k)) {
+                if (p != reasonText[bits])
+                    p = fmtText(p, end, "|");
+                p = fmtText(p, end, names[k]);
+            }
+        }
+
+        *p = 0;
+    }
+}
+
+/* The column of a data set index; entries the directory did not list are named by index */
+static const DataSetColumn* columnOf(const DataSetColumns* set, int index)
+{
+    static __thread DataSetColumn unnamed;
+
+    if (set && index < set->count)
+        return &set->columns[index];
+
+    char name[16];
+    char* end = name + sizeof(name);
+    char* p = fmtText(name, end, "[");
+    p = fmtInt64(p, end, index);
+    *fmtText(p, end, "]") = 0;
+
+    setDataSetColumn(&unnamed, name);
+    return &unnamed;
+}
+
+/* ============================
+   Snapshot channel
+   ============================
+   Entries sent only because of a GI or an integrity period restate values
+   the log already has. They update the latest value of their member, which
+   is checkpointed to SNAPSHOT_FILE; only data changes (dchg, qchg, dupd,
+   app) go to the event log */
+
+#define EVENT_REASONS (IEC61850_REASON_DATA_CHANGE | IEC61850_REASON_QUALITY_CHANGE | \
+                       IEC61850_REASON_DATA_UPDATE | IEC61850_REASON_UNKNOWN)
+
+/* written by the report writer only */
+static int snapshotDirty = 0;
+static int snapshotAfterGi = 0;
+static int64_t snapshotWrittenMs = 0;
+
+static int isSnapshotEntry(int reasons)
+{
+    return (reasons & (IEC61850_REASON_GI | IEC61850_REASON_INTEGRITY)) != 0 && (reasons & EVENT_REASONS) == 0;
+}
+
+static void updateLatest(Subscription* s, const DataSetColumns* columns, int index,
+                         const char* value, const char* source, const char* time, int reasons)
+{
+    /* a reconnect took an instance with another data set: the old members are not its members */
+    if (columns != s->latestColumns) {
+        free(s->latest);
+        s->latest = NULL;
+        s->latestCount = 0;
+        s->latestColumns = columns;
+    }
+
+    if (index >= s->latestCount) {
+        int columnCount = columns ? columns->count : 0;
+        int n = index < columnCount ? columnCount : index + 1;
+
+        s->latest = realloc(s->latest, n * sizeof(LatestValue));
+        memset(s->latest + s->latestCount, 0, (n - s->latestCount) * sizeof(LatestValue));
+        s->latestCount = n;
+    }
+
+    LatestValue* l = &s->latest[index];
+
+    *fmtText(l->value, l->value + sizeof(l->value), value) = 0;
+    *fmtText(l->source, l->source + sizeof(l->source), source) = 0;
+    *fmtText(l->time, l->time + sizeof(l->time), time) = 0;
+    l->reasons = (uint8_t) reasons;
+    l->known = 1;
+
+    snapshotDirty = 1;
+    if (reasons & IEC61850_REASON_GI)
+        snapshotAfterGi = 1;
+}
+
+/* One line per member of every subscription, written aside and renamed over the last checkpoint */
+static void writeSnapshot(void)
+{
+    const char* tmp = SNAPSHOT_FILE ".tmp";
+    FILE* f = fopen(tmp, "w");
+
+    if (!f) {
+        printf("Cannot write %s\n", tmp);
+        return;
+    }
+
+    fprintf(f, "ied,tag,value,sourceTime,time,reason\n");
+
+    for (int k = 0; k < subscriptionCount; k++) {
+        Subscription* s = &subscriptions[k];
+
+        for (int i = 0; i < s->latestCount; i++) {
+            LatestValue* l = &s->latest[i];
+
+            if (l->known)
+                fprintf(f, "%s,%s,%s,%s,%s,%s\n", s->ied->name, columnOf(s->latestColumns, i)->csvKey,
+                        l->value, l->source, l->time, reasonText[l->reasons & 63]);
+        }
+    }
+
+    fclose(f);
+
+#ifdef _WIN32
+    if (!MoveFileExA(tmp, SNAPSHOT_FILE, MOVEFILE_REPLACE_EXISTING))
+#else
+    if (rename(tmp, SNAPSHOT_FILE) != 0)
+#endif
+        printf("Cannot replace %s\n", SNAPSHOT_FILE);
+
+    snapshotDirty = 0;
+    snapshotAfterGi = 0;
+    snapshotWrittenMs = clockWallMs();
+}
+
+/* Called when the queues are empty, so a GI is checkpointed once it is complete */
+static void checkpointSnapshot(void)
+{
+    if (snapshotDirty && (snapshotAfterGi || clockWallMs() - snapshotWrittenMs >= SNAPSHOT_INTERVAL_MS))
+        writeSnapshot();
+}
+
+/* ============================
+   Report continuity
+   ============================
+   SqNum is INT8U for URCBs, INT16U for BRCBs (some IEDs count URCBs to
+   16 bits as well); segments of one report share the SqNum */
+
+static void checkSequence(Subscription* s, ReportRecord* r)
+{
+    SubscriptionStats* st = &s->stats;
+
+    /* re-enabled: a new sequence */
+    if (r->generation != st->generation) {
+        st->generation = r->generation;
+        st->haveSeqNum = 0;
+        st->haveEntryId = 0;
+    }
+
+    if (r->hasSeqNum) {
+        uint32_t modulo = (!s->buffered && r->seqNum < 256 && st->lastSeqNum < 256) ? 256 : 65536;
+
+        if (!st->haveSeqNum)
+            ;
+        else if (r->seqNum == st->lastSeqNum) {
+            if (r->subSeqNum == 0)
+                st->duplicates++;
+        }
+        else {
+            uint32_t gap = (r->seqNum - st->lastSeqNum - 1 + modulo) % modulo;
+
+            if (gap < modulo / 2)
+                st->missed += gap;
+            else
+                st->backwards++;
+        }
+
+        st->lastSeqNum = r->seqNum;
+        st->haveSeqNum = 1;
+    }
+
+    if (r->hasEntryId && r->subSeqNum == 0) {
+        if (st->haveEntryId && memcmp(st->lastEntryId, r->entryId, 8) == 0)
+            st->entryIdRepeats++;
+
+        memcpy(st->lastEntryId, r->entryId, 8);
+        st->haveEntryId = 1;
+    }
+
+    if (r->bufOvfl)
+        st->overflows++;
+
+    if (r->timeOfEntryMs) {
+        int64_t latencyUs = r->receiveUs - r->timeOfEntryMs * 1000;
+
+        if (latencyUs < 0)
+            clockAhead++;
+
+        histogramRecord(&reportLatency, latencyUs);
+
+        if (latencyUs > st->latencyMaxUs)
+            st->latencyMaxUs = latencyUs;
+    }
+
+    st->reports++;
+    st->entries += r->entryCount;
+}
+
+/* ============================
+   Report writer thread
+   ============================
+   Decodes and formats the reports queued by all workers, off their threads */
+
+static void writeReport(ReportRecord* r)
+{
+    Subscription* s = &subscriptions[r->subscription];
+
+    histogramRecord(&queueDelay, clockWallUs() - r->receiveUs);
+    checkSequence(s, r);
+
+    /* local receive time; entries without their own t get the report's TimeOfEntry */
+    char now[32];
+    iso_utc_ms(r->receiveUs / 1000, now, sizeof(now));
+
+    if (!quiet)
+        printf("Report %s %s received %s (%d entries):\n", s->ied->name, r->rptId, now, r->entryCount);
+
+    int pos = 0;
+
+    for (int i = 0; i < r->entryCount; i++) {
+        /* the values were encoded back to back; bufferLength is counted from pos */
+        MmsValue* val = MmsValue_decodeMmsData(r->payload, pos, r->payloadLength - pos, &pos);
+
+        if (val == NULL) {
+            printf("Report %s %s: undecodable entry %d\n", s->ied->name, r->rptId, r->entries[i]);
+            break;
+        }
+
+        const DataSetColumn* column = columnOf(r->columns, r->entries[i]);
+        const char* reason = reasonText[r->reasons[i] & 63];
+        int snapshot = isSnapshotEntry(r->reasons[i]);
+
+        char valbuf[1024];
+        mmsValueToString(val, valbuf, sizeof(valbuf));
+
+        char source[32] = "";
+        int64_t sourceMs = entrySourceMs(val);
+
+        if (sourceMs != 0)
+            histogramRecord(&eventLatency, r->receiveUs - sourceMs * 1000);
+        else
+            sourceMs = r->timeOfEntryMs;
+        if (sourceMs != 0)
+            iso_utc_ms(sourceMs, source, sizeof(source));
+
+        MmsValue_delete(val);
+
+        updateLatest(s, r->columns, r->entries[i], valbuf, source, now, r->reasons[i]);
+
+        if (snapshot) {
+            snapshotCount++;
+
+            if (!logSnapshots)
+                continue;
+        }
+
+        if (!quiet)
+            printf("  %s = %s  (%s, t %s)\n", column->csvKey, valbuf, reason, source);
+
+        /* the lines are pieced together, no format string is parsed per entry */
+        char line[LINE_SIZE];
+        char* end = line + sizeof(line);
+        char* p = fmtText(line, end, now);
+        p = fmtText(p, end, ",");
+        p = fmtText(p, end, s->ied->name);
+        p = fmtText(p, end, ",");
+        p = fmtText(p, end, column->csvKey);
+        p = fmtText(p, end, ",");
+        p = fmtText(p, end, reason);
+        p = fmtText(p, end, ",");
+        p = fmtText(p, end, valbuf);
+        p = fmtText(p, end, ",");
+        p = fmtText(p, end, source);
+        p = fmtText(p, end, "\n");
+        logSinkWrite(csvSink, line, (int) (p - line));
+
+        p = fmtText(line, end, "{\"time\":\"");
+        p = fmtText(p, end, now);
+        p = fmtText(p, end, "\",\"ied\":\"");
+        p = fmtText(p, end, s->ied->name);
+        p = fmtText(p, end, column->jsonKey);
+        p = fmtText(p, end, "\",\"reason\":\"");
+        p = fmtText(p, end, reason);
+        p = fmtText(p, end, "\",\"value\":\"");
+        p = fmtText(p, end, valbuf);
+        p = fmtText(p, end, "\",\"t\":\"");
+        p = fmtText(p, end, source);
+        p = fmtText(p, end, "\"}\n");
+        logSinkWrite(jsonSink, line, (int) (p - line));
+    }
+
+    if (!quiet)
+        printf("----\n");
+
+    /* committed by the main loop once the lines above are on disk */
+    if (r->entryKey && r->hasEntryId)
+        entryLogSet(entryLog, r->entryKey, r->entryId);
+
+    entryCount += r->entryCount;
+    reportCount++;
+
+    if (r->bufOvfl) {
+        printf("Report %s %s: IED buffer overflowed, events lost\n", s->ied->name, r->rptId);
+        overflowCount++;
+        s->giRequested = 1;
+    }
+}
+
+static void*
+reportWriter(void* parameter)
+{
+    (void) parameter;
+
+    while (1) {
+        int written = 0;
+
+        /* a batch from every worker in turn, none starves the others */
+        for (int w = 0; w < workerCount; w++) {
+            ReportRecord* r;
+
+            for (int n = 0; n < 64 && (r = reportQueuePeek(workers[w].queue)) != NULL; n++) {
+                writeReport(r);
+                reportQueueRelease(workers[w].queue);
+                written++;
+            }
+        }
+
+        if (written)
+            continue;
+
+        checkpointSnapshot();
+
+        if (writerRunning)
+            Thread_sleep(1);
+        else
+            break;
+    }
+
+    if (snapshotDirty)
+        writeSnapshot();
+
+    return NULL;
+}
+
+/* ============================
+   Statistics
+   ============================ */
+
+static int64_t startMs = 0;
+
+static long droppedReports(void)
+{
+    long dropped = 0;
+
+    for (int w = 0; w < workerCount; w++)
+        dropped += workers[w].droppedReports;
+
+    return dropped;
+}
+
+/* Handler times of all workers */
+static const Histogram* callbackTimes(void)
+{
+    static Histogram sum;
+
+    memset(&sum, 0, sizeof(sum));
+
+    for (int w = 0; w < workerCount; w++)
+        histogramAdd(&sum, &workers[w].callbackUs);
+
+    return &sum;
+}
+
+static void printStats(int intervalMs)
+{
+    static long lastReports = 0, lastEntries = 0;
+
+    long reports = reportCount;
+    long entries = entryCount;
+    const Histogram* callbackUs = callbackTimes();
+    int iedsUp, active;
+
+    subscriberCounts(&iedsUp, &active);
+
+    printf("IEDs: %d/%d connected, subscriptions: %d/%d active\n", iedsUp, iedCount, active, subscriptionCount);
+    printf("Reports: %ld (%.0f/s), %ld entries (%.0f/s, %ld GI/integrity to the snapshot), %ld dropped, %ld overflows, %lld bytes logged\n",
+           reports, (reports - lastReports) * 1000.0 / intervalMs,
+           entries, (entries - lastEntries) * 1000.0 / intervalMs, (long) snapshotCount, droppedReports(),
+           (long) overflowCount, logSinkBytesWritten(csvSink) + logSinkBytesWritten(jsonSink));
+
+    if (callbackUs->count > 0)
+        printf("Report handler: %.1f us mean, %lld us p99, %lld us max on the workers\n",
+               (double) callbackUs->total / callbackUs->count,
+               (long long) histogramPercentile(callbackUs, 99), (long long) callbackUs->max);
+
+    if (reportLatency.count > 0)
+        printf("Report latency: %lld us p50, %lld us p99, %lld us max\n",
+               (long long) histogramPercentile(&reportLatency, 50),
+               (long long) histogramPercentile(&reportLatency, 99), (long long) reportLatency.max);
+
+    lastReports = reports;
+    lastEntries = entries;
+}
+
+/* Everything since start to STATS_FILE, rewritten each time */
+static void dumpStats(void)
+{
+    FILE* f = fopen(STATS_FILE, "w");
+
+    if (!f) {
+        printf("Cannot write %s\n", STATS_FILE);
+        return;
+    }
+
+    char now[32];
+    iso_utc_ms(clockWallMs(), now, sizeof(now));
+
+    double seconds = (clockWallMs() - startMs) / 1000.0;
+    if (seconds <= 0) seconds = 1;
+
+    fprintf(f, "BRCB logger statistics %s, %.0f s since start\n\n", now, seconds);
+    fprintf(f, "reports %ld (%.1f/s), entries %ld (%.1f/s), snapshot entries %ld, dropped %ld, overflows %ld, clock ahead %ld\n\n",
+            (long) reportCount, reportCount / seconds, (long) entryCount, entryCount / seconds,
+            (long) snapshotCount, droppedReports(), (long) overflowCount, (long) clockAhead);
+
+    fprintf(f, "%-16s %10s %10s %10s %10s %10s %10s %10s  (us)\n",
+            "", "count", "p50", "p90", "p99", "p99.9", "max", "mean");
+    histogramPrintSummary(f, "report latency", &reportLatency);
+    histogramPrintSummary(f, "event latency", &eventLatency);
+    histogramPrintSummary(f, "queue delay", &queueDelay);
+    histogramPrintSummary(f, "handler time", callbackTimes());
+
+    fprintf(f, "\nied,rcb,reports,entries,missed,duplicates,backwards,entryIdRepeats,overflows,latencyMaxUs\n");
+
+    for (int i = 0; i < subscriptionCount; i++) {
+        Subscription* s = &subscriptions[i];
+        SubscriptionStats* st = &s->stats;
+
+        fprintf(f, "%s,%s,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%lld\n",
+                s->ied->name, s->rcbRef[0] ? s->rcbRef : s->base, st->reports, st->entries,
+                st->missed, st->duplicates, st->backwards, st->entryIdRepeats, st->overflows,
+                (long long) st->latencyMaxUs);
+    }
+
+    /* the buckets, for plotting or merging runs: upper bound us:count */
+    fprintf(f, "\n");
+    histogramPrintBuckets(f, "report latency", &reportLatency);
+    histogramPrintBuckets(f, "event latency", &eventLatency);
+    histogramPrintBuckets(f, "queue delay", &queueDelay);
+    histogramPrintBuckets(f, "handler time", callbackTimes());
+
+    fclose(f);
+}
+
+/* ============================
+   Main
+   ============================ */
+
+/* Lines to disk first, then the EntryIDs of the reports among them */
+static void flushAndCheckpoint(void)
+{
+    if (entryLog && entryLogSnapshot(entryLog) > 0) {
+        /* forced to disk like the journal: a checkpoint must never get ahead of the lines */
+        logSinkSync(csvSink);
+        logSinkSync(jsonSink);
+
+        entryLogCommit(entryLog);
+    }
+    else {
+        logSinkFlush(csvSink);
+        logSinkFlush(jsonSink);
+    }
+}
+
+int
+main(int argc, char** argv)
+{
+    const char* subscriptionFile = SUBSCRIPTION_FILE;
+    int workerThreads = WORKERS;
+    int rotateMb = ROTATE_MB;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--subscriptions") == 0 && i + 1 < argc)
+            subscriptionFile = argv[++i];
+        else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc)
+            workerThreads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rotate-mb") == 0 && i + 1 < argc)
+            rotateMb = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--quiet") == 0)
+            quiet = 1;
+        else if (strcmp(argv[i], "--log-gi") == 0)
+            logSnapshots = 1;
+        else {
+            printf("Usage: %s [--subscriptions file] [--workers n] [--rotate-mb n] [--log-gi] [--quiet]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (subscriberLoad(subscriptionFile) == 0)
+        return 1;
+
+    clockInit();
+    buildReasonTexts();
+
+    startMs = clockWallMs();
+
+    /* kept open for the whole run, see logsink.h */
+    csvSink = logSinkOpen("BRCB-LOG", "csv", "time,ied,tag,reason,value,sourceTime\n", (long long) rotateMb << 20);
+    jsonSink = logSinkOpen("BRCB-LOG", "json", NULL, (long long) rotateMb << 20);
+
+    if (!csvSink || !jsonSink)
+        return -1;
+
+    /* without it every enable is followed by a GI */
+    entryLog = entryLogOpen(ENTRY_LOG_FILE);
+
+    /* ---- Workers connect and subscribe, the writer logs what they queue ---- */
+    subscriberStart(workerThreads);
+
+    Thread writer = Thread_create(reportWriter, NULL, false);
+    Thread_start(writer);
+
+    signal(SIGINT, sigintHandler);
+
+#ifdef _WIN32
+    signal(SIGBREAK, dumpSignalHandler);
+#else
+    signal(SIGUSR1, dumpSignalHandler);
+#endif
+
+    printf("Waiting for reports (Ctrl-C to stop)...\n");
+
+    /* ---- write the buffered lines out, print the rates ---- */
+    int sinceStats = 0;
+
+    while (running) {
+        Sleep(FLUSH_INTERVAL_MS);
+
+        flushAndCheckpoint();
+
+        sinceStats += FLUSH_INTERVAL_MS;
+
+        if (sinceStats >= STATS_INTERVAL_MS) {
+            printStats(sinceStats);
+            dumpStats();
+            sinceStats = 0;
+        }
+        else if (dumpRequested) {
+            dumpStats();
+            printf("Statistics written to %s\n", STATS_FILE);
+        }
+
+        dumpRequested = 0;
+    }
+
+    /* ---- Cleanup ---- */
+    subscriberStop();
+
+    /* the writer empties the queues before it ends */
+    writerRunning = 0;
+    Thread_destroy(writer);
+
+    flushAndCheckpoint();
+    entryLogClose(entryLog);
+
+    dumpStats();
+
+    for (int w = 0; w < workerCount; w++)
+        reportQueueDestroy(workers[w].queue);
+
+    logSinkClose(csvSink);
+    logSinkClose(jsonSink);
+
+    return 0;
+}
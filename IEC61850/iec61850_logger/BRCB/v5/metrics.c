@@ -0,0 +1,100 @@
+#include <string.h>
+
+#include "metrics.h"
+
+#define SUB (1 << HISTOGRAM_SUB_BITS)
+
+static int bucketOf(uint64_t v)
+{
+    if (v < 2 * SUB)
+        return (int) v;
+
+    int shift = 63 - __builtin_clzll(v) - HISTOGRAM_SUB_BITS;
+
+    /* top bits in [SUB, 2 SUB) */
+    return (shift << HISTOGRAM_SUB_BITS) + (int) (v >> shift);
+}
+
+static int64_t bucketUpper(int i)
+{
+    if (i < 2 * SUB)
+        return i;
+
+    int shift = (i >> HISTOGRAM_SUB_BITS) - 1;
+    uint64_t top = (uint64_t) (i - (shift << HISTOGRAM_SUB_BITS));
+
+    /* unsigned: the last bucket ends at 2^63 - 1 */
+    return (int64_t) (((top + 1) << shift) - 1);
+}
+
+void histogramRecord(Histogram* h, int64_t value)
+{
+    if (value < 0)
+        value = 0;
+
+    h->counts[bucketOf((uint64_t) value)]++;
+    h->count++;
+    h->total += value;
+
+    if (value > h->max)
+        h->max = value;
+}
+
+void histogramAdd(Histogram* h, const Histogram* other)
+{
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+        h->counts[i] += other->counts[i];
+
+    h->count += other->count;
+    h->total += other->total;
+
+    if (other->max > h->max)
+        h->max = other->max;
+}
+
+int64_t histogramPercentile(const Histogram* h, double percent)
+{
+    uint64_t count = h->count;
+
+    if (count == 0)
+        return 0;
+
+    uint64_t rank = (uint64_t) (percent / 100.0 * count + 0.5);
+    if (rank < 1) rank = 1;
+
+    uint64_t seen = 0;
+
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += h->counts[i];
+
+        if (seen >= rank) {
+            int64_t upper = bucketUpper(i);
+            return upper < h->max ? upper : h->max;
+        }
+    }
+
+    return h->max;
+}
+
+void histogramPrintSummary(FILE* f, const char* name, const Histogram* h)
+{
+    fprintf(f, "%-16s %10llu %10lld %10lld %10lld %10lld %10lld %10.0f\n", name,
+            (unsigned long long) h->count,
+            (long long) histogramPercentile(h, 50),
+            (long long) histogramPercentile(h, 90),
+            (long long) histogramPercentile(h, 99),
+            (long long) histogramPercentile(h, 99.9),
+            (long long) h->max,
+            h->count ? (double) h->total / h->count : 0.0);
+}
+
+void histogramPrintBuckets(FILE* f, const char* name, const Histogram* h)
+{
+    fprintf(f, "%s:", name);
+
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+        if (h->counts[i])
+            fprintf(f, " %lld:%llu", (long long) bucketUpper(i), (unsigned long long) h->counts[i]);
+
+    fprintf(f, "\n");
+}
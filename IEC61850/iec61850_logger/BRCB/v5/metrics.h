@@ -0,0 +1,42 @@
+/*
+ * Latency histograms of the report pipeline, HDR style
+ *
+ * Values (microseconds) below 64 have a bucket each; above, every power of
+ * two is split into 32 buckets, so any value up to 2^62 is kept to within
+ * about 3% in a fixed 15 KB table. Recording is an index computation and an
+ * increment; each histogram has one writing thread, readers accept a
+ * slightly torn view. Counts are since start.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define HISTOGRAM_SUB_BITS 5
+#define HISTOGRAM_BUCKETS ((62 - HISTOGRAM_SUB_BITS + 2) << HISTOGRAM_SUB_BITS)
+
+typedef struct {
+    uint64_t counts[HISTOGRAM_BUCKETS];
+    uint64_t count;
+    int64_t total;
+    int64_t max;
+} Histogram;
+
+/* Negative values are recorded as 0 */
+void histogramRecord(Histogram* h, int64_t value);
+
+/* h += other */
+void histogramAdd(Histogram* h, const Histogram* other);
+
+/* Highest value of the bucket holding the given percentile, 0 if empty */
+int64_t histogramPercentile(const Histogram* h, double percent);
+
+/* "name  count  p50  p90  p99  p99.9  max  mean" */
+void histogramPrintSummary(FILE* f, const char* name, const Histogram* h);
+
+/* The non-empty buckets as "upper:count" */
+void histogramPrintBuckets(FILE* f, const char* name, const Histogram* h);
+
+#endif /* METRICS_H */
@@ -0,0 +1,887 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mms_value.h"
+
+#include "clock.h"
+#include "fmt.h"
+#include "subscriber.h"
+
+#define LINE_SIZE 512
+
+enum { IED_DOWN, IED_CONNECTING, IED_UP };
+
+enum {
+    SUB_IDLE,           /* IED not connected */
+    SUB_READING,        /* RCB values of an instance requested */
+    SUB_RESERVING,      /* Resv / ResvTms written */
+    SUB_DIRECTORY,      /* data set directory requested */
+    SUB_CONFIGURING,    /* TrgOps and OptFlds written */
+    SUB_RESUMING,       /* EntryID written */
+    SUB_ENABLING,       /* RptEna written */
+    SUB_ACTIVE,
+    SUB_WAITING         /* no free instance, tried again at retryMs */
+};
+
+Ied* ieds = NULL;
+int iedCount = 0;
+
+Subscription* subscriptions = NULL;
+int subscriptionCount = 0;
+
+Worker workers[MAX_WORKERS];
+int workerCount = 0;
+
+EntryLog* entryLog = NULL;
+
+static volatile int workersRunning = 1;
+
+void setDataSetColumn(DataSetColumn* c, const char* tag)
+{
+    char* end = c->csvKey + sizeof(c->csvKey);
+    *fmtText(c->csvKey, end, tag) = 0;
+
+    end = c->jsonKey + sizeof(c->jsonKey);
+    char* p = fmtText(c->jsonKey, end, "\",\"tag\":\"");
+    *fmtText(p, end, tag) = 0;
+}
+
+/* ===================== Configuration ===================== */
+
+static char* trim(char* s)
+{
+    while (isspace((unsigned char) *s)) s++;
+
+    char* e = s + strlen(s);
+    while (e > s && isspace((unsigned char) e[-1])) *--e = 0;
+
+    return s;
+}
+
+static int findOrAddIed(const char* address, int* capacity)
+{
+    char name[80];
+    strncpy(name, address, sizeof(name) - 1);
+    name[sizeof(name) - 1] = 0;
+
+    if (!strchr(name, ':'))
+        strncat(name, ":102", sizeof(name) - strlen(name) - 1);
+
+    for (int i = 0; i < iedCount; i++)
+        if (strcmp(ieds[i].name, name) == 0)
+            return i;
+
+    if (iedCount == *capacity) {
+        *capacity = *capacity ? *capacity * 2 : 64;
+        ieds = realloc(ieds, *capacity * sizeof(Ied));
+    }
+
+    Ied* ied = &ieds[iedCount];
+    memset(ied, 0, sizeof(*ied));
+
+    strcpy(ied->name, name);
+    strncpy(ied->host, name, sizeof(ied->host) - 1);
+    *strchr(ied->host, ':') = 0;
+    ied->port = atoi(strchr(name, ':') + 1);
+
+    return iedCount++;
+}
+
+/* "...EventsIndexed01..03": base "...EventsIndexed", instances 1 to 3 written with two digits */
+static int parseRange(Subscription* s, const char* ref)
+{
+    const char* dots = strstr(ref, "..");
+
+    if (!dots) {
+        if (strlen(ref) >= sizeof(s->base)) return 0;
+        strcpy(s->base, ref);
+        s->first = s->last = -1;
+        return 1;
+    }
+
+    const char* digits = dots;
+    while (digits > ref && isdigit((unsigned char) digits[-1])) digits--;
+
+    if (digits == dots || !isdigit((unsigned char) dots[2]) || digits - ref >= (int) sizeof(s->base))
+        return 0;
+
+    memcpy(s->base, ref, digits - ref);
+    s->base[digits - ref] = 0;
+    s->width = (int) (dots - digits);
+    s->first = atoi(digits);
+    s->last = atoi(dots + 2);
+
+    return s->first <= s->last;
+}
+
+int subscriberLoad(const char* fileName)
+{
+    FILE* f = fopen(fileName, "r");
+    if (!f) {
+        printf("Cannot open %s\n", fileName);
+        return 0;
+    }
+
+    int iedCapacity = 0, capacity = 0;
+    int* iedOf = NULL;
+    char line[LINE_SIZE];
+
+    while (fgets(line, sizeof(line), f)) {
+        char* p = strchr(line, '\n');
+        if (p) *p = 0;
+
+        char* address = trim(line);
+        if (address[0] == 0 || address[0] == '#') continue;
+
+        char* comma = strchr(address, ',');
+        if (!comma) {
+            printf("Expected host[:port], RCB: %s\n", address);
+            continue;
+        }
+
+        *comma = 0;
+        address = trim(address);
+        char* ref = trim(comma + 1);
+
+        if (subscriptionCount == capacity) {
+            capacity = capacity ? capacity * 2 : 256;
+            subscriptions = realloc(subscriptions, capacity * sizeof(Subscription));
+            iedOf = realloc(iedOf, capacity * sizeof(int));
+        }
+
+        Subscription* s = &subscriptions[subscriptionCount];
+        memset(s, 0, sizeof(*s));
+
+        if (!strchr(ref, '/') || !parseRange(s, ref)) {
+            printf("Invalid RCB reference: %s\n", ref);
+            continue;
+        }
+
+        s->held = -1;
+        iedOf[subscriptionCount++] = findOrAddIed(address, &iedCapacity);
+    }
+
+    fclose(f);
+
+    /* both tables are final now, link them */
+    for (int i = subscriptionCount - 1; i >= 0; i--) {
+        Subscription* s = &subscriptions[i];
+
+        s->ied = &ieds[iedOf[i]];
+        s->nextOfIed = s->ied->subs;
+        s->ied->subs = s;
+    }
+
+    free(iedOf);
+
+    printf("Loaded %d subscriptions on %d IEDs\n", subscriptionCount, iedCount);
+
+    return subscriptionCount;
+}
+
+/* ===================== Report Callback ===================== */
+
+/* Runs on the worker ticking the connection: copy the report into its queue and return */
+static void
+reportCallback(void* parameter, ClientReport report)
+{
+    Subscription* s = parameter;
+    Worker* w = &workers[s->ied->worker];
+
+    int64_t startUs = clockWallUs();
+
+    MmsValue* values = ClientReport_getDataSetValues(report);
+
+    if (values == NULL || MmsValue_getType(values) != MMS_ARRAY)
+        return;
+
+    ReportRecord* r = reportQueueReserve(w->queue);
+
+    if (r == NULL) {
+        w->droppedReports++;
+        return;
+    }
+
+    r->receiveUs = startUs;
+    r->subscription = (int) (s - subscriptions);
+    r->generation = s->generation;
+    r->columns = s->columns;
+    r->entryKey = s->entryKey;
+
+    const char* reportRptId = ClientReport_getRptId(report);
+    strncpy(r->rptId, reportRptId ? reportRptId : "", sizeof(r->rptId) - 1);
+    r->rptId[sizeof(r->rptId) - 1] = 0;
+
+    r->hasSeqNum = ClientReport_hasSeqNum(report);
+    r->seqNum = r->hasSeqNum ? (uint32_t) ClientReport_getSeqNum(report) : 0;
+    r->subSeqNum = ClientReport_hasSubSeqNum(report) ? (uint32_t) ClientReport_getSubSeqNum(report) : 0;
+
+    MmsValue* entryId = ClientReport_getEntryId(report);
+    r->hasEntryId = entryId != NULL && MmsValue_getOctetStringSize(entryId) == 8;
+    if (r->hasEntryId)
+        memcpy(r->entryId, MmsValue_getOctetStringBuffer(entryId), 8);
+
+    r->timeOfEntryMs = ClientReport_hasTimestamp(report) ? (int64_t) ClientReport_getTimestamp(report) : 0;
+    r->bufOvfl = ClientReport_hasBufOvfl(report) && ClientReport_getBufOvfl(report);
+
+    /* only the entries this report includes; the others hold older values, or none yet */
+    int hasReasons = ClientReport_hasReasonForInclusion(report);
+    int size = MmsValue_getArraySize(values);
+    int pos = 0;
+
+    r->entryCount = 0;
+
+    for (int i = 0; i < size && r->entryCount < REPORT_MAX_ENTRIES; i++) {
+        ReasonForInclusion reason = hasReasons ? ClientReport_getReasonForInclusion(report, i) : IEC61850_REASON_NOT_INCLUDED;
+        MmsValue* value = MmsValue_getElement(values, i);
+
+        if (value == NULL || (hasReasons && reason == IEC61850_REASON_NOT_INCLUDED))
+            continue;
+
+        if (pos + MmsValue_encodeMmsData(value, NULL, 0, false) > REPORT_PAYLOAD_SIZE) {
+            w->droppedReports++;
+            return;
+        }
+
+        pos = MmsValue_encodeMmsData(value, r->payload, pos, true);
+
+        r->entries[r->entryCount] = (uint16_t) i;
+        r->reasons[r->entryCount] = (uint8_t) reason;
+        r->entryCount++;
+    }
+
+    r->payloadLength = pos;
+
+    reportQueuePublish(w->queue);
+
+    histogramRecord(&w->callbackUs, clockWallUs() - startUs);
+}
+
+/* ===================== Subscription States ===================== */
+
+/*
+ * Every step sends one request and returns; its handler, called from the
+ * worker's tick, sends the next. A handler whose invoke ID is not the one the
+ * subscription waits for (a request of a lost association) is ignored.
+ */
+
+static void readInstance(Subscription* s);
+
+static int instanceCount(Subscription* s)
+{
+    return s->first < 0 ? 1 : s->last - s->first + 1;
+}
+
+/* Another subscription of ours holds or is trying this instance */
+static int claimedByUs(Subscription* s, int instance)
+{
+    for (Subscription* o = s->ied->subs; o; o = o->nextOfIed)
+        if (o != s && o->state != SUB_IDLE && o->state != SUB_WAITING &&
+            o->instance == instance && strcmp(o->base, s->base) == 0)
+            return 1;
+
+    return 0;
+}
+
+static void releaseRcb(Subscription* s)
+{
+    if (s->rcb) {
+        ClientReportControlBlock_destroy(s->rcb);
+        s->rcb = NULL;
+    }
+}
+
+/* The next instance of the range, or wait when all were tried */
+static void nextInstance(Subscription* s)
+{
+    releaseRcb(s);
+
+    while (++s->tried < instanceCount(s)) {
+        if (s->first >= 0 && ++s->instance > s->last)
+            s->instance = s->first;
+
+        if (!claimedByUs(s, s->instance)) {
+            readInstance(s);
+            return;
+        }
+    }
+
+    printf("%s %s%s: no free instance, retry in %d s\n", s->ied->name, s->base,
+           s->first < 0 ? "" : "..", INSTANCE_RETRY_MS / 1000);
+
+    s->state = SUB_WAITING;
+    s->retryMs = clockWallMs() + INSTANCE_RETRY_MS;
+}
+
+/* After a restart: the first instance of the range we logged an EntryID of, unless another subscription has it */
+static int journalledInstance(Subscription* s)
+{
+    char ref[130];
+    uint8_t entryId[8];
+
+    if (!entryLog || s->first < 0)
+        return -1;
+
+    for (int i = s->first; i <= s->last; i++) {
+        int taken = claimedByUs(s, i);
+
+        for (Subscription* o = s->ied->subs; o && !taken; o = o->nextOfIed)
+            taken = o != s && o->held == i && strcmp(o->base, s->base) == 0;
+
+        snprintf(ref, sizeof(ref), "%s%0*d", s->base, s->width, i);
+
+        if (!taken && entryLogFind(entryLog, entryLogKey(s->ied->name, ref), entryId))
+            return i;
+    }
+
+    return -1;
+}
+
+static void startSubscription(Subscription* s)
+{
+    /* ResvTms may still hold it for us, see instanceFree */
+    if (s->held < 0)
+        s->held = journalledInstance(s);
+
+    s->tried = 0;
+    s->instance = s->held >= 0 ? s->held : s->first;
+
+    if (claimedByUs(s, s->instance)) {
+        s->tried = -1;
+        s->state = SUB_READING;
+        nextInstance(s);
+        return;
+    }
+
+    readInstance(s);
+}
+
+static void onGi(uint32_t invokeId, void* parameter, IedClientError err)
+{
+    Subscription* s = parameter;
+
+    if (err != IED_ERROR_OK && s->state == SUB_ACTIVE)
+        printf("%s %s: GI failed: %d\n", s->ied->name, s->rcbRef, err);
+}
+
+static void onEnabled(uint32_t invokeId, void* parameter, IedClientError err)
+{
+    Subscription* s = parameter;
+
+    if (invokeId != s->pending || s->state != SUB_ENABLING)
+        return;
+
+    if (err != IED_ERROR_OK) {
+        printf("%s %s: enable failed: %d\n", s->ied->name, s->rcbRef, err);
+        IedConnection_uninstallReportHandler(s->ied->con, s->rcbRef);
+        nextInstance(s);
+        return;
+    }
+
+    s->state = SUB_ACTIVE;
+    s->held = s->instance;
+    s->heldByUs = 1;
+
+    printf("%s %s: reporting enabled%s\n", s->ied->name, s->rcbRef,
+           s->resumed ? ", resuming after the last EntryID logged" : "");
+
+    /* the IED sends what it buffered after the EntryID, nothing to ask for */
+    if (s->resumed)
+        return;
+
+    ClientReportControlBlock_setGI(s->rcb, true);
+    IedConnection_setRCBValuesAsync(s->ied->con, &err, s->rcb, RCB_ELEMENT_GI, true, onGi, s);
+}
+
+/* RptEna alone: written together with other elements the IED could purge the buffer again */
+static void writeRptEna(Subscription* s)
+{
+    IedClientError err;
+
+    /* installed before RptEna, the first reports follow right away */
+    IedConnection_installReportHandler(s->ied->con, s->rcbRef, s->rptId, reportCallback, s);
+
+    ClientReportControlBlock_setRptEna(s->rcb, true);
+
+    s->state = SUB_ENABLING;
+    s->pending = IedConnection_setRCBValuesAsync(s->ied->con, &err, s->rcb, RCB_ELEMENT_RPT_ENA, true, onEnabled, s);
+
+    if (err != IED_ERROR_OK) {
+        IedConnection_uninstallReportHandler(s->ied->con, s->rcbRef);
+        nextInstance(s);
+    }
+}
+
+static void onResumed(uint32_t invokeId, void* parameter, IedClientError err)
+{
+    Subscription* s = parameter;
+
+    if (invokeId != s->pending || s->state != SUB_RESUMING)
+        return;
+
+    /* the IED refuses an entry it no longer buffers */
+    s->resumed = err == IED_ERROR_OK;
+
+    if (!s->resumed)
+        printf("%s %s: EntryID no longer buffered by the IED (%d), GI follows\n", s->ied->name, s->rcbRef, err);
+
+    writeRptEna(s);
+}
+
+/* The EntryID logged last, after anything that purges the buffer */
+static void writeEntryId(Subscription* s)
+{
+    IedClientError err;
+    uint8_t resumeEntryId[8];
+
+    s->resumed = 0;
+
+    if (!s->entryKey || !entryLogFind(entryLog, s->entryKey, resumeEntryId)) {
+        writeRptEna(s);
+        return;
+    }
+
+    MmsValue* entryId = MmsValue_newOctetString(8, 8);
+    MmsValue_setOctetString(entryId, resumeEntryId, 8);
+
+    ClientReportControlBlock_setEntryId(s->rcb, entryId);
+    MmsValue_delete(entryId);
+
+    s->state = SUB_RESUMING;
+    s->pending = IedConnection_setRCBValuesAsync(s->ied->con, &err, s->rcb, RCB_ELEMENT_ENTRY_ID, true, onResumed, s);
+
+    if (err != IED_ERROR_OK)
+        writeRptEna(s);
+}
+
+static void onConfigured(uint32_t invokeId, void* parameter, IedClientError err)
+{
+    Subscription* s = parameter;
+
+    if (invokeId != s->pending || s->state != SUB_CONFIGURING)
+        return;
+
+    if (err != IED_ERROR_OK) {
+        printf("%s %s: cannot set trigger options: %d\n", s->ied->name, s->rcbRef, err);
+        nextInstance(s);
+        return;
+    }
+
+    writeEntryId(s);
+}
+
+static void enableInstance(Subscription* s)
+{
+    IedClientError err;
+
+    /* a new SqNum sequence from here on */
+    s->generation++;
+
+    s->entryKey = s->buffered && entryLog ? entryLogKey(s->ied->name, s->rcbRef) : 0;
+
+    int trgOps = TRG_OPT_DATA_CHANGED | TRG_OPT_INTEGRITY | TRG_OPT_GI;
+    int optFlds = RPT_OPT_TIME_STAMP | RPT_OPT_REASON_FOR_INCLUSION | RPT_OPT_SEQ_NUM |
+                  RPT_OPT_ENTRY_ID | RPT_OPT_BUFFER_OVERFLOW;
+
+    /* the IED purges its buffer when these are written, so only if they differ */
+    if (ClientReportControlBlock_getTrgOps(s->rcb) == trgOps && ClientReportControlBlock_getOptFlds(s->rcb) == optFlds) {
+        writeEntryId(s);
+        return;
+    }
+
+    ClientReportControlBlock_setTrgOps(s->rcb, trgOps);
+    ClientReportControlBlock_setOptFlds(s->rcb, optFlds);
+
+    s->state = SUB_CONFIGURING;
+    s->pending = IedConnection_setRCBValuesAsync(s->ied->con, &err, s->rcb,
+                                                 RCB_ELEMENT_TRG_OPS | RCB_ELEMENT_OPT_FLDS,
+                                                 true, onConfigured, s);
+
+    if (err != IED_ERROR_OK)
+        nextInstance(s);
+}
+
+static void onDirectory(uint32_t invokeId, void* parameter, IedClientError err, LinkedList directory, bool isDeletable)
+{
+    Subscription* s = parameter;
+
+    if (invokeId != s->pending || s->state != SUB_DIRECTORY) {
+        if (directory) LinkedList_destroy(directory);
+        return;
+    }
+
+    if (err == IED_ERROR_OK && directory) {
+        DataSetColumns* set = calloc(1, sizeof(DataSetColumns));
+
+        strncpy(set->dataSetRef, ClientReportControlBlock_getDataSetReference(s->rcb), sizeof(set->dataSetRef) - 1);
+
+        for (LinkedList e = LinkedList_getNext(directory); e; e = LinkedList_getNext(e))
+            set->count++;
+
+        set->columns = calloc(set->count, sizeof(DataSetColumn));
+
+        int i = 0;
+        for (LinkedList e = LinkedList_getNext(directory); e; e = LinkedList_getNext(e))
+            setDataSetColumn(&set->columns[i++], (const char*) LinkedList_getData(e));
+
+        /* the writer only sees the set through the reports queued after this */
+        set->next = s->columnSets;
+        s->columnSets = set;
+        s->columns = set;
+    }
+    else
+        printf("%s %s: cannot read the data set (%d), entries are logged by index\n", s->ied->name, s->rcbRef, err);
+
+    if (directory)
+        LinkedList_destroy(directory);
+
+    enableInstance(s);
+}
+
+/* Column names, once per data set: the instances of a range may report different ones */
+static void resolveColumns(Subscription* s)
+{
+    const char* dataSetRef = ClientReportControlBlock_getDataSetReference(s->rcb);
+    IedClientError err;
+    char ref[130];
+
+    s->columns = NULL;
+
+    if (!dataSetRef) {
+        enableInstance(s);
+        return;
+    }
+
+    for (DataSetColumns* set = s->columnSets; set; set = set->next) {
+        if (strcmp(set->dataSetRef, dataSetRef) == 0) {
+            s->columns = set;
+            enableInstance(s);
+            return;
+        }
+    }
+
+    strncpy(ref, dataSetRef, sizeof(ref) - 1);
+    ref[sizeof(ref) - 1] = 0;
+
+    for (char* c = ref; *c; c++)
+        if (*c == '$') *c = '.';
+
+    s->state = SUB_DIRECTORY;
+    s->pending = IedConnection_getDataSetDirectoryAsync(s->ied->con, &err, ref, onDirectory, s);
+
+    if (err != IED_ERROR_OK)
+        enableInstance(s);
+}
+
+static void onReserved(uint32_t invokeId, void* parameter, IedClientError err)
+{
+    Subscription* s = parameter;
+
+    if (invokeId != s->pending || s->state != SUB_RESERVING)
+        return;
+
+    /* reserved by someone else in the meantime; Edition 1 BRCBs have no ResvTms to write */
+    if (err != IED_ERROR_OK &&
+        !(ClientReportControlBlock_isBuffered(s->rcb) && err == IED_ERROR_OBJECT_DOES_NOT_EXIST)) {
+        nextInstance(s);
+        return;
+    }
+
+    resolveColumns(s);
+}
+
+/* Enabled or reserved by another client: not ours to take */
+static int instanceFree(Subscription* s, ClientReportControlBlock rcb)
+{
+    if (ClientReportControlBlock_getRptEna(rcb))
+        return 0;
+
+    if (!ClientReportControlBlock_isBuffered(rcb))
+        return !ClientReportControlBlock_getResv(rcb);
+
+    /* -1: reserved by configuration; > 0 reserved by a client, us only if we enabled it before */
+    int resvTms = ClientReportControlBlock_getResvTms(rcb);
+
+    return resvTms == 0 || (resvTms > 0 && s->heldByUs && s->instance == s->held);
+}
+
+static void onRcbValues(uint32_t invokeId, void* parameter, IedClientError err, ClientReportControlBlock rcb)
+{
+    Subscription* s = parameter;
+
+    if (invokeId != s->pending || s->state != SUB_READING) {
+        if (rcb) ClientReportControlBlock_destroy(rcb);
+        return;
+    }
+
+    s->rcb = rcb;
+
+    if (err != IED_ERROR_OK || rcb == NULL) {
+        if (err != IED_ERROR_OBJECT_DOES_NOT_EXIST)
+            printf("%s %s: cannot read RCB: %d\n", s->ied->name, s->rcbRef, err);
+        nextInstance(s);
+        return;
+    }
+
+    if (!instanceFree(s, rcb)) {
+        nextInstance(s);
+        return;
+    }
+
+    const char* rcbRptId = ClientReportControlBlock_getRptId(rcb);
+    strncpy(s->rptId, rcbRptId ? rcbRptId : "", sizeof(s->rptId) - 1);
+
+    s->buffered = ClientReportControlBlock_isBuffered(rcb);
+
+    if (s->buffered) {
+        ClientReportControlBlock_setResvTms(rcb, RESV_TMS);
+        s->state = SUB_RESERVING;
+        s->pending = IedConnection_setRCBValuesAsync(s->ied->con, &err, rcb, RCB_ELEMENT_RESV_TMS, true, onReserved, s);
+    }
+    else {
+        ClientReportControlBlock_setResv(rcb, true);
+        s->state = SUB_RESERVING;
+        s->pending = IedConnection_setRCBValuesAsync(s->ied->con, &err, rcb, RCB_ELEMENT_RESV, true, onReserved, s);
+    }
+
+    if (err != IED_ERROR_OK)
+        nextInstance(s);
+}
+
+static void readInstance(Subscription* s)
+{
+    IedClientError err;
+
+    if (s->first < 0)
+        snprintf(s->rcbRef, sizeof(s->rcbRef), "%s", s->base);
+    else
+        snprintf(s->rcbRef, sizeof(s->rcbRef), "%s%0*d", s->base, s->width, s->instance);
+
+    s->state = SUB_READING;
+    s->pending = IedConnection_getRCBValuesAsync(s->ied->con, &err, s->rcbRef, NULL, onRcbValues, s);
+
+    if (err != IED_ERROR_OK)
+        nextInstance(s);
+}
+
+/* ===================== IED Connections ===================== */
+
+static void connectIed(Ied* ied, int64_t now)
+{
+    IedClientError err;
+
+    /* no receive thread: the worker ticks the connection */
+    ied->con = IedConnection_createEx(NULL, false);
+
+    IedConnection_setConnectTimeout(ied->con, CONNECT_TIMEOUT_MS);
+    IedConnection_setRequestTimeout(ied->con, REQUEST_TIMEOUT_MS);
+
+    IedConnection_connectAsync(ied->con, &err, ied->host, ied->port);
+
+    ied->state = IED_CONNECTING;
+    ied->sinceMs = now;
+
+    if (err != IED_ERROR_OK) {
+        IedConnection_destroy(ied->con);
+        ied->con = NULL;
+        ied->state = IED_DOWN;
+        ied->sinceMs = now + RECONNECT_INTERVAL_MS;
+    }
+}
+
+static void closeIed(Ied* ied, int64_t now)
+{
+    if (ied->state == IED_UP)
+        printf("%s: connection lost\n", ied->name);
+
+    /* handlers of the requests still open are called on destroy; they find the subscriptions idle */
+    ied->state = IED_DOWN;
+
+    for (Subscription* s = ied->subs; s; s = s->nextOfIed)
+        s->state = SUB_IDLE;
+
+    IedConnection_close(ied->con);
+    IedConnection_destroy(ied->con);
+    ied->con = NULL;
+
+    for (Subscription* s = ied->subs; s; s = s->nextOfIed)
+        releaseRcb(s);
+
+    ied->sinceMs = now + RECONNECT_INTERVAL_MS;
+}
+
+static void serveIed(Ied* ied, int64_t now)
+{
+    IedConnectionState state = IedConnection_getState(ied->con);
+
+    if (state == IED_STATE_CLOSED ||
+        (ied->state == IED_CONNECTING && state != IED_STATE_CONNECTED && now - ied->sinceMs > CONNECT_TIMEOUT_MS)) {
+        closeIed(ied, now);
+        return;
+    }
+
+    if (ied->state == IED_CONNECTING && state == IED_STATE_CONNECTED) {
+        printf("%s: connected\n", ied->name);
+        ied->state = IED_UP;
+
+        for (Subscription* s = ied->subs; s; s = s->nextOfIed)
+            startSubscription(s);
+    }
+
+    if (ied->state == IED_UP) {
+        for (Subscription* s = ied->subs; s; s = s->nextOfIed) {
+            if (s->state == SUB_WAITING && now >= s->retryMs)
+                startSubscription(s);
+
+            /* events lost in the IED's buffer: GI for the current values */
+            if (s->state == SUB_ACTIVE && s->giRequested) {
+                IedClientError err;
+
+                s->giRequested = 0;
+                ClientReportControlBlock_setGI(s->rcb, true);
+                IedConnection_setRCBValuesAsync(ied->con, &err, s->rcb, RCB_ELEMENT_GI, true, onGi, s);
+            }
+        }
+    }
+}
+
+/* ===================== Workers ===================== */
+
+/* RptEna writes not answered yet; handlers that come on destroy only find this worker's own counter */
+static __thread int openDisables;
+
+static void onDisabled(uint32_t invokeId, void* parameter, IedClientError err)
+{
+    openDisables--;
+}
+
+/* RptEna off for everything we enabled, answered or not within a second */
+static void disableAll(Worker* w)
+{
+    IedClientError err;
+
+    openDisables = 0;
+
+    for (Ied* ied = w->ieds; ied; ied = ied->nextOfWorker) {
+        if (ied->state != IED_UP)
+            continue;
+
+        for (Subscription* s = ied->subs; s; s = s->nextOfIed) {
+            if (s->state != SUB_ACTIVE)
+                continue;
+
+            ClientReportControlBlock_setRptEna(s->rcb, false);
+            IedConnection_setRCBValuesAsync(ied->con, &err, s->rcb, RCB_ELEMENT_RPT_ENA, true, onDisabled, NULL);
+
+            if (err == IED_ERROR_OK)
+                openDisables++;
+        }
+    }
+
+    int64_t until = clockWallMs() + 1000;
+
+    while (openDisables > 0 && clockWallMs() < until) {
+        for (Ied* ied = w->ieds; ied; ied = ied->nextOfWorker)
+            if (ied->con)
+                IedConnection_tick(ied->con);
+
+        Thread_sleep(1);
+    }
+}
+
+static void*
+workerThread(void* parameter)
+{
+    Worker* w = parameter;
+
+    while (workersRunning) {
+        int64_t now = clockWallMs();
+        int idle = 1;
+        int connecting = 0;
+
+        for (Ied* ied = w->ieds; ied; ied = ied->nextOfWorker)
+            if (ied->state == IED_CONNECTING)
+                connecting++;
+
+        for (Ied* ied = w->ieds; ied; ied = ied->nextOfWorker) {
+            if (ied->state == IED_DOWN) {
+                /* a few at a time, a thousand SYNs at once help no one */
+                if (now >= ied->sinceMs && connecting < MAX_CONNECTING) {
+                    connectIed(ied, now);
+                    connecting++;
+                }
+                continue;
+            }
+
+            /* false: a message was handled, more may be waiting */
+            if (!IedConnection_tick(ied->con))
+                idle = 0;
+
+            serveIed(ied, now);
+        }
+
+        if (idle)
+            Thread_sleep(1);
+    }
+
+    disableAll(w);
+
+    for (Ied* ied = w->ieds; ied; ied = ied->nextOfWorker) {
+        if (ied->con) {
+            IedConnection_close(ied->con);
+            IedConnection_destroy(ied->con);
+            ied->con = NULL;
+        }
+        ied->state = IED_DOWN;
+    }
+
+    return NULL;
+}
+
+void subscriberStart(int n)
+{
+    workerCount = n < 1 ? 1 : n > MAX_WORKERS ? MAX_WORKERS : n;
+    if (workerCount > iedCount && iedCount > 0)
+        workerCount = iedCount;
+
+    /* dealt out in reverse so every worker's list keeps the file order */
+    for (int i = iedCount - 1; i >= 0; i--) {
+        Worker* w = &workers[i % workerCount];
+
+        ieds[i].worker = i % workerCount;
+        ieds[i].nextOfWorker = w->ieds;
+        w->ieds = &ieds[i];
+    }
+
+    for (int i = 0; i < workerCount; i++) {
+        workers[i].queue = reportQueueCreate();
+        workers[i].thread = Thread_create(workerThread, &workers[i], false);
+        Thread_start(workers[i].thread);
+    }
+
+    printf("%d workers for %d IEDs\n", workerCount, iedCount);
+}
+
+void subscriberStop(void)
+{
+    workersRunning = 0;
+
+    for (int i = 0; i < workerCount; i++)
+        Thread_destroy(workers[i].thread);
+}
+
+void subscriberCounts(int* iedsUp, int* active)
+{
+    *iedsUp = 0;
+    *active = 0;
+
+    for (int i = 0; i < iedCount; i++)
+        if (ieds[i].state == IED_UP)
+            (*iedsUp)++;
+
+    for (int i = 0; i < subscriptionCount; i++)
+        if (subscriptions[i].state == SUB_ACTIVE)
+            (*active)++;
+}
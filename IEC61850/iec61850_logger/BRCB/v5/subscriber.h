@@ -0,0 +1,185 @@
+/*
+ * Report subscriptions of many RCBs on many IEDs, served by a few threads
+ *
+ * Every IED gets one association, created without its own receive thread
+ * (IedConnection_createEx(NULL, false)). The IEDs are dealt out to a fixed
+ * number of workers; a worker ticks all its connections in one loop and
+ * drives every subscription through the asynchronous client services
+ * (connect, read RCB, reserve, read data set directory, enable, GI), so a
+ * slow or dead IED never blocks the others and a thousand subscriptions need
+ * no more threads than workers.
+ *
+ * A subscription names an RCB, or a range of instances of an indexed RCB
+ * ("EventsIndexed01..03"). The first instance that is neither enabled nor
+ * reserved by another client is taken (URCB: Resv, BRCB: ResvTms), the one
+ * held before a reconnect is tried first, after a restart the first one with
+ * an EntryID in the journal.
+ *
+ * Enable: ResvTms, TrgOps/OptFlds (only if they differ, the IED purges its
+ * buffer), the EntryID logged last (BRCB), then RptEna alone. A GI follows
+ * unless the IED took the EntryID and sends what it buffered after it.
+ */
+
+#ifndef SUBSCRIBER_H
+#define SUBSCRIBER_H
+
+#include <stdint.h>
+
+#include "iec61850_client.h"
+#include "hal_thread.h"
+
+#include "entrylog.h"
+#include "metrics.h"
+#include "reportqueue.h"
+
+#define MAX_WORKERS 16
+
+/* Connects a worker has in progress at the same time */
+#define MAX_CONNECTING 8
+
+#define CONNECT_TIMEOUT_MS 10000
+#define REQUEST_TIMEOUT_MS 5000
+#define RECONNECT_INTERVAL_MS 10000
+
+/* No free instance: the range is tried again after */
+#define INSTANCE_RETRY_MS 30000
+
+/* Seconds the IED keeps a BRCB reserved for us after the association is lost */
+#define RESV_TMS 300
+
+typedef struct {
+    char csvKey[140];       /* "GenericIO/GGIO1.SPCSO1.stVal[ST]" */
+    char jsonKey[160];      /* "\",\"tag\":\"GenericIO/GGIO1.SPCSO1.stVal[ST]" */
+} DataSetColumn;
+
+/* Members of one data set; kept for the life of the logger, queued reports point at them */
+typedef struct sDataSetColumns {
+    char dataSetRef[130];
+    DataSetColumn* columns;
+    int count;
+    struct sDataSetColumns* next;
+} DataSetColumns;
+
+/* Continuity and latency of one subscription, written by the report writer */
+typedef struct {
+    int generation;             /* of the last report; a new one restarts the checks */
+    int haveSeqNum;
+    uint32_t lastSeqNum;
+    int haveEntryId;
+    uint8_t lastEntryId[8];
+
+    long reports;
+    long entries;
+    long missed;                /* reports skipped in the SqNum sequence */
+    long duplicates;            /* same SqNum again (not a segment) */
+    long backwards;             /* SqNum went back */
+    long entryIdRepeats;        /* same EntryID again */
+    long overflows;             /* reports with BufOvfl */
+    int64_t latencyMaxUs;       /* receive time - TimeOfEntry */
+} SubscriptionStats;
+
+/* Latest value of a data set member, kept by the writer for the snapshot file */
+typedef struct {
+    char value[256];
+    char source[32];
+    char time[32];
+    uint8_t reasons;
+    uint8_t known;
+} LatestValue;
+
+typedef struct sIed Ied;
+typedef struct sSubscription Subscription;
+
+struct sIed {
+    char name[80];              /* "host:port", the ied column of the log */
+    char host[64];
+    int port;
+    int worker;
+
+    IedConnection con;          /* NULL while down */
+    int state;
+    int64_t sinceMs;            /* connect started / next connect */
+
+    Subscription* subs;         /* linked by nextOfIed */
+    Ied* nextOfWorker;
+};
+
+struct sSubscription {
+    Ied* ied;
+    Subscription* nextOfIed;
+
+    char base[130];             /* "GenericIO/LLN0.RP.EventsIndexed" */
+    int first, last, width;     /* instances base01..base03; first -1: base is the RCB */
+
+    int instance;               /* instance being tried or held */
+    int held;                   /* instance held before the association was lost, -1 */
+    int heldByUs;               /* held was enabled by us, its ResvTms reservation is ours */
+    int tried;
+    char rcbRef[130];
+    char rptId[130];
+    ClientReportControlBlock rcb;
+    int buffered;
+    uint64_t entryKey;          /* EntryID journal key of the instance enabled, 0: URCB */
+    int resumed;                /* the IED took the journalled EntryID: no GI */
+    int generation;             /* counts enables, reports carry it */
+
+    int state;
+    uint32_t pending;           /* invoke ID of the request we wait for */
+    int64_t retryMs;
+    volatile int giRequested;   /* set by the writer on BufOvfl */
+
+    /* worker only: the data sets resolved so far, and the one of the instance enabled (NULL: by index) */
+    DataSetColumns* columnSets;
+    DataSetColumns* columns;
+
+    SubscriptionStats stats;
+
+    /* written by the report writer only */
+    LatestValue* latest;
+    int latestCount;
+    const DataSetColumns* latestColumns;    /* data set the latest values belong to */
+};
+
+typedef struct {
+    ReportQueue* queue;
+    Thread thread;
+    Ied* ieds;                  /* linked by nextOfWorker */
+
+    /* written by this worker only */
+    volatile long droppedReports;
+    Histogram callbackUs;       /* report handler service time */
+} Worker;
+
+extern Ied* ieds;
+extern int iedCount;
+
+extern Subscription* subscriptions;
+extern int subscriptionCount;
+
+extern Worker workers[MAX_WORKERS];
+extern int workerCount;
+
+/* Opened by main before subscriberStart; BRCBs resume after the EntryID logged last, NULL: GI only */
+extern EntryLog* entryLog;
+
+/* CSV and JSON keys of a data set member, rendered once */
+void setDataSetColumn(DataSetColumn* c, const char* tag);
+
+/*
+ * One subscription per line:
+ *   host[:port], LD/LN.RP.RCB          an RCB
+ *   host[:port], LD/LN.BR.RCB01..08    the first free instance of an indexed RCB
+ * A line listed twice subscribes two instances.
+ */
+int subscriberLoad(const char* fileName);
+
+/* IEDs are dealt out to n workers, each started with its own report queue */
+void subscriberStart(int n);
+
+/* Reporting disabled, associations closed, workers joined */
+void subscriberStop(void);
+
+/* IEDs connected and subscriptions receiving reports */
+void subscriberCounts(int* iedsUp, int* active);
+
+#endif /* SUBSCRIBER_H */
@@ -0,0 +1,218 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include "mms_value.h"
+
+#include "mmsfmt.h"
+
+/*
+ * ns per value of the shared formatter (mmsfmt.h) against the snprintf /
+ * strftime / strncat formatting it replaced, for every MmsType the loggers
+ * see:
+ *   fmt_bench [iterations]
+ */
+
+#define DEFAULT_ITERATIONS 1000000
+#define TEXT_SIZE 1024
+
+static double nowMs()
+{
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER c;
+
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency(&freq);
+
+    QueryPerformanceCounter(&c);
+    return (double) c.QuadPart * 1000.0 / (double) freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+}
+
+/* The former mmsToText (Polling) / mmsValueToString (BRCB), structures included */
+static void legacyToText(MmsValue* v, char* out, int outLen)
+{
+    switch (MmsValue_getType(v)) {
+
+    case MMS_BOOLEAN:
+        snprintf(out, outLen, "%s", MmsValue_getBoolean(v) ? "TRUE" : "FALSE");
+        break;
+
+    case MMS_INTEGER:
+    case MMS_UNSIGNED:
+        snprintf(out, outLen, "%lld", (long long) MmsValue_toInt64(v));
+        break;
+
+    case MMS_FLOAT:
+        snprintf(out, outLen, "%f", MmsValue_toFloat(v));
+        break;
+
+    case MMS_VISIBLE_STRING:
+    case MMS_STRING:
+    case MMS_OCTET_STRING: {
+        const char* s = MmsValue_toString(v);
+        if (s) {
+            strncpy(out, s, outLen - 1);
+            out[outLen - 1] = 0;
+        } else {
+            snprintf(out, outLen, "<empty>");
+        }
+        break;
+    }
+
+    case MMS_BIT_STRING:
+        MmsValue_printToBuffer(v, out, outLen);
+        break;
+
+    case MMS_UTC_TIME: {
+        uint64_t t = MmsValue_getUtcTimeInMs(v);
+        time_t sec = (time_t) (t / 1000);
+        struct tm tm;
+#ifdef _WIN32
+        gmtime_s(&tm, &sec);
+#else
+        gmtime_r(&sec, &tm);
+#endif
+        strftime(out, outLen, "%Y-%m-%dT%H:%M:%SZ", &tm);
+        break;
+    }
+
+    case MMS_STRUCTURE:
+    case MMS_ARRAY: {
+        out[0] = '\0';
+        strncat(out, "{", outLen - 1);
+        int n = MmsValue_getArraySize(v);
+        for (int i = 0; i < n; ++i) {
+            char tmp[256];
+            legacyToText(MmsValue_getElement(v, i), tmp, sizeof(tmp));
+            strncat(out, tmp, outLen - strlen(out) - 1);
+            if (i != n - 1) strncat(out, ",", outLen - strlen(out) - 1);
+        }
+        strncat(out, "}", outLen - strlen(out) - 1);
+        break;
+    }
+
+    default:
+        snprintf(out, outLen, "UNSUPPORTED(%d)", MmsValue_getType(v));
+        break;
+    }
+}
+
+static void newToText(MmsValue* v, char* out, int outLen)
+{
+    *fmtMmsValue(out, out + outLen, v) = 0;
+}
+
+/* Values vary from one iteration to the next, as a log stream does */
+#define VARIANTS 64
+
+typedef struct {
+    const char* name;
+    MmsValue* values[VARIANTS];
+} Case;
+
+static double timeCase(Case* c, void (*format)(MmsValue*, char*, int), long iterations, char* sample)
+{
+    static char out[TEXT_SIZE];
+    long checksum = 0;
+
+    double start = nowMs();
+
+    for (long i = 0; i < iterations; i++) {
+        format(c->values[i % VARIANTS], out, sizeof(out));
+        checksum += out[0];
+    }
+
+    double ns = (nowMs() - start) * 1e6 / iterations;
+
+    strncpy(sample, out, 63);
+    sample[63] = 0;
+
+    /* keeps the loop from being optimized away */
+    if (checksum == 42)
+        printf(" ");
+
+    return ns;
+}
+
+/* {mag {f}, q, t} as read from an MV data object, plus an 8-element array */
+static MmsValue* newMeasurement(int i)
+{
+    MmsValue* mag = MmsValue_createEmptyStructure(1);
+    MmsValue_setElement(mag, 0, MmsValue_newFloat(230.0f + 0.137f * i));
+
+    MmsValue* q = MmsValue_newBitString(13);
+    MmsValue_setBitStringFromInteger(q, (uint32_t) (i & 3));
+
+    MmsValue* mv = MmsValue_createEmptyStructure(3);
+    MmsValue_setElement(mv, 0, mag);
+    MmsValue_setElement(mv, 1, q);
+    MmsValue_setElement(mv, 2, MmsValue_newUtcTimeByMsTime(1700000000000ULL + 100ULL * i));
+
+    return mv;
+}
+
+int main(int argc, char** argv)
+{
+    long iterations = argc > 1 ? atol(argv[1]) : DEFAULT_ITERATIONS;
+
+    if (iterations < VARIANTS) {
+        printf("Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    static Case cases[] = {
+        { "BOOLEAN", { 0 } }, { "INTEGER", { 0 } }, { "UNSIGNED", { 0 } }, { "FLOAT", { 0 } }, { "VISIBLE_STRING", { 0 } },
+        { "BIT_STRING", { 0 } }, { "UTC_TIME", { 0 } }, { "STRUCTURE", { 0 } }, { "ARRAY", { 0 } }
+    };
+    int caseCount = (int) (sizeof(cases) / sizeof(cases[0]));
+
+    for (int i = 0; i < VARIANTS; i++) {
+        char text[32];
+        snprintf(text, sizeof(text), "Relay-%d", i * 7919);
+
+        MmsValue* q = MmsValue_newBitString(13);
+        MmsValue_setBitStringFromInteger(q, (uint32_t) (i * 37) & 0x1fff);
+
+        cases[0].values[i] = MmsValue_newBoolean(i & 1);
+        cases[1].values[i] = MmsValue_newIntegerFromInt32(i * 104729 - 3000000);
+        cases[2].values[i] = MmsValue_newUnsignedFromUint32((uint32_t) i * 2654435761u);
+        cases[3].values[i] = MmsValue_newFloat(50.0f + 0.0173f * i);
+        cases[4].values[i] = MmsValue_newVisibleString(text);
+        cases[5].values[i] = q;
+        cases[6].values[i] = MmsValue_newUtcTimeByMsTime(1700000000000ULL + 100ULL * i);
+        cases[7].values[i] = newMeasurement(i);
+
+        MmsValue* array = MmsValue_createEmptyArray(8);
+        for (int k = 0; k < 8; k++)
+            MmsValue_setElement(array, k, newMeasurement(i + k));
+        cases[8].values[i] = array;
+    }
+
+    printf("%-15s %10s %10s %7s   %s\n", "MmsType", "old ns", "new ns", "speedup", "new text");
+
+    for (int i = 0; i < caseCount; i++) {
+        char oldText[64], newText[64];
+
+        double oldNs = timeCase(&cases[i], legacyToText, iterations, oldText);
+        double newNs = timeCase(&cases[i], newToText, iterations, newText);
+
+        printf("%-15s %10.1f %10.1f %6.1fx   %s\n", cases[i].name, oldNs, newNs, oldNs / newNs, newText);
+    }
+
+    for (int i = 0; i < caseCount; i++)
+        for (int k = 0; k < VARIANTS; k++)
+            MmsValue_delete(cases[i].values[k]);
+
+    return 0;
+}
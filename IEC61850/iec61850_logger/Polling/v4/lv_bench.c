@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include "lvtable.h"
+
+#define BENCH_FILE "lv-bench.lvt"
+#define MAX_READERS 64
+
+/*
+ * Stress test of the latest-value table:
+ *   lv_bench [slots] [readers] [seconds]
+ * One writer updates every slot as fast as it can while the readers, each
+ * with its own mapping, take snapshots and check that none is torn: every
+ * update fills the whole slot from one counter.
+ */
+
+typedef struct {
+    long long reads;
+    long long retries;
+    long long torn;
+} ReaderStats;
+
+int slotCount = 1000;
+int readerCount = 4;
+int seconds = 5;
+
+volatile int running = 1;     /* cleared by the writer when the time is up */
+long long updates = 0;
+
+LvTable* table;
+ReaderStats stats[MAX_READERS];
+
+static double nowMs()
+{
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER c;
+
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency(&freq);
+
+    QueryPerformanceCounter(&c);
+    return (double) c.QuadPart * 1000.0 / (double) freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+}
+
+/* Runs on the main thread until the time is up */
+static void writer(double endMs)
+{
+    TsSample s;
+    memset(&s, 0, sizeof(s));
+    s.kind = TS_TEXT;
+
+    for (int64_t n = 1; nowMs() < endMs; n++) {
+        for (int i = 0; i < slotCount; i++) {
+            s.timeMs = n;
+            memset(s.value.text, 'a' + (int) (n % 26), TS_TEXT_SIZE);
+
+            lvWriteValue(table, i, &s);
+        }
+
+        updates += slotCount;
+    }
+
+    running = 0;
+}
+
+static void reader(ReaderStats* st)
+{
+    LvTable* t = lvOpen(BENCH_FILE);
+    LvValue v;
+
+    if (!t) {
+        printf("Cannot open %s\n", BENCH_FILE);
+        return;
+    }
+
+    while (running) {
+        for (int i = 0; i < slotCount; i++) {
+            st->retries += lvRead(t, i, &v);
+            st->reads++;
+
+            if (v.updates == 0)
+                continue;
+
+            /* one update writes updates, updateMs and every text byte from the same n */
+            int torn = v.updateMs != (int64_t) v.updates || v.value.timeMs != v.updateMs;
+
+            for (int k = 0; k < TS_TEXT_SIZE && !torn; k++)
+                torn = v.value.value.text[k] != 'a' + (int) (v.updateMs % 26);
+
+            st->torn += torn;
+        }
+    }
+
+    lvClose(t);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI readerThread(LPVOID param)
+{
+    reader(param);
+    return 0;
+}
+#else
+static void* readerThread(void* param)
+{
+    reader(param);
+    return NULL;
+}
+#endif
+
+int main(int argc, char** argv)
+{
+    if (argc > 1) slotCount = atoi(argv[1]);
+    if (argc > 2) readerCount = atoi(argv[2]);
+    if (argc > 3) seconds = atoi(argv[3]);
+
+    if (slotCount < 1 || readerCount < 0 || readerCount > MAX_READERS || seconds < 1) {
+        printf("Usage: %s [slots] [readers (max %d)] [seconds]\n", argv[0], MAX_READERS);
+        return 1;
+    }
+
+    table = lvCreate(BENCH_FILE, slotCount);
+    if (!table)
+        return 1;
+
+    for (int i = 0; i < slotCount; i++) {
+        char tag[48];
+        snprintf(tag, sizeof(tag), "Bench/GGIO1.AnIn%d.mag.f", i);
+        lvSetTag(table, i, "127.0.0.1:102", tag);
+    }
+
+#ifdef _WIN32
+    HANDLE threads[MAX_READERS];
+    for (int i = 0; i < readerCount; i++)
+        threads[i] = CreateThread(NULL, 0, readerThread, &stats[i], 0, NULL);
+#else
+    pthread_t threads[MAX_READERS];
+    for (int i = 0; i < readerCount; i++)
+        pthread_create(&threads[i], NULL, readerThread, &stats[i]);
+#endif
+
+    double start = nowMs();
+    writer(start + seconds * 1000.0);
+    double elapsed = (nowMs() - start) / 1000.0;
+
+#ifdef _WIN32
+    for (int i = 0; i < readerCount; i++) {
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+    }
+#else
+    for (int i = 0; i < readerCount; i++)
+        pthread_join(threads[i], NULL);
+#endif
+
+    long long reads = 0, retries = 0, torn = 0;
+
+    for (int i = 0; i < readerCount; i++) {
+        reads += stats[i].reads;
+        retries += stats[i].retries;
+        torn += stats[i].torn;
+    }
+
+    printf("%d slots, %d readers, %.1f s\n", slotCount, readerCount, elapsed);
+    printf("Writer: %lld updates, %.2f M/s\n", updates, updates / elapsed / 1e6);
+    printf("Readers: %lld reads, %.2f M/s, %lld retries (%.3f%%), %lld torn\n",
+           reads, reads / elapsed / 1e6, retries, reads ? 100.0 * retries / reads : 0.0, torn);
+
+    lvClose(table);
+    remove(BENCH_FILE);
+
+    return torn ? 1 : 0;
+}
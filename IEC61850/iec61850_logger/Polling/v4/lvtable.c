@@ -0,0 +1,290 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "lvtable.h"
+
+#define LV_VERSION 1
+
+/* Retries spent spinning before a reader gives up its time slice to the writer */
+#define LV_SPIN_LIMIT 64
+
+static void yieldToWriter()
+{
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+struct sLvTable {
+    uint8_t* data;
+    long long size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+
+    LvHeader* header;
+    LvSlot* slots;
+    int slotCount;
+};
+
+/* ===================== Mapping ===================== */
+
+/* size > 0: open for writing and grow the file to at least size bytes */
+static int mapTable(LvTable* t, const char* fileName, long long size)
+{
+    int writable = size > 0;
+
+#ifdef _WIN32
+    t->file = CreateFileA(fileName, writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+                          FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                          writable ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (t->file == INVALID_HANDLE_VALUE)
+        return 0;
+
+    LARGE_INTEGER current;
+    if (!GetFileSizeEx(t->file, &current))
+        return 0;
+
+    /* the file is never shrunk: readers may still have it mapped */
+    if (current.QuadPart > size)
+        size = current.QuadPart;
+
+    if (size < (long long) sizeof(LvHeader))
+        return 0;
+
+    t->mapping = CreateFileMappingA(t->file, NULL, writable ? PAGE_READWRITE : PAGE_READONLY,
+                                    (DWORD) (size >> 32), (DWORD) size, NULL);
+    if (!t->mapping)
+        return 0;
+
+    t->data = MapViewOfFile(t->mapping, writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, 0);
+#else
+    int fd = open(fileName, writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+    if (fd < 0)
+        return 0;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return 0;
+    }
+
+    /* the file is never shrunk: readers may still have it mapped */
+    if (st.st_size > size)
+        size = st.st_size;
+    else if (writable && ftruncate(fd, size) != 0) {
+        close(fd);
+        return 0;
+    }
+
+    if (size < (long long) sizeof(LvHeader)) {
+        close(fd);
+        return 0;
+    }
+
+    void* p = mmap(NULL, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    t->data = p == MAP_FAILED ? NULL : p;
+#endif
+
+    t->size = size;
+    t->header = (LvHeader*) t->data;
+    t->slots = (LvSlot*) (t->data + sizeof(LvHeader));
+
+    return t->data != NULL;
+}
+
+void lvClose(LvTable* t)
+{
+#ifdef _WIN32
+    if (t->data) UnmapViewOfFile(t->data);
+    if (t->mapping) CloseHandle(t->mapping);
+    if (t->file && t->file != INVALID_HANDLE_VALUE) CloseHandle(t->file);
+#else
+    if (t->data) munmap(t->data, t->size);
+#endif
+    free(t);
+}
+
+/* ===================== Reader ===================== */
+
+LvTable* lvOpen(const char* fileName)
+{
+    LvTable* t = calloc(1, sizeof(LvTable));
+
+    if (!mapTable(t, fileName, 0)) {
+        lvClose(t);
+        return NULL;
+    }
+
+    LvHeader* h = t->header;
+
+    if (memcmp(h->magic, "MLVT", 4) != 0 || h->version != LV_VERSION || h->slotSize != sizeof(LvSlot)
+            || (long long) (sizeof(LvHeader) + (uint64_t) h->slotCount * sizeof(LvSlot)) > t->size) {
+        lvClose(t);
+        return NULL;
+    }
+
+    t->slotCount = (int) h->slotCount;
+
+    return t;
+}
+
+int lvSlotCount(LvTable* t)
+{
+    return t->slotCount;
+}
+
+int64_t lvGeneration(LvTable* t)
+{
+    return t->header->generation;
+}
+
+int lvFind(LvTable* t, const char* ied, const char* tag)
+{
+    for (int i = 0; i < t->slotCount; i++) {
+        const LvValue* d = &t->slots[i].data;
+
+        /* tag and ied are written once, before the table is published */
+        if (strcmp(d->tag, tag) == 0 && (!ied || strcmp(d->ied, ied) == 0))
+            return i;
+    }
+
+    return -1;
+}
+
+int lvRead(LvTable* t, int slot, LvValue* out)
+{
+    const LvSlot* s = &t->slots[slot];
+
+    for (int retries = 0; ; retries++) {
+        if (retries > 0 && retries % LV_SPIN_LIMIT == 0)
+            yieldToWriter();
+
+        uint32_t before = __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE);
+
+        if (before & 1)
+            continue;
+
+        memcpy(out, (const void*) &s->data, sizeof(*out));
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (__atomic_load_n(&s->seq, __ATOMIC_RELAXED) == before)
+            return retries;
+    }
+}
+
+/* ===================== Writer ===================== */
+
+static LvSlot* beginWrite(LvTable* t, int slot)
+{
+    LvSlot* s = &t->slots[slot];
+
+    __atomic_store_n(&s->seq, s->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    return s;
+}
+
+static void endWrite(LvSlot* s)
+{
+    __atomic_store_n(&s->seq, s->seq + 1, __ATOMIC_RELEASE);
+}
+
+LvTable* lvCreate(const char* fileName, int slotCount)
+{
+    LvTable* t = calloc(1, sizeof(LvTable));
+
+    if (!mapTable(t, fileName, (long long) sizeof(LvHeader) + (long long) slotCount * sizeof(LvSlot))) {
+        printf("Cannot map latest-value table %s\n", fileName);
+        lvClose(t);
+        return NULL;
+    }
+
+    LvHeader* h = t->header;
+
+    /* a reader of the previous run sees every slot change, so seq keeps counting */
+    int oldCount = memcmp(h->magic, "MLVT", 4) == 0 && h->slotSize == sizeof(LvSlot) ? (int) h->slotCount : 0;
+
+    t->slotCount = slotCount;
+
+    for (int i = 0; i < slotCount; i++) {
+        LvSlot* s = &t->slots[i];
+
+        if (i >= oldCount)
+            s->seq = 0;
+
+        beginWrite(t, i);
+        memset(&s->data, 0, sizeof(s->data));
+        endWrite(s);
+    }
+
+    memcpy(h->magic, "MLVT", 4);
+    h->version = LV_VERSION;
+    h->slotSize = sizeof(LvSlot);
+    h->generation = (int64_t) time(NULL) * 1000;
+
+    __atomic_store_n(&h->slotCount, (uint32_t) slotCount, __ATOMIC_RELEASE);
+
+    return t;
+}
+
+void lvSetTag(LvTable* t, int slot, const char* ied, const char* tag)
+{
+    LvSlot* s = beginWrite(t, slot);
+
+    strncpy(s->data.tag, tag, LV_TAG_SIZE - 1);
+    strncpy(s->data.ied, ied, LV_IED_SIZE - 1);
+
+    endWrite(s);
+}
+
+void lvWriteValue(LvTable* t, int slot, const TsSample* value)
+{
+    LvSlot* s = beginWrite(t, slot);
+
+    s->data.value = *value;
+    s->data.updateMs = value->timeMs;
+    s->data.flags |= LV_HAS_VALUE;
+    s->data.updates++;
+
+    endWrite(s);
+}
+
+void lvWriteQuality(LvTable* t, int slot, uint32_t quality, int qualitySize)
+{
+    LvSlot* s = beginWrite(t, slot);
+
+    s->data.quality = quality;
+    s->data.qualitySize = qualitySize;
+    s->data.flags |= LV_HAS_QUALITY;
+
+    endWrite(s);
+}
+
+void lvWriteSourceTime(LvTable* t, int slot, int64_t sourceTimeMs)
+{
+    LvSlot* s = beginWrite(t, slot);
+
+    s->data.sourceTimeMs = sourceTimeMs;
+    s->data.flags |= LV_HAS_SOURCE_TIME;
+
+    endWrite(s);
+}
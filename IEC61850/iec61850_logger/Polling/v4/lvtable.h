@@ -0,0 +1,86 @@
+/*
+ * Latest-value table (mms-latest.lvt)
+ *
+ * The polling logger keeps the last value of every target in a file mapped
+ * into memory; local programs map the same file and read it without any
+ * system call per read and without extra MMS traffic.
+ *
+ * File: LvHeader, then slotCount LvSlot records (one per target, fixed for
+ * the life of the logger). Every slot has its own sequence lock: the single
+ * writer of the slot makes seq odd, updates the slot and makes it even
+ * again; a reader copies the slot and retries if seq was odd or changed
+ * meanwhile.
+ */
+
+#ifndef LVTABLE_H
+#define LVTABLE_H
+
+#include <stdint.h>
+
+#include "tslog.h"
+
+#define LV_TAG_SIZE 128
+#define LV_IED_SIZE 64
+
+#define LV_HAS_VALUE        1
+#define LV_HAS_QUALITY      2   /* q of the target's data object is polled too */
+#define LV_HAS_SOURCE_TIME  4   /* t of the target's data object is polled too */
+
+typedef struct {
+    char magic[4];              /* "MLVT" */
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t slotSize;
+    int64_t generation;         /* writer start time; changes when the logger restarts */
+} LvHeader;
+
+/* Consistent copy of one slot */
+typedef struct {
+    char tag[LV_TAG_SIZE];      /* object reference, e.g. "GenericIO/GGIO1.AnIn1.mag.f" */
+    char ied[LV_IED_SIZE];      /* "host:port" */
+    uint32_t flags;
+    uint32_t updates;           /* number of reads of the value */
+    int64_t updateMs;           /* when the value was last read, ms since 1970 */
+    int64_t sourceTimeMs;       /* LV_HAS_SOURCE_TIME */
+    uint32_t quality;           /* LV_HAS_QUALITY, bit i = bit i of the bit string */
+    int32_t qualitySize;
+    TsSample value;             /* LV_HAS_VALUE */
+} LvValue;
+
+typedef struct {
+    volatile uint32_t seq;
+    uint32_t reserved;
+    LvValue data;
+} LvSlot;
+
+typedef struct sLvTable LvTable;
+
+/* ===================== Reader ===================== */
+
+LvTable* lvOpen(const char* fileName);
+
+int lvSlotCount(LvTable* t);
+
+int64_t lvGeneration(LvTable* t);
+
+/* Slot of a tag (ied may be NULL for any IED), -1 if the logger does not poll it */
+int lvFind(LvTable* t, const char* ied, const char* tag);
+
+/* Consistent snapshot of one slot; returns the number of retries needed */
+int lvRead(LvTable* t, int slot, LvValue* out);
+
+void lvClose(LvTable* t);
+
+/* ===================== Writer (one thread per slot at a time) ===================== */
+
+LvTable* lvCreate(const char* fileName, int slotCount);
+
+void lvSetTag(LvTable* t, int slot, const char* ied, const char* tag);
+
+void lvWriteValue(LvTable* t, int slot, const TsSample* value);
+
+void lvWriteQuality(LvTable* t, int slot, uint32_t quality, int qualitySize);
+
+void lvWriteSourceTime(LvTable* t, int slot, int64_t sourceTimeMs);
+
+#endif /* LVTABLE_H */
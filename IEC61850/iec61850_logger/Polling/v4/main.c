@@ -1,206 +1,2234 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <time.h>
-#include <windows.h>
-
-#include "iec61850_client.h"
-#include "mms_value.h"
-
-#define MAX_TARGETS 256
-#define LINE_SIZE 512
-#define POLL_INTERVAL_MS 1000
-
-typedef struct {
-    int fc;
-    char path[256];
-} Target;
-
-Target targets[MAX_TARGETS];
-int targetCount = 0;
-
-/* ===================== Time ===================== */
-
-const char* nowISO8601()
-{
-    static char buf[32];
-    time_t t = time(NULL);
-    struct tm tm;
-    gmtime_s(&tm, &t);
-    strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
-    return buf;
-}
-
-/* ===================== FC Parsing ===================== */
-
-int parseFC(const char* s)
-{
-    if (strcmp(s, "ST") == 0) return IEC61850_FC_ST;
-    if (strcmp(s, "DC") == 0) return IEC61850_FC_DC;
-    if (strcmp(s, "MX") == 0) return IEC61850_FC_MX;
-    if (strcmp(s, "CO") == 0) return IEC61850_FC_CO;
-    if (strcmp(s, "SP") == 0) return IEC61850_FC_SP;
-    if (strcmp(s, "SV") == 0) return IEC61850_FC_SV;
-    if (strcmp(s, "EX") == 0) return IEC61850_FC_EX;
-
-    return IEC61850_FC_ST; /* default */
-}
-
-/* ===================== Target File Parsing ===================== */
-
-void loadTargets(const char* filename)
-{
-    FILE* f = fopen(filename, "r");
-    if (!f) {
-        printf("Cannot open targets.txt\n");
-        exit(1);
-    }
-
-    char line[LINE_SIZE];
-
-    while (fgets(line, sizeof(line), f)) {
-
-        char* p = strchr(line, '\n');
-        if (p) *p = 0;
-
-        if (strlen(line) < 5) continue;
-
-        char* comma = strchr(line, ',');
-        if (!comma) continue;
-
-        *comma = 0;
-
-        char* fcStr = line;
-        char* pathStr = comma + 1;
-
-        while (*pathStr == ' ') pathStr++;
-
-        targets[targetCount].fc = parseFC(fcStr);
-        strncpy(targets[targetCount].path, pathStr, sizeof(targets[targetCount].path) - 1);
-
-        targetCount++;
-        if (targetCount >= MAX_TARGETS) break;
-    }
-
-    fclose(f);
-
-    printf("Loaded %d targets\n", targetCount);
-}
-
-/* ===================== MMS VALUE TO STRING ===================== */
-
-void mmsToText(MmsValue* v, char* out, int outLen)
-{
-    if (!v) {
-        snprintf(out, outLen, "<null>");
-        return;
-    }
-
-    switch (MmsValue_getType(v)) {
-
-    case MMS_BOOLEAN:
-        snprintf(out, outLen, "%s", MmsValue_getBoolean(v) ? "TRUE" : "FALSE");
-        break;
-
-    case MMS_INTEGER:
-    case MMS_UNSIGNED:
-        snprintf(out, outLen, "%lld", (long long) MmsValue_toInt64(v));
-        break;
-
-    case MMS_FLOAT:
-        snprintf(out, outLen, "%f", MmsValue_toFloat(v));
-        break;
-
-    case MMS_VISIBLE_STRING:
-    case MMS_STRING:
-    case MMS_OCTET_STRING: {
-        char* s = MmsValue_toString(v);
-        if (s) {
-            strncpy(out, s, outLen - 1);
-            out[outLen - 1] = 0;
-        } else {
-            snprintf(out, outLen, "<empty>");
-        }
-        break;
-    }
-    case MMS_BIT_STRING:
-        MmsValue_printToBuffer(v, out, (int)outLen);
-        break;
-	
-    case MMS_UTC_TIME: {
-        uint64_t t = MmsValue_getUtcTimeInMs(v);
-        time_t sec = (time_t)(t / 1000);
-        struct tm tm;
-        gmtime_s(&tm, &sec);
-        strftime(out, outLen, "%Y-%m-%dT%H:%M:%SZ", &tm);
-        break;
-    }
-
-    default:
-        snprintf(out, outLen, "UNSUPPORTED(%d)", MmsValue_getType(v));
-        break;
-    }
-}
-
-/* ===================== MAIN ===================== */
-
-int main()
-{
-    IedClientError err;
-    IedConnection con = IedConnection_create();
-
-    loadTargets("targets.txt");
-
-    IedConnection_connect(con, &err, "10.10.6.100", 102);
-
-    if (err != IED_ERROR_OK) {
-        printf("Connection failed\n");
-        return 1;
-    }
-
-    FILE* csv = fopen("mms-log.csv", "w");
-    FILE* json = fopen("mms-log.json", "w");
-
-    fprintf(csv, "time,tag,value\n");
-
-    while (1) {
-
-        for (int i = 0; i < targetCount; i++) {
-
-            MmsValue* v = IedConnection_readObject(
-                con, 
-                &err,
-                targets[i].path,
-                targets[i].fc
-            );
-
-            if (v && err == IED_ERROR_OK) {
-
-                char value[512];
-                mmsToText(v, value, sizeof(value));
-
-                const char* t = nowISO8601();
-
-                fprintf(csv, "%s,%s,%s\n", t, targets[i].path, value);
-                fprintf(json, "{\"time\":\"%s\",\"tag\":\"%s\",\"value\":\"%s\"}\n",
-                        t, targets[i].path, value);
-
-                printf("%s | %s = %s\n", t, targets[i].path, value);
-            }
-            else {
-                printf("Read failed: %s\n", targets[i].path);
-            }
-
-            if (v) MmsValue_delete(v);
-        }
-
-        Sleep(POLL_INTERVAL_MS);
-    }
-
-    fclose(csv);
-    fclose(json);
-
-    IedConnection_close(con);
-    IedConnection_destroy(con);
-    return 0;
-}
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+#include "iec61850_client.h"
+#include "mms_client_connection.h"
+#include "mms_value.h"
+
+#include "clock.h"
+#include "lvtable.h"
+#include "mmsfmt.h"
+#include "tslog.h"
+
+#define MAX_IEDS 1024
+#define MAX_WORKERS 64
+#define LINE_SIZE 512
+/* Default poll period for targets without an interval column */
+#define POLL_INTERVAL_MS 1000
+
+/* How often missed deadlines are reported */
+#define STATS_INTERVAL_MS 10000
+
+/* Default IED for target lines without an address column */
+#define IED_IP   "10.10.6.100"
+#define IED_PORT 102
+
+#define CONNECT_TIMEOUT_MS 2000
+#define REQUEST_TIMEOUT_MS 3000
+#define RECONNECT_INTERVAL_MS 10000
+
+/* Bytes reserved in every MMS PDU for the confirmed-request/response framing */
+#define PDU_OVERHEAD 64
+
+/* Initial guess for the encoded size of a value we have not read yet */
+#define DEFAULT_VALUE_SIZE 32
+
+/* Asynchronous reads kept in flight per association */
+#define DEFAULT_WINDOW 8
+#define MAX_WINDOW 64
+
+/* Duration of each window size step of --sweep */
+#define SWEEP_STEP_MS 5000
+
+/* Nesting below the data object a coalesced target may have (e.g. "mag.f") */
+#define MAX_MEMBER_DEPTH 8
+
+/* Log records queued per poll worker (power of two) */
+#define LOG_RING_SIZE 4096
+
+/* Bytes collected per output file before one write */
+#define LOG_BUFFER_SIZE 65536
+
+/* How long a worker waits for room in its ring before dropping the value */
+#define LOG_BACKPRESSURE_MS 100
+
+/* Writer sleep when every ring is empty */
+#define LOG_IDLE_MS 10
+
+/* An unchanged value is logged again after this long (--heartbeat, hb=) */
+#define DEFAULT_HEARTBEAT_MS 600000
+
+/* Longest time samples wait in memory before a binary log block is written */
+#define TSL_BLOCK_MS 60000
+
+/* Default bounds of one binary log segment */
+#define TSL_SEGMENT_MB 256
+#define TSL_SEGMENT_MINUTES 60
+
+/* Latest value, quality and time of every target, mapped for local readers */
+#define LATEST_FILE "mms-latest.lvt"
+
+typedef enum {
+    READ_SINGLE,    /* one IedConnection_readObject per target */
+    READ_BATCHED,   /* one MMS Read per logical device, split by PDU size */
+    READ_ASYNC,     /* pipelined readObjectAsync, up to asyncWindow in flight */
+    READ_DATASET    /* one temporary data set per poll group, one read per cycle */
+} ReadMode;
+
+/* One outstanding asynchronous read */
+typedef struct {
+    uint32_t invokeId;      /* 0 when free; responses for other ids are stragglers */
+    int item;
+    double sentAt;
+
+    int done;
+    IedClientError err;
+    MmsValue* value;
+} AsyncSlot;
+
+/* One line of targets.txt: a tag that is logged */
+typedef struct {
+    int ied;            /* index into ieds[] */
+    int fc;
+    char path[256];
+    int intervalMs;
+
+    /* report by exception, see worthLogging */
+    double deadband;        /* db=: smallest change of an analog value that is logged */
+    double deadbandPct;     /* pct=: the same, in % of the last value logged */
+    int heartbeatMs;        /* hb=: an unchanged value is logged again after this long, 0 never */
+} Target;
+
+/* What goes on the wire: one target, or the data object enclosing several targets */
+typedef struct {
+    int ied;
+    int fc;
+    int intervalMs;
+    char path[256];
+
+    char domain[65];    /* MMS domain (logical device), e.g. "DCSRelay" */
+    char itemId[192];   /* MMS item, e.g. "VI1GGIO137$ST$SPCSO$stVal" */
+    int valueSize;      /* encoded size of the last value read */
+
+    int target;         /* single-target items; -1 for coalesced ones */
+    int firstMember;    /* coalesced items: members[firstMember .. firstMember + memberCount - 1] */
+    int memberCount;
+    MmsVariableSpecification* spec;     /* coalesced items: cached at the first connect */
+    int resolved;       /* coalesced items: checked against the IED's model (spec may still be NULL) */
+    int timeIndex;      /* coalesced items: element holding the data object's t, -1 if none */
+} ReadItem;
+
+/* A target served from a coalesced read, and where it sits in the structure */
+typedef struct {
+    int target;
+    int single;         /* stand-alone item used if the structure cannot be resolved */
+    int depth;          /* -1 until resolved from the variable specification */
+    int index[MAX_MEMBER_DEPTH];
+} Member;
+
+typedef struct {
+    char host[128];
+    int port;
+    char name[160];         /* "host:port", the ied column of the logs */
+
+    IedConnection con;
+    int connected;
+    double retryAt;         /* no reconnect attempt before this nowMs() */
+    int maxPduSize;
+
+    int targetCount;
+    int itemsResolved;              /* coalesced items checked against the IED's model */
+
+    /* asynchronous reads, guarded by asyncLock */
+    CRITICAL_SECTION asyncLock;
+    CONDITION_VARIABLE asyncDone;
+    AsyncSlot slots[MAX_WINDOW];
+    int window;                     /* asyncWindow limited by the negotiated outstanding calls */
+    double rttSum;
+    long rttCount;
+
+    /* guarded by schedLock */
+    int queued;                     /* in the job queue or being polled */
+    struct PollGroup* dueHead;      /* groups fired and waiting for this IED */
+    struct PollGroup* dueTail;
+} Ied;
+
+/* Targets of one IED sharing a poll interval; the unit the scheduler fires */
+typedef struct PollGroup {
+    int ied;
+    int intervalMs;
+    double deadline;        /* absolute nowMs() of the next read */
+
+    int* order;             /* item indexes sorted by domain, so a batch never spans two devices */
+    int itemCount;
+    int targetCount;
+    int* plan;              /* the items as built, coalesced ones included; order is made from it */
+    int planCount;
+
+    /* guarded by schedLock */
+    int pending;            /* fired, not yet polled */
+    double firedFor;        /* deadline of the pending poll */
+    struct PollGroup* nextDue;
+    long missed;            /* deadlines that passed while still pending */
+    long missedReported;
+    double maxLateness;     /* worst poll start behind its deadline since the last report */
+
+    /* READ_DATASET, only touched by the worker polling the group's IED */
+    char dataSetRef[32];    /* association specific ("@...") data set */
+    int dataSetState;       /* 0 not created on this association, 1 created, -1 refused */
+    ClientDataSet dataSet;  /* value buffer reused between cycles */
+} PollGroup;
+
+Target* targets = NULL;
+int targetCount = 0;
+int targetCapacity = 0;
+
+ReadItem* items = NULL;
+int itemCount = 0;
+
+Member* members = NULL;
+int memberCount = 0;
+
+Ied ieds[MAX_IEDS];
+int iedCount = 0;
+
+PollGroup* groups = NULL;
+int groupCount = 0;
+
+ReadMode readMode = READ_BATCHED;
+int asyncWindow = DEFAULT_WINDOW;
+
+/* --sweep measures throughput only, nothing is logged */
+int sweeping = 0;
+
+/* --quiet: no per-value console output */
+int quiet = 0;
+
+/* --all: log every value read, changed or not */
+int logEveryRead = 0;
+
+/* --heartbeat: hb= of targets that do not set it */
+int heartbeatMs = DEFAULT_HEARTBEAT_MS;
+
+/* Cleared by Ctrl-C (or closing the console): the scheduler stops, then the workers, then the writer */
+volatile LONG running = 1;
+volatile LONG writing = 1;
+
+/* Set with running = 0, wakes the scheduler; stopped is set once the logs are closed */
+HANDLE stopEvent;
+HANDLE stoppedEvent;
+
+/* ===================== Time ===================== */
+
+/* Log records are stamped with clockWallMs() (clock.h), deadlines use nowMs() */
+double nowMs()
+{
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER c;
+
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency(&freq);
+
+    QueryPerformanceCounter(&c);
+    return (double) c.QuadPart * 1000.0 / (double) freq.QuadPart;
+}
+
+/* ===================== FC Parsing ===================== */
+
+int parseFC(const char* s)
+{
+    if (strcmp(s, "ST") == 0) return IEC61850_FC_ST;
+    if (strcmp(s, "DC") == 0) return IEC61850_FC_DC;
+    if (strcmp(s, "MX") == 0) return IEC61850_FC_MX;
+    if (strcmp(s, "CO") == 0) return IEC61850_FC_CO;
+    if (strcmp(s, "SP") == 0) return IEC61850_FC_SP;
+    if (strcmp(s, "SV") == 0) return IEC61850_FC_SV;
+    if (strcmp(s, "EX") == 0) return IEC61850_FC_EX;
+
+    return IEC61850_FC_ST; /* default */
+}
+
+/* ===================== MMS Naming ===================== */
+
+/* "LD/LN.DO.DA" + FC -> domain "LD", item "LN$FC$DO$DA" */
+int toMmsName(ReadItem* t)
+{
+    const char* slash = strchr(t->path, '/');
+    if (!slash || (slash - t->path) >= (int) sizeof(t->domain))
+        return 0;
+
+    memcpy(t->domain, t->path, slash - t->path);
+    t->domain[slash - t->path] = 0;
+
+    const char* ln = slash + 1;
+    const char* dot = strchr(ln, '.');
+    int lnLen = dot ? (int) (dot - ln) : (int) strlen(ln);
+
+    int n = snprintf(t->itemId, sizeof(t->itemId), "%.*s$%s%s",
+                     lnLen, ln, FunctionalConstraint_toString(t->fc), dot ? dot : "");
+    if (n < 0 || n >= (int) sizeof(t->itemId))
+        return 0;
+
+    for (char* c = t->itemId; *c; c++)
+        if (*c == '.') *c = '$';
+
+    return 1;
+}
+
+/* ===================== IED Table ===================== */
+
+/* "host[:port]" -> index into ieds[], adding the IED on first use */
+int findOrAddIed(const char* address)
+{
+    char host[128];
+    int port = IED_PORT;
+
+    strncpy(host, address, sizeof(host) - 1);
+    host[sizeof(host) - 1] = 0;
+
+    char* colon = strchr(host, ':');
+    if (colon) {
+        *colon = 0;
+        port = atoi(colon + 1);
+    }
+
+    for (int i = 0; i < iedCount; i++)
+        if (ieds[i].port == port && strcmp(ieds[i].host, host) == 0)
+            return i;
+
+    if (iedCount >= MAX_IEDS)
+        return -1;
+
+    Ied* ied = &ieds[iedCount];
+    memset(ied, 0, sizeof(*ied));
+    strcpy(ied->host, host);
+    ied->port = port;
+    snprintf(ied->name, sizeof(ied->name), "%s:%d", host, port);
+
+    InitializeCriticalSection(&ied->asyncLock);
+    InitializeConditionVariable(&ied->asyncDone);
+
+    return iedCount++;
+}
+
+/* ===================== Target File Parsing ===================== */
+
+static char* trim(char* s)
+{
+    while (*s == ' ' || *s == '\t') s++;
+
+    char* end = s + strlen(s);
+    while (end > s && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r'))
+        *--end = 0;
+
+    return s;
+}
+
+/* "100ms", "2s", "5m", "1h" or plain milliseconds */
+int parseInterval(const char* s)
+{
+    char* unit;
+    double v = strtod(s, &unit);
+
+    while (*unit == ' ') unit++;
+
+    if (strcmp(unit, "s") == 0) v *= 1000;
+    else if (strcmp(unit, "m") == 0 || strcmp(unit, "min") == 0) v *= 60 * 1000;
+    else if (strcmp(unit, "h") == 0) v *= 3600 * 1000;
+
+    return v >= 1 ? (int) v : POLL_INTERVAL_MS;
+}
+
+/* An interval, or exactly "0" for no heartbeat ("0.5s" is 500 ms) */
+int parseHeartbeat(const char* s)
+{
+    return strcmp(s, "0") == 0 ? 0 : parseInterval(s);
+}
+
+/*
+ * One target per line:
+ *   [host[:port],] FC, LD/LN.DO.DA [, interval] [, db=x] [, pct=x] [, hb=interval]
+ * Without an address the default IED is used, without an interval POLL_INTERVAL_MS.
+ */
+void loadTargets(const char* filename, const char* defaultIed)
+{
+    FILE* f = fopen(filename, "r");
+    if (!f) {
+        printf("Cannot open %s\n", filename);
+        exit(1);
+    }
+
+    char line[LINE_SIZE];
+
+    while (fgets(line, sizeof(line), f)) {
+
+        char* p = strchr(line, '\n');
+        if (p) *p = 0;
+
+        if (strlen(line) < 5 || line[0] == '#') continue;
+
+        char* fields[8];
+        int n = 0;
+
+        fields[n++] = line;
+        for (char* c = line; *c && n < 8; c++) {
+            if (*c == ',') {
+                *c = 0;
+                fields[n++] = c + 1;
+            }
+        }
+
+        /* the object reference is the field with the '/', everything else is relative to it */
+        int pathField = -1;
+        for (int i = 1; i < n && pathField < 0; i++)
+            if (strchr(fields[i], '/')) pathField = i;
+
+        if (pathField < 1 || pathField > 2) continue;
+
+        const char* iedStr = (pathField == 2) ? trim(fields[0]) : defaultIed;
+        char* fcStr = trim(fields[pathField - 1]);
+        char* pathStr = trim(fields[pathField]);
+        int intervalMs = POLL_INTERVAL_MS;
+        double deadband = 0, deadbandPct = 0;
+        int heartbeat = heartbeatMs;
+
+        /* after the reference: the interval and key=value options, in any order */
+        for (int i = pathField + 1; i < n; i++) {
+            char* field = trim(fields[i]);
+
+            if (strncmp(field, "db=", 3) == 0)
+                deadband = atof(field + 3);
+            else if (strncmp(field, "pct=", 4) == 0)
+                deadbandPct = atof(field + 4);
+            else if (strncmp(field, "hb=", 3) == 0)
+                heartbeat = parseHeartbeat(trim(field + 3));
+            else if (strchr(field, '='))
+                printf("Unknown option %s: %s\n", field, pathStr);
+            else if (field[0])
+                intervalMs = parseInterval(field);
+        }
+
+        /* before the IED is registered: a malformed line must not add one */
+        const char* ln = strchr(pathStr, '/');
+        if (!ln || ln == pathStr || !ln[1]) {
+            printf("Invalid object reference: %s\n", pathStr);
+            continue;
+        }
+
+        int ied = findOrAddIed(iedStr);
+        if (ied < 0) {
+            printf("Too many IEDs, ignoring %s\n", iedStr);
+            continue;
+        }
+
+        if (targetCount == targetCapacity) {
+            targetCapacity = targetCapacity ? targetCapacity * 2 : 256;
+            targets = realloc(targets, targetCapacity * sizeof(Target));
+        }
+
+        Target* t = &targets[targetCount];
+        memset(t, 0, sizeof(*t));
+
+        t->ied = ied;
+        t->fc = parseFC(fcStr);
+        strncpy(t->path, pathStr, sizeof(t->path) - 1);
+        t->intervalMs = intervalMs;
+        t->deadband = deadband;
+        t->deadbandPct = deadbandPct;
+        t->heartbeatMs = heartbeat;
+
+        targetCount++;
+    }
+
+    fclose(f);
+
+    printf("Loaded %d targets on %d IEDs\n", targetCount, iedCount);
+}
+
+/* ===================== Read Items ===================== */
+
+/* Length of the "LD/LN.DO" prefix of a reference below a data object, 0 if there is none */
+static int dataObjectPrefix(const char* path)
+{
+    const char* ln = strchr(path, '/');
+    const char* doName = ln ? strchr(ln, '.') : NULL;
+    const char* below = doName ? strchr(doName + 1, '.') : NULL;
+
+    return below ? (int) (below - path) : 0;
+}
+
+/* Same IED, FC and interval, then same enclosing data object */
+static int compareCoalesceKey(const void* a, const void* b)
+{
+    const Target* ta = &targets[*(const int*) a];
+    const Target* tb = &targets[*(const int*) b];
+
+    if (ta->ied != tb->ied) return ta->ied - tb->ied;
+    if (ta->fc != tb->fc) return ta->fc - tb->fc;
+    if (ta->intervalMs != tb->intervalMs) return ta->intervalMs < tb->intervalMs ? -1 : 1;
+
+    int la = dataObjectPrefix(ta->path);
+    int lb = dataObjectPrefix(tb->path);
+    int c = strncmp(ta->path, tb->path, la < lb ? la : lb);
+
+    if (c == 0) c = la - lb;
+    return c ? c : *(const int*) a - *(const int*) b;
+}
+
+static int sameDataObject(const Target* a, const Target* b)
+{
+    int la = dataObjectPrefix(a->path);
+
+    return la > 0 && a->ied == b->ied && a->fc == b->fc && a->intervalMs == b->intervalMs
+        && la == dataObjectPrefix(b->path) && strncmp(a->path, b->path, la) == 0;
+}
+
+static int addItem(const Target* t, int pathLen, int target)
+{
+    ReadItem* item = &items[itemCount];
+    memset(item, 0, sizeof(*item));
+
+    item->ied = t->ied;
+    item->fc = t->fc;
+    item->intervalMs = t->intervalMs;
+    memcpy(item->path, t->path, pathLen);
+    item->valueSize = DEFAULT_VALUE_SIZE;
+    item->target = target;
+    item->timeIndex = -1;
+
+    if (!toMmsName(item)) {
+        printf("Invalid object reference: %s\n", t->path);
+        return -1;
+    }
+
+    return itemCount++;
+}
+
+/*
+ * Targets below the same data object (e.g. SPCSO.stVal, .q and .t) become one
+ * read of the data object; the stand-alone items of its members are kept aside
+ * in case the IED's model does not resolve. Returns a list of the items to poll.
+ */
+int* buildReadItems(int* pollCount)
+{
+    int* order = malloc((targetCount + 1) * sizeof(int));
+    int* poll = malloc((targetCount + 1) * sizeof(int));
+    int n = 0;
+
+    items = calloc(2 * targetCount + 1, sizeof(ReadItem));
+    members = calloc(targetCount + 1, sizeof(Member));
+
+    for (int i = 0; i < targetCount; i++)
+        order[i] = i;
+
+    qsort(order, targetCount, sizeof(int), compareCoalesceKey);
+
+    for (int i = 0; i < targetCount; ) {
+        Target* t = &targets[order[i]];
+        int run = 1;
+
+        while (i + run < targetCount && sameDataObject(t, &targets[order[i + run]]))
+            run++;
+
+        if (run == 1) {
+            int item = addItem(t, (int) strlen(t->path), order[i]);
+            if (item >= 0) poll[n++] = item;
+            i++;
+            continue;
+        }
+
+        int parent = addItem(t, dataObjectPrefix(t->path), -1);
+        if (parent < 0) {
+            i += run;
+            continue;
+        }
+
+        items[parent].firstMember = memberCount;
+        poll[n++] = parent;
+
+        for (int k = 0; k < run; k++, i++) {
+            Member* m = &members[memberCount];
+
+            m->target = order[i];
+            m->single = addItem(&targets[order[i]], (int) strlen(targets[order[i]].path), order[i]);
+            m->depth = -1;
+
+            if (m->single >= 0) {
+                memberCount++;
+                items[parent].memberCount++;
+            }
+        }
+    }
+
+    free(order);
+
+    printf("%d targets coalesced into %d reads\n", targetCount, n);
+
+    *pollCount = n;
+    return poll;
+}
+
+/* IED, then interval, then logical device */
+static int compareGroupKey(const void* a, const void* b)
+{
+    const ReadItem* ta = &items[*(const int*) a];
+    const ReadItem* tb = &items[*(const int*) b];
+
+    if (ta->ied != tb->ied) return ta->ied - tb->ied;
+    if (ta->intervalMs != tb->intervalMs) return ta->intervalMs < tb->intervalMs ? -1 : 1;
+
+    int c = strcmp(ta->domain, tb->domain);
+    return c ? c : *(const int*) a - *(const int*) b;
+}
+
+static int itemTargets(const ReadItem* item)
+{
+    return item->target >= 0 ? 1 : item->memberCount;
+}
+
+/* Split the read items into one poll group per (IED, interval) */
+void buildPollGroups()
+{
+    int pollCount;
+    int* poll = buildReadItems(&pollCount);
+
+    qsort(poll, pollCount, sizeof(int), compareGroupKey);
+
+    groups = calloc(pollCount + 1, sizeof(PollGroup));
+
+    for (int i = 0; i < pollCount; i++) {
+        ReadItem* item = &items[poll[i]];
+        PollGroup* g = groupCount ? &groups[groupCount - 1] : NULL;
+
+        if (!g || g->ied != item->ied || g->intervalMs != item->intervalMs) {
+            g = &groups[groupCount++];
+            g->ied = item->ied;
+            g->intervalMs = item->intervalMs;
+            g->order = &poll[i];
+        }
+
+        g->itemCount++;
+        g->targetCount += itemTargets(item);
+        ieds[item->ied].targetCount += itemTargets(item);
+    }
+
+    /* own order arrays, with room for members that fall back to stand-alone reads */
+    for (int i = 0; i < groupCount; i++) {
+        PollGroup* g = &groups[i];
+        int* order = malloc((g->targetCount + 1) * sizeof(int));
+
+        g->plan = malloc((g->itemCount + 1) * sizeof(int));
+        g->planCount = g->itemCount;
+        memcpy(g->plan, g->order, g->itemCount * sizeof(int));
+
+        memcpy(order, g->order, g->itemCount * sizeof(int));
+        g->order = order;
+    }
+
+    free(poll);
+
+    printf("%d poll groups\n", groupCount);
+}
+
+/* Locate every member inside the data object using its variable specification */
+static int resolveMembers(ReadItem* item)
+{
+    int resolved = 0;
+
+    /* the data object's own time stamp comes with every read, listed or not */
+    if (MmsVariableSpecification_getType(item->spec) == MMS_STRUCTURE) {
+        for (int c = 0; c < MmsVariableSpecification_getSize(item->spec); c++) {
+            MmsVariableSpecification* s = MmsVariableSpecification_getChildSpecificationByIndex(item->spec, c);
+
+            if (strcmp(MmsVariableSpecification_getName(s), "t") == 0
+                    && MmsVariableSpecification_getType(s) == MMS_UTC_TIME)
+                item->timeIndex = c;
+        }
+    }
+
+    for (int k = 0; k < item->memberCount; k++) {
+        Member* m = &members[item->firstMember + k];
+        char rest[256];
+
+        strcpy(rest, targets[m->target].path + strlen(item->path) + 1);
+
+        MmsVariableSpecification* spec = item->spec;
+        int depth = 0;
+
+        for (char* name = rest; name && spec; ) {
+            MmsVariableSpecification* child = NULL;
+            char* next = strchr(name, '.');
+
+            if (next) *next++ = '\0';
+
+            if (depth < MAX_MEMBER_DEPTH && MmsVariableSpecification_getType(spec) == MMS_STRUCTURE) {
+                for (int c = 0; c < MmsVariableSpecification_getSize(spec); c++) {
+                    MmsVariableSpecification* s = MmsVariableSpecification_getChildSpecificationByIndex(spec, c);
+
+                    if (strcmp(MmsVariableSpecification_getName(s), name) == 0) {
+                        m->index[depth++] = c;
+                        child = s;
+                        break;
+                    }
+                }
+            }
+
+            spec = child;
+            name = next;
+        }
+
+        m->depth = spec ? depth : -1;
+        if (spec) resolved++;
+    }
+
+    return resolved;
+}
+
+/* The IED may describe the object on the next association */
+static int transientError(IedClientError err)
+{
+    return err == IED_ERROR_TIMEOUT || err == IED_ERROR_CONNECTION_LOST || err == IED_ERROR_NOT_CONNECTED;
+}
+
+/*
+ * Runs on every association until it succeeds for all of the IED's coalesced
+ * data objects: fetch their variable specifications. Members that cannot be
+ * located, or all members of an object the IED does not describe, go back to
+ * stand-alone reads; so do the members of an object whose specification could
+ * not be fetched this time (timeout, association lost), until a later connect.
+ */
+void resolveCoalescedItems(Ied* ied)
+{
+    if (ied->itemsResolved)
+        return;
+
+    int pending = 0;
+
+    for (int i = 0; i < groupCount; i++) {
+        PollGroup* g = &groups[i];
+
+        if (&ieds[g->ied] != ied)
+            continue;
+
+        int n = 0;
+
+        for (int k = 0; k < g->planCount; k++) {
+            ReadItem* item = &items[g->plan[k]];
+
+            if (item->target >= 0) {
+                g->order[n++] = g->plan[k];
+                continue;
+            }
+
+            if (!item->resolved) {
+                IedClientError err;
+                item->spec = IedConnection_getVariableSpecification(ied->con, &err, item->path, item->fc);
+
+                if (item->spec && err == IED_ERROR_OK) {
+                    int resolved = resolveMembers(item);
+
+                    if (resolved < item->memberCount)
+                        printf("Coalesced read %s: %d of %d members resolved\n",
+                               item->path, resolved, item->memberCount);
+                }
+                else {
+                    if (item->spec) MmsVariableSpecification_destroy(item->spec);
+                    item->spec = NULL;
+
+                    printf("Coalesced read %s: no variable specification (%d)%s\n", item->path, err,
+                           transientError(err) ? ", retried on the next connect" : "");
+                }
+
+                item->resolved = item->spec || !transientError(err);
+                pending |= !item->resolved;
+            }
+
+            int resolved = 0;
+
+            for (int m = 0; m < item->memberCount; m++) {
+                if (members[item->firstMember + m].depth < 0)
+                    g->order[n++] = members[item->firstMember + m].single;
+                else
+                    resolved++;
+            }
+
+            if (resolved > 0)
+                g->order[n++] = g->plan[k];
+        }
+
+        qsort(g->order, n, sizeof(int), compareGroupKey);
+        g->itemCount = n;
+    }
+
+    ied->itemsResolved = !pending;
+}
+
+/* ===================== MMS VALUE TO STRING ===================== */
+
+void mmsToText(MmsValue* v, char* out, int outLen)
+{
+    *fmtMmsValue(out, out + outLen, v) = 0;
+}
+
+/* ===================== Logging ===================== */
+
+/*
+ * Workers do not format or write: every value is copied into a fixed-size
+ * record on the worker's own ring, and the writer thread turns the records
+ * into CSV, JSON and console lines and writes them in large blocks.
+ */
+typedef struct {
+    int target;
+    int64_t sourceMs;   /* t of the data object as sent by the IED, 0 if not read */
+    TsSample sample;    /* sample.timeMs: when the value was received */
+} LogRecord;
+
+/* Single producer (one poll worker), single consumer (the writer thread) */
+typedef struct {
+    LogRecord records[LOG_RING_SIZE];
+    volatile ULONG head;    /* next record the worker fills */
+    volatile ULONG tail;    /* next record the writer takes */
+
+    volatile LONG stalls;   /* values that had to wait for room (written by the worker) */
+    volatile LONG dropped;  /* values given up after LOG_BACKPRESSURE_MS (written by the worker) */
+    volatile LONG unchanged;    /* values not logged, within the deadband (written by the worker) */
+    volatile LONG failed;   /* reads without a value, see readFailed (written by the worker) */
+    long long written;      /* written by the writer */
+} LogRing;
+
+LogRing* rings = NULL;
+int ringCount = 0;
+
+/* The ring of the calling poll worker; NULL on other threads */
+static __thread LogRing* logRing = NULL;
+
+FILE* csv;
+FILE* json;
+TsLogWriter* tsl;
+
+/*
+ * The last value logged per target, kept in 24 bytes so the comparison
+ * touches no text. Only the worker polling the target's IED uses it, and
+ * an IED is polled by one worker at a time.
+ */
+typedef struct {
+    int64_t timeMs;         /* 0 before the first value */
+    union {
+        double real;
+        int64_t integer;    /* also booleans, bit strings, times and the hash of text */
+    } value;
+    TsKind kind;
+} LastLogged;
+
+LastLogged* lastLogged = NULL;
+
+/* FNV-1a */
+static int64_t textHash(const char* s)
+{
+    uint64_t h = 14695981039346656037ULL;
+
+    while (*s)
+        h = (h ^ (uint8_t) *s++) * 1099511628211ULL;
+
+    return (int64_t) h;
+}
+
+/* What LastLogged.value.integer compares for the kinds without a deadband */
+static int64_t sampleKey(const TsSample* s)
+{
+    switch (s->kind) {
+    case TS_BOOLEAN:  return s->value.boolean;
+    case TS_INTEGER:  return s->value.integer;
+    case TS_UTC_TIME: return s->value.utcMs;
+    case TS_BITS:     return ((int64_t) s->bitSize << 32) | s->value.bits;
+    case TS_TEXT:     return textHash(s->value.text);
+    default:          return 0;
+    }
+}
+
+/*
+ * Report by exception: analog values (FLOAT, INTEGER) pass once they moved
+ * by db= or pct= from the last value logged, everything else (status,
+ * quality, time, text) on any change. An unchanged value passes after hb=.
+ * Only checks: the value becomes the last one logged once it is queued.
+ */
+static int worthLogging(const Target* t, const TsSample* s, int64_t key)
+{
+    const LastLogged* last = &lastLogged[t - targets];
+    int changed;
+
+    if (logEveryRead || last->timeMs == 0 || last->kind != s->kind)
+        changed = 1;
+    else if (t->heartbeatMs > 0 && s->timeMs - last->timeMs >= t->heartbeatMs)
+        changed = 1;
+    else if (s->kind == TS_FLOAT || (s->kind == TS_INTEGER && (t->deadband > 0 || t->deadbandPct > 0))) {
+        double now = s->kind == TS_FLOAT ? s->value.real : (double) s->value.integer;
+        double was = s->kind == TS_FLOAT ? last->value.real : (double) last->value.integer;
+        double delta = fabs(now - was);
+
+        if (delta != delta)     /* NaN on either side */
+            changed = memcmp(&now, &was, sizeof(now)) != 0;
+        else
+            changed = delta > 0 && delta >= t->deadband && delta >= t->deadbandPct / 100.0 * fabs(was);
+    }
+    else
+        changed = key != last->value.integer;
+
+    return changed;
+}
+
+/* A dropped record leaves the previous value as the reference, so the change is logged later */
+static void rememberLogged(const Target* t, const TsSample* s, int64_t key)
+{
+    LastLogged* last = &lastLogged[t - targets];
+
+    last->timeMs = s->timeMs;
+    last->kind = s->kind;
+
+    if (s->kind == TS_FLOAT)
+        last->value.real = s->value.real;
+    else
+        last->value.integer = key;
+}
+
+/* ===================== Latest Values ===================== */
+
+typedef enum {
+    ROLE_VALUE,
+    ROLE_QUALITY,       /* "...q": quality of the other targets of its data object */
+    ROLE_TIME           /* "...t": source time of the other targets of its data object */
+} LatestRole;
+
+/* Targets of one data object are latestOrder[first .. last - 1] */
+typedef struct {
+    LatestRole role;
+    int first;
+    int last;
+} LatestLink;
+
+LvTable* latest = NULL;
+LatestLink* latestLinks = NULL;
+int* latestOrder = NULL;
+
+static LatestRole attributeRole(const char* path)
+{
+    const char* name = strrchr(path, '.');
+
+    if (name && dataObjectPrefix(path) > 0) {
+        if (strcmp(name, ".q") == 0) return ROLE_QUALITY;
+        if (strcmp(name, ".t") == 0) return ROLE_TIME;
+    }
+
+    return ROLE_VALUE;
+}
+
+/* Same IED, then same enclosing data object, whatever the FC or interval */
+static int compareDataObject(const void* a, const void* b)
+{
+    const Target* ta = &targets[*(const int*) a];
+    const Target* tb = &targets[*(const int*) b];
+
+    if (ta->ied != tb->ied) return ta->ied - tb->ied;
+
+    int la = dataObjectPrefix(ta->path);
+    int lb = dataObjectPrefix(tb->path);
+    int c = strncmp(ta->path, tb->path, la < lb ? la : lb);
+
+    if (c == 0) c = la - lb;
+    return c ? c : *(const int*) a - *(const int*) b;
+}
+
+void createLatestTable(const char* fileName)
+{
+    latest = lvCreate(fileName, targetCount);
+    if (!latest)
+        return;
+
+    latestLinks = calloc(targetCount, sizeof(LatestLink));
+    latestOrder = malloc(targetCount * sizeof(int));
+
+    for (int i = 0; i < targetCount; i++) {
+        const Target* t = &targets[i];
+
+        lvSetTag(latest, i, ieds[t->ied].name, t->path);
+
+        latestOrder[i] = i;
+    }
+
+    qsort(latestOrder, targetCount, sizeof(int), compareDataObject);
+
+    for (int first = 0, last; first < targetCount; first = last) {
+        const Target* t = &targets[latestOrder[first]];
+        int la = dataObjectPrefix(t->path);
+
+        for (last = first + 1; last < targetCount; last++) {
+            const Target* o = &targets[latestOrder[last]];
+
+            if (la == 0 || o->ied != t->ied || dataObjectPrefix(o->path) != la
+                    || strncmp(o->path, t->path, la) != 0)
+                break;
+        }
+
+        for (int k = first; k < last; k++) {
+            LatestLink* l = &latestLinks[latestOrder[k]];
+
+            l->role = attributeRole(targets[latestOrder[k]].path);
+            l->first = first;
+            l->last = last;
+        }
+    }
+
+    printf("Latest values: %s, %d slots\n", fileName, targetCount);
+}
+
+/*
+ * Called by the worker polling the target's IED. The slots of an IED (and
+ * the value slots its q and t are linked to, same IED) are only written by
+ * that worker, and an IED is polled by one worker at a time, so every slot
+ * still has a single writer.
+ */
+static void updateLatest(const LogRecord* r)
+{
+    const LatestLink* l = &latestLinks[r->target];
+
+    lvWriteValue(latest, r->target, &r->sample);
+
+    if (r->sourceMs)
+        lvWriteSourceTime(latest, r->target, r->sourceMs);
+
+    if (l->role == ROLE_VALUE)
+        return;
+
+    for (int k = l->first; k < l->last; k++) {
+        int target = latestOrder[k];
+
+        if (latestLinks[target].role != ROLE_VALUE)
+            continue;
+
+        if (l->role == ROLE_QUALITY && r->sample.kind == TS_BITS)
+            lvWriteQuality(latest, target, r->sample.value.bits, r->sample.bitSize);
+        else if (l->role == ROLE_TIME && r->sample.kind == TS_UTC_TIME)
+            lvWriteSourceTime(latest, target, r->sample.value.utcMs);
+    }
+}
+
+/* Refresh the target's latest value and queue the record for the writer if it is worth logging */
+void logValue(Target* t, MmsValue* v, int64_t sourceMs)
+{
+    LogRing* ring = logRing;
+
+    if (sweeping || !ring)
+        return;
+
+    /* the record is built aside and only queued if the value changed */
+    LogRecord record;
+    LogRecord* r = &record;
+
+    r->target = (int) (t - targets);
+    r->sourceMs = sourceMs;
+
+    TsSample* s = &r->sample;
+    s->timeMs = clockWallMs();
+
+    switch (v ? MmsValue_getType(v) : MMS_DATA_ACCESS_ERROR) {
+
+    case MMS_BOOLEAN:
+        s->kind = TS_BOOLEAN;
+        s->value.boolean = MmsValue_getBoolean(v);
+        break;
+
+    case MMS_INTEGER:
+    case MMS_UNSIGNED:
+        s->kind = TS_INTEGER;
+        s->value.integer = MmsValue_toInt64(v);
+        break;
+
+    case MMS_FLOAT:
+        s->kind = TS_FLOAT;
+        s->value.real = MmsValue_toDouble(v);
+        break;
+
+    case MMS_UTC_TIME:
+        s->kind = TS_UTC_TIME;
+        s->value.utcMs = (int64_t) MmsValue_getUtcTimeInMs(v);
+        break;
+
+    case MMS_BIT_STRING:
+        if (MmsValue_getBitStringSize(v) <= 32) {
+            s->kind = TS_BITS;
+            s->bitSize = MmsValue_getBitStringSize(v);
+            s->value.bits = MmsValue_getBitStringAsInteger(v);
+            break;
+        }
+        /* fall through */
+
+    default:
+        s->kind = TS_TEXT;
+        mmsToText(v, s->value.text, TS_TEXT_SIZE);
+        break;
+    }
+
+    /* the latest value is refreshed on every read, also within the deadband */
+    if (latest)
+        updateLatest(r);
+
+    int64_t key = sampleKey(s);
+
+    if (!worthLogging(t, s, key)) {
+        ring->unchanged++;
+        return;
+    }
+
+    ULONG head = ring->head;
+
+    if (head - ring->tail == LOG_RING_SIZE) {
+        /* writer is behind: hold this worker back briefly, then drop */
+        double giveUp = nowMs() + LOG_BACKPRESSURE_MS;
+
+        ring->stalls++;
+
+        while (head - ring->tail == LOG_RING_SIZE) {
+            if (nowMs() > giveUp) {
+                ring->dropped++;
+                return;
+            }
+            Sleep(1);
+        }
+    }
+
+    ring->records[head & (LOG_RING_SIZE - 1)] = record;
+
+    /* publish the record only after it is complete */
+    MemoryBarrier();
+    ring->head = head + 1;
+
+    rememberLogged(t, s, key);
+}
+
+/* Counted for the stats line; printed per value only without --quiet */
+static void readFailed(const char* path, int err)
+{
+    if (logRing)
+        logRing->failed++;
+
+    if (quiet)
+        return;
+
+    if (err)
+        printf("Read failed: %s (%d)\n", path, err);
+    else
+        printf("Read failed: %s\n", path);
+}
+
+/* ===================== Log Writer ===================== */
+
+typedef struct {
+    FILE* file;
+    int used;
+    char data[LOG_BUFFER_SIZE];
+} LogBuffer;
+
+static void flushLogBuffer(LogBuffer* b)
+{
+    if (b->used > 0)
+        fwrite(b->data, 1, b->used, b->file);
+
+    b->used = 0;
+}
+
+/* Room for one line is always kept, so formatting never truncates */
+static char* reserveLine(LogBuffer* b)
+{
+    if (LOG_BUFFER_SIZE - b->used < 2 * LINE_SIZE)
+        flushLogBuffer(b);
+
+    return b->data + b->used;
+}
+
+static void reportLogStats()
+{
+    long long written = 0;
+    long stalls = 0;
+    long dropped = 0;
+    long unchanged = 0;
+    long failed = 0;
+
+    for (int i = 0; i < ringCount; i++) {
+        written += rings[i].written;
+        stalls += rings[i].stalls;
+        dropped += rings[i].dropped;
+        unchanged += rings[i].unchanged;
+        failed += rings[i].failed;
+    }
+
+    printf("Log writer: %lld values written, %ld unchanged, %ld stalls, %ld dropped, %ld read failures, binary log %lld bytes\n",
+           written, unchanged, stalls, dropped, failed, tsLogBytesWritten(tsl));
+}
+
+DWORD WINAPI logWriter(LPVOID param)
+{
+    (void) param;
+
+    static LogBuffer csvOut, jsonOut, consoleOut;
+
+    csvOut.file = csv;
+    jsonOut.file = json;
+    consoleOut.file = stdout;
+
+    double nextStats = nowMs() + STATS_INTERVAL_MS;
+    double nextBlock = nowMs() + TSL_BLOCK_MS;
+    double nextResync = nowMs() + CLOCK_RESYNC_MS;
+
+    while (1) {
+        int drained = 0;
+
+        /* the workers are joined before writing is cleared, so one more pass empties the rings */
+        int last = !writing;
+
+        for (int i = 0; i < ringCount; i++) {
+            LogRing* ring = &rings[i];
+
+            ULONG tail = ring->tail;
+            ULONG head = ring->head;
+            MemoryBarrier();
+
+            for (; tail != head; tail++) {
+                const LogRecord* r = &ring->records[tail & (LOG_RING_SIZE - 1)];
+                const Target* t = &targets[r->target];
+
+                /* fmtTime only rebuilds the date and time when the second changes */
+                char ts[32], source[32] = "";
+                *fmtTime(ts, ts + sizeof(ts), r->sample.timeMs, 1) = 0;
+
+                if (r->sourceMs)
+                    *fmtTime(source, source + sizeof(source), r->sourceMs, 1) = 0;
+
+                char value[TS_TEXT_SIZE + 32];
+                tsFormatValue(&r->sample, value, sizeof(value));
+
+                tsLogAppend(tsl, r->target, ieds[t->ied].name, t->path, &r->sample);
+
+                /* the lines are pieced together, no format string is parsed per value */
+                char* line = reserveLine(&csvOut);
+                char* end = line + 2 * LINE_SIZE;
+                char* p = fmtText(line, end, ts);
+                p = fmtText(p, end, ",");
+                p = fmtText(p, end, ieds[t->ied].name);
+                p = fmtText(p, end, ",");
+                p = fmtText(p, end, t->path);
+                p = fmtText(p, end, ",");
+                p = fmtText(p, end, value);
+                p = fmtText(p, end, ",");
+                p = fmtText(p, end, source);
+                p = fmtText(p, end, "\n");
+                csvOut.used += (int) (p - line);
+
+                line = reserveLine(&jsonOut);
+                end = line + 2 * LINE_SIZE;
+                p = fmtText(line, end, "{\"time\":\"");
+                p = fmtText(p, end, ts);
+                p = fmtText(p, end, "\",\"ied\":\"");
+                p = fmtText(p, end, ieds[t->ied].name);
+                p = fmtText(p, end, "\",\"tag\":\"");
+                p = fmtText(p, end, t->path);
+                p = fmtText(p, end, "\",\"value\":\"");
+                p = fmtText(p, end, value);
+                if (r->sourceMs) {
+                    p = fmtText(p, end, "\",\"t\":\"");
+                    p = fmtText(p, end, source);
+                }
+                p = fmtText(p, end, "\"}\n");
+                jsonOut.used += (int) (p - line);
+
+                if (!quiet) {
+                    line = reserveLine(&consoleOut);
+                    end = line + 2 * LINE_SIZE;
+                    p = fmtText(line, end, ts);
+                    p = fmtText(p, end, " | ");
+                    p = fmtText(p, end, ieds[t->ied].host);
+                    p = fmtText(p, end, " | ");
+                    p = fmtText(p, end, t->path);
+                    p = fmtText(p, end, " = ");
+                    p = fmtText(p, end, value);
+                    if (r->sourceMs) {
+                        p = fmtText(p, end, " (t ");
+                        p = fmtText(p, end, source);
+                        p = fmtText(p, end, ")");
+                    }
+                    p = fmtText(p, end, "\n");
+                    consoleOut.used += (int) (p - line);
+                }
+
+                ring->written++;
+                drained++;
+            }
+
+            /* the records are copied into the buffers, hand the slots back */
+            MemoryBarrier();
+            ring->tail = tail;
+        }
+
+        if (drained > 0) {
+            flushLogBuffer(&csvOut);
+            flushLogBuffer(&jsonOut);
+            flushLogBuffer(&consoleOut);
+        }
+        else if (last) {
+            break;
+        }
+        else {
+            Sleep(LOG_IDLE_MS);
+        }
+
+        if (nowMs() >= nextBlock) {
+            tsLogFlush(tsl);
+            nextBlock += TSL_BLOCK_MS;
+        }
+
+        if (nowMs() >= nextStats) {
+            reportLogStats();
+            nextStats += STATS_INTERVAL_MS;
+        }
+
+        if (nowMs() >= nextResync) {
+            clockResync();
+            nextResync += CLOCK_RESYNC_MS;
+        }
+    }
+
+    reportLogStats();
+
+    return 0;
+}
+
+/* Log the value of a read item; a coalesced one fans out to the targets it covers */
+void deliverItem(ReadItem* item, MmsValue* v)
+{
+    if (item->target >= 0) {
+        logValue(&targets[item->target], v, 0);
+        return;
+    }
+
+    int64_t sourceMs = 0;
+
+    if (item->timeIndex >= 0 && v && MmsValue_getType(v) == MMS_STRUCTURE) {
+        MmsValue* t = MmsValue_getElement(v, item->timeIndex);
+
+        if (t && MmsValue_getType(t) == MMS_UTC_TIME)
+            sourceMs = (int64_t) MmsValue_getUtcTimeInMs(t);
+    }
+
+    for (int k = 0; k < item->memberCount; k++) {
+        Member* m = &members[item->firstMember + k];
+
+        if (m->depth < 0)
+            continue;
+
+        MmsValue* element = v;
+        for (int d = 0; d < m->depth && element; d++)
+            element = MmsValue_getType(element) == MMS_STRUCTURE ? MmsValue_getElement(element, m->index[d]) : NULL;
+
+        if (element)
+            logValue(&targets[m->target], element, sourceMs);
+        else
+            readFailed(targets[m->target].path, 0);
+    }
+}
+
+/* ===================== Single Reads ===================== */
+
+int readSingle(IedConnection con, ReadItem* t)
+{
+    IedClientError err;
+
+    MmsValue* v = IedConnection_readObject(con, &err, t->path, t->fc);
+
+    if (v && err == IED_ERROR_OK) {
+        /* learned here too: an item read singly after a batch failed is packed by its real size next cycle */
+        t->valueSize = MmsValue_encodeMmsData(v, NULL, 0, false);
+        deliverItem(t, v);
+    }
+    else
+        readFailed(t->path, err);
+
+    if (v) MmsValue_delete(v);
+
+    return 1;
+}
+
+/* ===================== Batched Reads ===================== */
+
+/* Approximate encoded cost of one item in the request and in the response */
+static int itemCost(ReadItem* t)
+{
+    int request = (int) strlen(t->itemId) + 8;
+    return request > t->valueSize ? request : t->valueSize;
+}
+
+/* The IED could not fit the response in one PDU */
+static int tooLarge(MmsError err)
+{
+    return err == MMS_ERROR_RESOURCE_OTHER || err == MMS_ERROR_RESOURCE_CAPABILITY_UNAVAILABLE;
+}
+
+/* One MMS Read for g->order[first .. first+count-1], all in the same domain */
+static int readBatch(Ied* ied, PollGroup* g, int first, int count)
+{
+    MmsConnection mms = IedConnection_getMmsConnection(ied->con);
+    MmsError mmsErr = MMS_ERROR_NONE;
+
+    LinkedList names = LinkedList_create();
+
+    for (int i = 0; i < count; i++)
+        LinkedList_add(names, items[g->order[first + i]].itemId);
+
+    MmsValue* result = MmsConnection_readMultipleVariables(mms, &mmsErr,
+            items[g->order[first]].domain, names);
+
+    LinkedList_destroyStatic(names);
+
+    if (!result || mmsErr != MMS_ERROR_NONE || MmsValue_getType(result) != MMS_ARRAY
+            || (int) MmsValue_getArraySize(result) != count) {
+
+        if (result) MmsValue_delete(result);
+
+        /* response exceeded the PDU size: halve the batch, the halves learn their sizes */
+        if (count > 1 && tooLarge(mmsErr)) {
+            int half = count / 2;
+            return 1 + readBatch(ied, g, first, half) + readBatch(ied, g, first + half, count - half);
+        }
+
+        /* anything else: fall back for this batch only */
+        if (!quiet)
+            printf("Batch read failed (%s, %d items): %d, reading singly\n",
+               items[g->order[first]].domain, count, mmsErr);
+
+        int requests = 1;
+        for (int i = 0; i < count; i++)
+            requests += readSingle(ied->con, &items[g->order[first + i]]);
+
+        return requests;
+    }
+
+    for (int i = 0; i < count; i++) {
+        ReadItem* t = &items[g->order[first + i]];
+        MmsValue* v = MmsValue_getElement(result, i);
+
+        if (v && MmsValue_getType(v) != MMS_DATA_ACCESS_ERROR) {
+            t->valueSize = MmsValue_encodeMmsData(v, NULL, 0, false);
+            deliverItem(t, v);
+        }
+        else {
+            readFailed(t->path, 0);
+        }
+    }
+
+    MmsValue_delete(result);
+
+    return 1;
+}
+
+/* Group targets by logical device and pack each group into as few reads as the PDU allows */
+int readAllBatched(Ied* ied, PollGroup* g)
+{
+    int budget = ied->maxPduSize - PDU_OVERHEAD;
+    int requests = 0;
+    int first = 0;
+
+    while (first < g->itemCount) {
+
+        const char* domain = items[g->order[first]].domain;
+        int used = itemCost(&items[g->order[first]]);
+        int count = 1;
+
+        while (first + count < g->itemCount) {
+            ReadItem* next = &items[g->order[first + count]];
+
+            if (strcmp(next->domain, domain) != 0)
+                break;
+
+            if (used + itemCost(next) > budget)
+                break;
+
+            used += itemCost(next);
+            count++;
+        }
+
+        requests += readBatch(ied, g, first, count);
+        first += count;
+    }
+
+    return requests;
+}
+
+/* ===================== Pipelined Async Reads ===================== */
+
+/* Runs on the connection's receive thread */
+static void asyncReadHandler(uint32_t invokeId, void* parameter, IedClientError err, MmsValue* value)
+{
+    Ied* ied = (Ied*) parameter;
+
+    EnterCriticalSection(&ied->asyncLock);
+
+    AsyncSlot* slot = NULL;
+    for (int i = 0; i < ied->window; i++) {
+        if (ied->slots[i].invokeId == invokeId && !ied->slots[i].done) {
+            slot = &ied->slots[i];
+            break;
+        }
+    }
+
+    if (slot) {
+        slot->done = 1;
+        slot->err = err;
+        slot->value = value;
+
+        ied->rttSum += nowMs() - slot->sentAt;
+        ied->rttCount++;
+
+        WakeConditionVariable(&ied->asyncDone);
+    }
+    else if (value) {
+        /* response to a request we already timed out */
+        MmsValue_delete(value);
+    }
+
+    LeaveCriticalSection(&ied->asyncLock);
+}
+
+/* Keep up to ied->window reads in flight until every target of the group is answered or timed out */
+int readAllAsync(Ied* ied, PollGroup* g)
+{
+    int requests = 0;
+    int next = 0;
+    int inFlight = 0;
+
+    AsyncSlot finished[MAX_WINDOW];
+
+    EnterCriticalSection(&ied->asyncLock);
+
+    while (next < g->itemCount || inFlight > 0) {
+
+        double now = nowMs();
+        int finishedCount = 0;
+        double oldest = now;
+
+        /* collect answers and expire stragglers individually */
+        for (int i = 0; i < ied->window; i++) {
+            AsyncSlot* slot = &ied->slots[i];
+
+            if (slot->invokeId == 0)
+                continue;
+
+            if (slot->done || now - slot->sentAt > REQUEST_TIMEOUT_MS) {
+                if (!slot->done)
+                    slot->err = IED_ERROR_TIMEOUT;
+
+                finished[finishedCount++] = *slot;
+                memset(slot, 0, sizeof(*slot));
+                inFlight--;
+            }
+            else if (slot->sentAt < oldest) {
+                oldest = slot->sentAt;
+            }
+        }
+
+        /* refill the window */
+        for (int i = 0; i < ied->window && next < g->itemCount; i++) {
+            AsyncSlot* slot = &ied->slots[i];
+
+            if (slot->invokeId != 0)
+                continue;
+
+            ReadItem* t = &items[g->order[next++]];
+            IedClientError err;
+
+            /* asyncLock is held, so the handler cannot see the slot before invokeId is set */
+            uint32_t invokeId = IedConnection_readObjectAsync(ied->con, &err, t->path, t->fc,
+                    asyncReadHandler, ied);
+            requests++;
+
+            if (err != IED_ERROR_OK) {
+                readFailed(t->path, err);
+                continue;
+            }
+
+            slot->invokeId = invokeId;
+            slot->item = (int) (t - items);
+            slot->sentAt = nowMs();
+            inFlight++;
+        }
+
+        if (finishedCount > 0) {
+            LeaveCriticalSection(&ied->asyncLock);
+
+            for (int i = 0; i < finishedCount; i++) {
+                ReadItem* t = &items[finished[i].item];
+
+                if (finished[i].value && finished[i].err == IED_ERROR_OK)
+                    deliverItem(t, finished[i].value);
+                else
+                    readFailed(t->path, finished[i].err);
+
+                if (finished[i].value)
+                    MmsValue_delete(finished[i].value);
+            }
+
+            EnterCriticalSection(&ied->asyncLock);
+            continue;
+        }
+
+        if (inFlight > 0) {
+            double wait = oldest + REQUEST_TIMEOUT_MS - nowMs();
+            SleepConditionVariableCS(&ied->asyncDone, &ied->asyncLock, wait > 0 ? (DWORD) wait + 1 : 1);
+        }
+        else if (next < g->itemCount && IedConnection_getState(ied->con) != IED_STATE_CONNECTED) {
+            break;
+        }
+    }
+
+    LeaveCriticalSection(&ied->asyncLock);
+
+    return requests;
+}
+
+/* ===================== Dynamic Data Set Reads ===================== */
+
+/* Create the group's temporary data set on the current association */
+static int createPollDataSet(Ied* ied, PollGroup* g)
+{
+    IedClientError err;
+    LinkedList references = LinkedList_create();
+
+    snprintf(g->dataSetRef, sizeof(g->dataSetRef), "@Poll%d", (int) (g - groups));
+
+    for (int i = 0; i < g->itemCount; i++) {
+        ReadItem* t = &items[g->order[i]];
+        char* member = malloc(sizeof(t->path) + 8);
+
+        sprintf(member, "%s[%s]", t->path, FunctionalConstraint_toString(t->fc));
+        LinkedList_add(references, member);
+    }
+
+    IedConnection_createDataSet(ied->con, &err, g->dataSetRef, references);
+
+    LinkedList_destroy(references);
+
+    if (err != IED_ERROR_OK) {
+        printf("Data set %s refused by %s:%d (%d), using per-object reads\n",
+               g->dataSetRef, ied->host, ied->port, err);
+        return 0;
+    }
+
+    printf("Data set %s created on %s:%d (%d members)\n",
+           g->dataSetRef, ied->host, ied->port, g->itemCount);
+
+    return 1;
+}
+
+/* One round-trip for the whole group; the ClientDataSet values are updated in place */
+int readAllDataSet(Ied* ied, PollGroup* g)
+{
+    if (g->dataSetState == 0)
+        g->dataSetState = createPollDataSet(ied, g) ? 1 : -1;
+
+    if (g->dataSetState < 0)
+        return readAllBatched(ied, g);
+
+    IedClientError err;
+
+    g->dataSet = IedConnection_readDataSetValues(ied->con, &err, g->dataSetRef, g->dataSet);
+
+    MmsValue* values = g->dataSet ? ClientDataSet_getValues(g->dataSet) : NULL;
+
+    if (err != IED_ERROR_OK || !values || (int) MmsValue_getArraySize(values) != g->itemCount) {
+        if (!quiet)
+            printf("Data set read failed: %s on %s:%d (%d)\n", g->dataSetRef, ied->host, ied->port, err);
+
+        if (logRing)
+            logRing->failed += g->itemCount;
+
+        return 1;
+    }
+
+    for (int i = 0; i < g->itemCount; i++) {
+        ReadItem* t = &items[g->order[i]];
+        MmsValue* v = MmsValue_getElement(values, i);
+
+        if (v && MmsValue_getType(v) != MMS_DATA_ACCESS_ERROR)
+            deliverItem(t, v);
+        else
+            readFailed(t->path, 0);
+    }
+
+    return 1;
+}
+
+/* Data sets of the old association are gone after a reconnect */
+static void resetPollDataSets(Ied* ied)
+{
+    for (int i = 0; i < groupCount; i++) {
+        PollGroup* g = &groups[i];
+
+        if (&ieds[g->ied] != ied)
+            continue;
+
+        if (g->dataSet) {
+            ClientDataSet_destroy(g->dataSet);
+            g->dataSet = NULL;
+        }
+
+        g->dataSetState = 0;
+    }
+}
+
+/* ===================== Connection Handling ===================== */
+
+int ensureConnected(Ied* ied)
+{
+    if (ied->connected) {
+        if (IedConnection_getState(ied->con) == IED_STATE_CONNECTED)
+            return 1;
+
+        printf("Connection lost: %s:%d\n", ied->host, ied->port);
+        IedConnection_destroy(ied->con);
+        ied->con = NULL;
+        ied->connected = 0;
+        ied->retryAt = 0;
+    }
+
+    /* a dead IED is retried rarely so it only briefly occupies a worker */
+    if (nowMs() < ied->retryAt)
+        return 0;
+
+    IedClientError err;
+
+    ied->con = IedConnection_create();
+    IedConnection_setConnectTimeout(ied->con, CONNECT_TIMEOUT_MS);
+    IedConnection_setRequestTimeout(ied->con, REQUEST_TIMEOUT_MS);
+
+    if (readMode == READ_ASYNC)
+        MmsConnection_setMaxOutstandingCalls(IedConnection_getMmsConnection(ied->con),
+                asyncWindow, asyncWindow);
+
+    IedConnection_connect(ied->con, &err, ied->host, ied->port);
+
+    if (err != IED_ERROR_OK) {
+        printf("Connection failed: %s:%d (%d)\n", ied->host, ied->port, err);
+        IedConnection_destroy(ied->con);
+        ied->con = NULL;
+        ied->retryAt = nowMs() + RECONNECT_INTERVAL_MS;
+        return 0;
+    }
+
+    MmsConnectionParameters params = MmsConnection_getMmsConnectionParameters(
+            IedConnection_getMmsConnection(ied->con));
+
+    ied->maxPduSize = params.maxPduSize;
+    ied->connected = 1;
+
+    resolveCoalescedItems(ied);
+    resetPollDataSets(ied);
+
+    /* the server may grant fewer outstanding requests than asked for */
+    ied->window = asyncWindow;
+    if (params.maxServOutstandingCalling > 0 && ied->window > params.maxServOutstandingCalling)
+        ied->window = params.maxServOutstandingCalling;
+
+    printf("Connected: %s:%d (max PDU %d bytes, %d outstanding)\n",
+           ied->host, ied->port, ied->maxPduSize, params.maxServOutstandingCalling);
+
+    return 1;
+}
+
+void pollGroup(Ied* ied, PollGroup* g)
+{
+    if (!ensureConnected(ied))
+        return;
+
+    double start = nowMs();
+    int requests = 0;
+
+    if (readMode == READ_BATCHED) {
+        requests = readAllBatched(ied, g);
+    }
+    else if (readMode == READ_ASYNC) {
+        requests = readAllAsync(ied, g);
+    }
+    else if (readMode == READ_DATASET) {
+        requests = readAllDataSet(ied, g);
+    }
+    else {
+        for (int i = 0; i < g->itemCount; i++)
+            requests += readSingle(ied->con, &items[g->order[i]]);
+    }
+
+    if (!quiet)
+        printf("Cycle %s:%d @%dms: %d targets, %d items, %d requests, %.1f ms\n",
+               ied->host, ied->port, g->intervalMs, g->targetCount, g->itemCount, requests, nowMs() - start);
+}
+
+/* ===================== Worker Pool ===================== */
+
+/* IEDs with due groups; an IED is queued at most once (Ied.queued) */
+Ied* jobQueue[MAX_IEDS];
+int jobHead = 0;
+int jobCount = 0;
+
+CRITICAL_SECTION jobLock;
+CONDITION_VARIABLE jobReady;
+
+void pushJob(Ied* ied)
+{
+    EnterCriticalSection(&jobLock);
+
+    jobQueue[(jobHead + jobCount) % MAX_IEDS] = ied;
+    jobCount++;
+
+    LeaveCriticalSection(&jobLock);
+    WakeConditionVariable(&jobReady);
+}
+
+/* NULL once the logger stops; jobs still queued are not polled */
+Ied* popJob()
+{
+    EnterCriticalSection(&jobLock);
+
+    while (jobCount == 0 && running)
+        SleepConditionVariableCS(&jobReady, &jobLock, INFINITE);
+
+    if (!running) {
+        LeaveCriticalSection(&jobLock);
+        return NULL;
+    }
+
+    Ied* ied = jobQueue[jobHead];
+    jobHead = (jobHead + 1) % MAX_IEDS;
+    jobCount--;
+
+    LeaveCriticalSection(&jobLock);
+
+    return ied;
+}
+
+/* Guards the due lists and the pending/queued flags shared by scheduler and workers */
+CRITICAL_SECTION schedLock;
+
+DWORD WINAPI pollWorker(LPVOID param)
+{
+    logRing = (LogRing*) param;
+
+    Ied* ied;
+
+    while ((ied = popJob()) != NULL) {
+
+        /* drain every group that fell due for this IED, one association at a time */
+        while (running) {
+            EnterCriticalSection(&schedLock);
+
+            PollGroup* g = ied->dueHead;
+            if (!g) {
+                ied->queued = 0;
+                LeaveCriticalSection(&schedLock);
+                break;
+            }
+
+            ied->dueHead = g->nextDue;
+            if (!ied->dueHead) ied->dueTail = NULL;
+
+            double late = nowMs() - g->firedFor;
+            if (late > g->maxLateness) g->maxLateness = late;
+
+            LeaveCriticalSection(&schedLock);
+
+            pollGroup(ied, g);
+
+            EnterCriticalSection(&schedLock);
+            g->pending = 0;
+            LeaveCriticalSection(&schedLock);
+        }
+    }
+
+    return 0;
+}
+
+/* ===================== Deadline Scheduler ===================== */
+
+/* Min-heap of poll groups ordered by absolute deadline */
+PollGroup** heap;
+int heapSize = 0;
+
+static void heapSwap(int a, int b)
+{
+    PollGroup* tmp = heap[a];
+    heap[a] = heap[b];
+    heap[b] = tmp;
+}
+
+void heapPush(PollGroup* g)
+{
+    int i = heapSize++;
+    heap[i] = g;
+
+    while (i > 0 && heap[(i - 1) / 2]->deadline > heap[i]->deadline) {
+        heapSwap(i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+PollGroup* heapPop()
+{
+    PollGroup* top = heap[0];
+    heap[0] = heap[--heapSize];
+
+    int i = 0;
+    while (1) {
+        int l = 2 * i + 1, r = l + 1, m = i;
+
+        if (l < heapSize && heap[l]->deadline < heap[m]->deadline) m = l;
+        if (r < heapSize && heap[r]->deadline < heap[m]->deadline) m = r;
+        if (m == i) break;
+
+        heapSwap(i, m);
+        i = m;
+    }
+
+    return top;
+}
+
+/* Spread groups sharing a period evenly across it instead of firing them together */
+void initDeadlines(double start)
+{
+    heap = malloc((groupCount + 1) * sizeof(PollGroup*));
+
+    for (int i = 0; i < groupCount; i++) {
+        int slot = 0, slots = 0;
+
+        for (int j = 0; j < groupCount; j++) {
+            if (groups[j].intervalMs == groups[i].intervalMs) {
+                if (j < i) slot++;
+                slots++;
+            }
+        }
+
+        groups[i].deadline = start + (double) groups[i].intervalMs * slot / slots;
+        heapPush(&groups[i]);
+    }
+}
+
+/* Hand a due group to its IED, or count a miss if its previous poll is still pending */
+void fireGroup(PollGroup* g)
+{
+    Ied* ied = &ieds[g->ied];
+
+    EnterCriticalSection(&schedLock);
+
+    if (g->pending) {
+        g->missed++;
+    }
+    else {
+        g->pending = 1;
+        g->firedFor = g->deadline;
+        g->nextDue = NULL;
+
+        if (ied->dueTail) ied->dueTail->nextDue = g;
+        else ied->dueHead = g;
+        ied->dueTail = g;
+
+        if (!ied->queued) {
+            ied->queued = 1;
+            pushJob(ied);
+        }
+    }
+
+    LeaveCriticalSection(&schedLock);
+}
+
+void reportMissedDeadlines()
+{
+    EnterCriticalSection(&schedLock);
+
+    for (int i = 0; i < groupCount; i++) {
+        PollGroup* g = &groups[i];
+
+        if (g->missed != g->missedReported) {
+            printf("Missed deadlines %s:%d @%dms: %ld (%ld total), worst start %.1f ms late\n",
+                   ieds[g->ied].host, ieds[g->ied].port, g->intervalMs,
+                   g->missed - g->missedReported, g->missed, g->maxLateness);
+            g->missedReported = g->missed;
+        }
+
+        g->maxLateness = 0;
+    }
+
+    LeaveCriticalSection(&schedLock);
+}
+
+/* Fire groups on absolute deadlines so read time never adds up to drift */
+void runScheduler()
+{
+    double nextReport = nowMs() + STATS_INTERVAL_MS;
+
+    initDeadlines(nowMs());
+
+    while (running) {
+        double now = nowMs();
+
+        while (heapSize > 0 && heap[0]->deadline <= now) {
+            PollGroup* g = heapPop();
+
+            fireGroup(g);
+
+            g->deadline += g->intervalMs;
+
+            /* more than a whole period behind: skip the lost slots instead of bursting */
+            if (g->deadline <= now) {
+                long lost = (long) ((now - g->deadline) / g->intervalMs) + 1;
+                g->deadline += (double) lost * g->intervalMs;
+
+                EnterCriticalSection(&schedLock);
+                g->missed += lost;
+                LeaveCriticalSection(&schedLock);
+            }
+
+            heapPush(g);
+        }
+
+        if (now >= nextReport) {
+            reportMissedDeadlines();
+            nextReport += STATS_INTERVAL_MS;
+        }
+
+        double wait = heap[0]->deadline - nowMs();
+        if (wait > nextReport - now) wait = nextReport - now;
+        if (wait > 0)
+            WaitForSingleObject(stopEvent, (DWORD) wait);
+    }
+}
+
+/* Runs on a thread of its own; returning TRUE keeps the process alive for main to finish */
+static BOOL WINAPI onConsoleEvent(DWORD type)
+{
+    if (type != CTRL_C_EVENT && type != CTRL_BREAK_EVENT && type != CTRL_CLOSE_EVENT)
+        return FALSE;
+
+    InterlockedExchange(&running, 0);
+    SetEvent(stopEvent);
+
+    /* the process ends when this returns from a close event: give main the time to close the logs */
+    if (type == CTRL_CLOSE_EVENT)
+        WaitForSingleObject(stoppedEvent, 4000);
+
+    return TRUE;
+}
+
+/* ===================== Window Sweep ===================== */
+
+/* Throughput and round-trip time of the first poll group for a range of window sizes */
+void runWindowSweep()
+{
+    static const int windows[] = { 1, 2, 4, 8, 16, 32, 64 };
+
+    PollGroup* g = &groups[0];
+    Ied* ied = &ieds[g->ied];
+
+    sweeping = 1;
+
+    if (!ensureConnected(ied)) {
+        printf("Sweep: cannot connect to %s:%d\n", ied->host, ied->port);
+        return;
+    }
+
+    int granted = ied->window;
+
+    printf("Sweep %s:%d, %d targets\n", ied->host, ied->port, g->targetCount);
+    printf("window  reads/s    mean RTT ms\n");
+
+    for (int w = 0; w < (int) (sizeof(windows) / sizeof(windows[0])); w++) {
+
+        if (windows[w] > granted)
+            break;
+
+        ied->window = windows[w];
+        ied->rttSum = 0;
+        ied->rttCount = 0;
+
+        double start = nowMs();
+        long reads = 0;
+
+        while (nowMs() - start < SWEEP_STEP_MS)
+            reads += readAllAsync(ied, g);
+
+        double elapsed = nowMs() - start;
+
+        printf("%6d  %9.1f  %11.2f\n", windows[w], reads * 1000.0 / elapsed,
+               ied->rttCount ? ied->rttSum / ied->rttCount : 0.0);
+    }
+
+    ied->window = granted;
+    sweeping = 0;
+}
+
+/* ===================== MAIN ===================== */
+
+int main(int argc, char** argv)
+{
+    const char* targetFile = "targets.txt";
+    const char* defaultIed = IED_IP;
+    int workerCount = 0;
+    int sweep = 0;
+    int segmentMb = TSL_SEGMENT_MB;
+    int segmentMinutes = TSL_SEGMENT_MINUTES;
+    const char* latestFile = LATEST_FILE;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--single") == 0)
+            readMode = READ_SINGLE;
+        else if (strcmp(argv[i], "--batch") == 0)
+            readMode = READ_BATCHED;
+        else if (strcmp(argv[i], "--async") == 0)
+            readMode = READ_ASYNC;
+        else if (strcmp(argv[i], "--dataset") == 0)
+            readMode = READ_DATASET;
+        else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc)
+            asyncWindow = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--sweep") == 0) {
+            readMode = READ_ASYNC;
+            asyncWindow = MAX_WINDOW;
+            sweep = 1;
+        }
+        else if (strcmp(argv[i], "--ied") == 0 && i + 1 < argc)
+            defaultIed = argv[++i];
+        else if (strcmp(argv[i], "--targets") == 0 && i + 1 < argc)
+            targetFile = argv[++i];
+        else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc)
+            workerCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--quiet") == 0)
+            quiet = 1;
+        else if (strcmp(argv[i], "--segment-mb") == 0 && i + 1 < argc)
+            segmentMb = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--segment-min") == 0 && i + 1 < argc)
+            segmentMinutes = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--latest") == 0 && i + 1 < argc)
+            latestFile = argv[++i];
+        else if (strcmp(argv[i], "--all") == 0)
+            logEveryRead = 1;
+        else if (strcmp(argv[i], "--heartbeat") == 0 && i + 1 < argc) {
+            i++;
+            heartbeatMs = parseHeartbeat(argv[i]);
+        }
+        else {
+            printf("Usage: %s [--single | --batch | --async [--window n] | --dataset | --sweep]\n"
+                   "       [--ied host[:port]] [--targets file] [--workers n] [--quiet]\n"
+                   "       [--segment-mb n] [--segment-min n] [--latest file]\n"
+                   "       [--all | --heartbeat interval]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (asyncWindow < 1) asyncWindow = 1;
+    if (asyncWindow > MAX_WINDOW) asyncWindow = MAX_WINDOW;
+
+    loadTargets(targetFile, defaultIed);
+    buildPollGroups();
+
+    lastLogged = calloc(targetCount, sizeof(LastLogged));
+
+    if (groupCount == 0) {
+        printf("No targets\n");
+        return 1;
+    }
+
+    /* polling is network bound: by default a few connections per core */
+    if (workerCount <= 0) {
+        SYSTEM_INFO si;
+        GetSystemInfo(&si);
+        workerCount = 4 * (int) si.dwNumberOfProcessors;
+    }
+    if (workerCount > iedCount) workerCount = iedCount;
+    if (workerCount > MAX_WORKERS) workerCount = MAX_WORKERS;
+
+    if (sweep) {
+        runWindowSweep();
+        return 0;
+    }
+
+    static const char* modeNames[] = { "single", "batched", "async", "dataset" };
+
+    printf("Read mode: %s, %d workers\n", modeNames[readMode], workerCount);
+    if (readMode == READ_ASYNC)
+        printf("Async window: %d\n", asyncWindow);
+
+    csv = fopen("mms-log.csv", "w");
+    json = fopen("mms-log.json", "w");
+    tsl = tsLogCreate("mms-log", (long long) segmentMb << 20, (int64_t) segmentMinutes * 60000);
+    createLatestTable(latestFile);
+
+    fprintf(csv, "time,ied,tag,value,sourceTime\n");
+    fflush(csv);
+
+    /* the writer hands whole blocks to the files, stdio buffering would only split them */
+    setvbuf(csv, NULL, _IONBF, 0);
+    setvbuf(json, NULL, _IONBF, 0);
+
+    InitializeCriticalSection(&jobLock);
+    InitializeCriticalSection(&schedLock);
+    InitializeConditionVariable(&jobReady);
+
+    ringCount = workerCount;
+    rings = calloc(ringCount, sizeof(LogRing));
+
+    clockInit();
+
+    stopEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    stoppedEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    SetConsoleCtrlHandler(onConsoleEvent, TRUE);
+
+    HANDLE writer = CreateThread(NULL, 0, logWriter, NULL, 0, NULL);
+    HANDLE workers[MAX_WORKERS];
+
+    for (int i = 0; i < workerCount; i++)
+        workers[i] = CreateThread(NULL, 0, pollWorker, &rings[i], 0, NULL);
+
+    runScheduler();
+
+    printf("Stopping: waiting for the polls in progress\n");
+
+    /* with jobLock held no worker is between its check of running and its sleep */
+    EnterCriticalSection(&jobLock);
+    WakeAllConditionVariable(&jobReady);
+    LeaveCriticalSection(&jobLock);
+
+    WaitForMultipleObjects(workerCount, workers, TRUE, INFINITE);
+
+    for (int i = 0; i < workerCount; i++)
+        CloseHandle(workers[i]);
+
+    /* every record is in a ring now: the writer drains them and returns */
+    InterlockedExchange(&writing, 0);
+    WaitForSingleObject(writer, INFINITE);
+    CloseHandle(writer);
+
+    for (int i = 0; i < iedCount; i++) {
+        if (ieds[i].con) {
+            IedConnection_close(ieds[i].con);
+            IedConnection_destroy(ieds[i].con);
+        }
+    }
+
+    fclose(csv);
+    fclose(json);
+    tsLogClose(tsl);
+
+    if (latest)
+        lvClose(latest);
+
+    printf("Stopped, log segment indexed\n");
+
+    SetEvent(stoppedEvent);
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tslog.h"
+
+static int exportSegment(const char* fileName, FILE* out, int asJson, long long* samples, int* blocks)
+{
+    TsLogReader* r = tsReadOpen(fileName);
+
+    if (!r) {
+        fprintf(stderr, "Not a binary log: %s\n", fileName);
+        return 0;
+    }
+
+    TsRow* rows;
+    int count;
+
+    while ((count = tsReadBlock(r, &rows)) > 0) {
+
+        for (int i = 0; i < count; i++) {
+            char ts[32];
+            char value[TS_TEXT_SIZE + 32];
+
+            tsFormatTime(rows[i].sample.timeMs, ts, sizeof(ts));
+            tsFormatValue(&rows[i].sample, value, sizeof(value));
+
+            const char* ied = tsReadTagIed(r, rows[i].tag);
+            const char* tag = tsReadTagPath(r, rows[i].tag);
+
+            if (asJson)
+                fprintf(out, "{\"time\":\"%s\",\"ied\":\"%s\",\"tag\":\"%s\",\"value\":\"%s\"}\n", ts, ied, tag, value);
+            else
+                fprintf(out, "%s,%s,%s,%s\n", ts, ied, tag, value);
+        }
+
+        *samples += count;
+        (*blocks)++;
+    }
+
+    if (count < 0)
+        fprintf(stderr, "Corrupt block in %s\n", fileName);
+
+    tsReadClose(r);
+
+    return count == 0;
+}
+
+/*
+ * Convert binary log segments (mms-log-*.tsl) back to the text logs:
+ *   mms_export segment ... [--json] [--out file]
+ * CSV is "time,ied,tag,value" like mms-log.csv, --json gives one object per line
+ * like mms-log.json.
+ */
+int main(int argc, char** argv)
+{
+    const char* inputs[256];
+    int inputCount = 0;
+    const char* output = NULL;
+    int asJson = 0;
+    int usage = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0)
+            asJson = 1;
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            output = argv[++i];
+        else if (argv[i][0] != '-' && inputCount < 256)
+            inputs[inputCount++] = argv[i];
+        else
+            usage = 1;
+    }
+
+    if (inputCount == 0 || usage) {
+        printf("Usage: %s segment.tsl ... [--json] [--out file]\n", argv[0]);
+        return 1;
+    }
+
+    FILE* out = output ? fopen(output, "w") : stdout;
+
+    if (!out) {
+        printf("Cannot create %s\n", output);
+        return 1;
+    }
+
+    if (!asJson)
+        fprintf(out, "time,ied,tag,value\n");
+
+    long long samples = 0;
+    int blocks = 0;
+    int failed = 0;
+
+    for (int f = 0; f < inputCount; f++)
+        if (!exportSegment(inputs[f], out, asJson, &samples, &blocks))
+            failed = 1;
+
+    fprintf(stderr, "%lld samples in %d blocks\n", samples, blocks);
+
+    if (out != stdout)
+        fclose(out);
+
+    return failed;
+}
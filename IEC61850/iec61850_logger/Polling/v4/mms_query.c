@@ -0,0 +1,270 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <time.h>
+#endif
+
+#include "fmt.h"
+#include "tslog.h"
+
+#define MAX_SEGMENTS 65536
+
+/*
+ * Values of one tag in a time range from the binary log segments:
+ *   mms_query tag [--ied host:port] [--from time] [--to time] [--json] segment|directory ...
+ * Times are "2025-01-31T12:00:00Z" (milliseconds optional, UTC) or ms since
+ * 1970. Without --ied the tag of every IED logging it is listed, the ied
+ * column tells them apart. Only the segment indexes and the columns of the
+ * tag are read.
+ */
+
+typedef struct {
+    char path[300];
+    TsSegment* seg;
+    int64_t minTime;
+    int64_t maxTime;
+} Segment;
+
+Segment* segments;
+int segmentCount = 0;
+
+static double nowMs()
+{
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER c;
+
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency(&freq);
+
+    QueryPerformanceCounter(&c);
+    return (double) c.QuadPart * 1000.0 / (double) freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+}
+
+/* Days since 1970-01-01 of a proleptic Gregorian date */
+static int64_t daysFromCivil(int y, int m, int d)
+{
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = (int) (y - era * 400);
+    int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + doe - 719468;
+}
+
+static int parseTime(const char* s, int64_t* out)
+{
+    int y, mo, d, h = 0, mi = 0, sec = 0, ms = 0;
+
+    if (sscanf(s, "%d-%d-%dT%d:%d:%d.%d", &y, &mo, &d, &h, &mi, &sec, &ms) >= 3) {
+        *out = ((daysFromCivil(y, mo, d) * 24 + h) * 60 + mi) * 60000LL + sec * 1000LL + ms;
+        return 1;
+    }
+
+    char* end;
+    *out = strtoll(s, &end, 10);
+
+    return *end == 0 && end != s;
+}
+
+static void addSegment(const char* path)
+{
+    if (segmentCount == MAX_SEGMENTS)
+        return;
+
+    strncpy(segments[segmentCount].path, path, sizeof(segments[0].path) - 1);
+    segmentCount++;
+}
+
+static int endsWithTsl(const char* name)
+{
+    size_t n = strlen(name);
+    return n > 4 && strcmp(name + n - 4, ".tsl") == 0;
+}
+
+/* A directory stands for the .tsl files in it */
+static void addArgument(const char* arg)
+{
+    char path[300];
+
+#ifdef _WIN32
+    DWORD attributes = GetFileAttributesA(arg);
+
+    if (attributes == INVALID_FILE_ATTRIBUTES || !(attributes & FILE_ATTRIBUTE_DIRECTORY)) {
+        addSegment(arg);
+        return;
+    }
+
+    WIN32_FIND_DATAA fd;
+    snprintf(path, sizeof(path), "%s\\*.tsl", arg);
+
+    HANDLE h = FindFirstFileA(path, &fd);
+    if (h == INVALID_HANDLE_VALUE)
+        return;
+
+    do {
+        /* the pattern also matches 8.3 names, e.g. "*.tslx" */
+        if (!endsWithTsl(fd.cFileName))
+            continue;
+
+        snprintf(path, sizeof(path), "%s\\%s", arg, fd.cFileName);
+        addSegment(path);
+    } while (FindNextFileA(h, &fd));
+
+    FindClose(h);
+#else
+    struct stat st;
+
+    if (stat(arg, &st) != 0 || !S_ISDIR(st.st_mode)) {
+        addSegment(arg);
+        return;
+    }
+
+    DIR* dir = opendir(arg);
+    if (!dir)
+        return;
+
+    struct dirent* e;
+    while ((e = readdir(dir)) != NULL) {
+        if (!endsWithTsl(e->d_name))
+            continue;
+
+        snprintf(path, sizeof(path), "%s/%s", arg, e->d_name);
+        addSegment(path);
+    }
+
+    closedir(dir);
+#endif
+}
+
+static int compareSegments(const void* a, const void* b)
+{
+    const Segment* sa = (const Segment*) a;
+    const Segment* sb = (const Segment*) b;
+
+    if (sa->minTime != sb->minTime)
+        return sa->minTime < sb->minTime ? -1 : 1;
+
+    return strcmp(sa->path, sb->path);
+}
+
+int main(int argc, char** argv)
+{
+    const char* tag = NULL;
+    const char* ied = NULL;
+    int64_t from = TS_TIME_MIN;
+    int64_t to = TS_TIME_MAX;
+    int asJson = 0;
+    int usage = 0;
+
+    segments = calloc(MAX_SEGMENTS, sizeof(Segment));
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--from") == 0 && i + 1 < argc)
+            usage |= !parseTime(argv[++i], &from);
+        else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc)
+            usage |= !parseTime(argv[++i], &to);
+        else if (strcmp(argv[i], "--ied") == 0 && i + 1 < argc)
+            ied = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0)
+            asJson = 1;
+        else if (argv[i][0] == '-')
+            usage = 1;
+        else if (!tag)
+            tag = argv[i];
+        else
+            addArgument(argv[i]);
+    }
+
+    if (!tag || segmentCount == 0 || usage) {
+        printf("Usage: %s tag [--ied host:port] [--from time] [--to time] [--json] segment|directory ...\n", argv[0]);
+        return 1;
+    }
+
+    double start = nowMs();
+
+    /* only the indexes are touched here */
+    int opened = 0;
+
+    for (int i = 0; i < segmentCount; i++) {
+        Segment* s = &segments[i];
+
+        s->seg = tsSegmentOpen(s->path);
+
+        if (!s->seg) {
+            fprintf(stderr, "Not a log segment: %s\n", s->path);
+            s->minTime = TS_TIME_MAX;
+            continue;
+        }
+
+        tsSegmentRange(s->seg, &s->minTime, &s->maxTime);
+        opened++;
+    }
+
+    qsort(segments, segmentCount, sizeof(Segment), compareSegments);
+
+    long long rowCount = 0;
+    int searched = 0;
+
+    if (!asJson)
+        printf("time,ied,tag,value\n");
+
+    for (int i = 0; i < segmentCount; i++) {
+        Segment* s = &segments[i];
+
+        if (!s->seg || s->maxTime < from || s->minTime > to)
+            continue;
+
+        TsRow* rows;
+        int count = tsSegmentQuery(s->seg, ied, tag, from, to, &rows);
+
+        searched++;
+
+        if (count < 0) {
+            fprintf(stderr, "Corrupt segment: %s\n", s->path);
+            continue;
+        }
+
+        for (int k = 0; k < count; k++) {
+            char ts[40];
+            char value[TS_TEXT_SIZE + 32];
+
+            /* the text logs have second resolution, the segments keep milliseconds */
+            *fmtTime(ts, ts + sizeof(ts), rows[k].sample.timeMs, 1) = 0;
+
+            tsFormatValue(&rows[k].sample, value, sizeof(value));
+
+            const char* source = tsSegmentTagIed(s->seg, rows[k].tag);
+
+            if (asJson)
+                printf("{\"time\":\"%s\",\"ied\":\"%s\",\"tag\":\"%s\",\"value\":\"%s\"}\n", ts, source, tag, value);
+            else
+                printf("%s,%s,%s,%s\n", ts, source, tag, value);
+        }
+
+        rowCount += count;
+    }
+
+    fprintf(stderr, "%lld values, %d of %d segments searched, %.2f ms\n",
+            rowCount, searched, opened, nowMs() - start);
+
+    for (int i = 0; i < segmentCount; i++)
+        if (segments[i].seg)
+            tsSegmentClose(segments[i].seg);
+
+    free(segments);
+
+    return 0;
+}
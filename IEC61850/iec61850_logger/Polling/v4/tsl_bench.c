@@ -0,0 +1,354 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <time.h>
+#endif
+
+#include "fmt.h"
+#include "tslog.h"
+
+/*
+ * Synthetic samples for the binary log (tslog.h):
+ *   tsl_bench [samples] [tags] [directory] [--segment-mb n] [--segment-min n]
+ * Writes the samples as segments mms-log-*.tsl into the directory (it should
+ * be empty), tags polled every 100 ms from 2025-01-31T12:00:00Z, then reads
+ * every segment back and checks each sample against the one written. Prints
+ * the bytes per sample, and the size the same samples take in mms-log.csv.
+ * The mix per 5 tags: a float measurement, its quality, a boolean, a
+ * timestamp and a counter; every 50th tag is text.
+ */
+
+#define DEFAULT_SAMPLES 250000
+#define DEFAULT_TAGS 50
+
+#define START_MS 1738324800000LL    /* 2025-01-31T12:00:00Z */
+#define PERIOD_MS 100
+#define IED_NAME "127.0.0.1:10102"
+
+static double nowMs()
+{
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER c;
+
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency(&freq);
+
+    QueryPerformanceCounter(&c);
+    return (double) c.QuadPart * 1000.0 / (double) freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+}
+
+static uint32_t hash(int tag, long long step)
+{
+    uint64_t h = ((uint64_t) tag << 40) ^ (uint64_t) step;
+
+    h = (h ^ (h >> 33)) * 0xff51afd7ed558ccdull;
+    h = (h ^ (h >> 33)) * 0xc4ceb9fe1a85ec53ull;
+
+    return (uint32_t) (h ^ (h >> 33));
+}
+
+static void tagPath(int tag, char* out, int outLen)
+{
+    static const char* names[] = { "AnIn1.mag.f", "AnIn1.q", "SPCSO1.stVal", "AnIn1.t", "Cnt1.actVal" };
+
+    if (tag % 50 == 49)
+        snprintf(out, outLen, "GenericIO/GGIO%d.NamPlt.d", tag / 5 + 1);
+    else
+        snprintf(out, outLen, "GenericIO/GGIO%d.%s", tag / 5 + 1, names[tag % 5]);
+}
+
+/* The sample of a tag in a poll cycle; the receive time spreads the tags over the first 22 ms */
+static void makeSample(int tag, long long step, TsSample* s)
+{
+    memset(s, 0, sizeof(*s));
+
+    s->timeMs = START_MS + step * PERIOD_MS + tag % 20 + hash(tag, step) % 3;
+
+    if (tag % 50 == 49) {
+        s->kind = TS_TEXT;
+        snprintf(s->value.text, sizeof(s->value.text), "Indication %d", tag / 5 + 1);
+        return;
+    }
+
+    switch (tag % 5) {
+
+    case 0:     /* a slow wave in 0.01 steps, as a float */
+        s->kind = TS_FLOAT;
+        s->value.real = (float) (floor((230.0 + 5.0 * sin((step + tag * 37) / 3000.0)) * 100.0 + 0.5) / 100.0);
+        break;
+
+    case 1:     /* good, questionable for 5 s every hour */
+        s->kind = TS_BITS;
+        s->bitSize = 13;
+        s->value.bits = (step + tag * 997) % 36000 < 50 ? 0x0003 : 0;
+        break;
+
+    case 2:
+        s->kind = TS_BOOLEAN;
+        s->value.boolean = (int) (((step + tag * 13) / (300 + tag)) & 1);
+        break;
+
+    case 3:     /* the source time of an object updated every second */
+        s->kind = TS_UTC_TIME;
+        s->value.utcMs = START_MS + step * PERIOD_MS / 1000 * 1000 - 3;
+        break;
+
+    default:
+        s->kind = TS_INTEGER;
+        s->value.integer = (step + tag) / 50;
+        break;
+    }
+}
+
+static int sameSample(const TsSample* a, const TsSample* b)
+{
+    if (a->timeMs != b->timeMs || a->kind != b->kind)
+        return 0;
+
+    switch (a->kind) {
+    case TS_BOOLEAN:  return a->value.boolean == b->value.boolean;
+    case TS_INTEGER:  return a->value.integer == b->value.integer;
+    case TS_FLOAT:    return memcmp(&a->value.real, &b->value.real, sizeof(double)) == 0;
+    case TS_UTC_TIME: return a->value.utcMs == b->value.utcMs;
+    case TS_BITS:     return a->bitSize == b->bitSize && a->value.bits == b->value.bits;
+    default:          return strcmp(a->value.text, b->value.text) == 0;
+    }
+}
+
+/* ===================== Segments ===================== */
+
+static char (*segments)[300];
+static int segmentCount = 0;
+static int segmentCapacity = 0;
+
+static int endsWithTsl(const char* name)
+{
+    size_t n = strlen(name);
+    return n > 4 && strcmp(name + n - 4, ".tsl") == 0;
+}
+
+static void addSegment(const char* directory, const char* name)
+{
+    if (!endsWithTsl(name))
+        return;
+
+    if (segmentCount == segmentCapacity) {
+        segmentCapacity = segmentCapacity ? 2 * segmentCapacity : 16;
+        segments = realloc(segments, segmentCapacity * sizeof(segments[0]));
+    }
+
+    snprintf(segments[segmentCount++], sizeof(segments[0]), "%s/%s", directory, name);
+}
+
+static void listSegments(const char* directory)
+{
+#ifdef _WIN32
+    WIN32_FIND_DATAA fd;
+    char pattern[300];
+    snprintf(pattern, sizeof(pattern), "%s\\*.tsl", directory);
+
+    HANDLE h = FindFirstFileA(pattern, &fd);
+    if (h == INVALID_HANDLE_VALUE)
+        return;
+
+    do {
+        addSegment(directory, fd.cFileName);
+    } while (FindNextFileA(h, &fd));
+
+    FindClose(h);
+#else
+    DIR* dir = opendir(directory);
+    if (!dir)
+        return;
+
+    struct dirent* e;
+    while ((e = readdir(dir)) != NULL)
+        addSegment(directory, e->d_name);
+
+    closedir(dir);
+#endif
+}
+
+/* ===================== Main ===================== */
+
+int main(int argc, char** argv)
+{
+    long long samples = DEFAULT_SAMPLES;
+    int tags = DEFAULT_TAGS;
+    const char* directory = ".";
+    int segmentMb = 256;
+    int segmentMinutes = 60;
+    int position = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--segment-mb") == 0 && i + 1 < argc)
+            segmentMb = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--segment-min") == 0 && i + 1 < argc)
+            segmentMinutes = atoi(argv[++i]);
+        else if (position == 0)
+            samples = atoll(argv[i]), position++;
+        else if (position == 1)
+            tags = atoi(argv[i]), position++;
+        else
+            directory = argv[i];
+    }
+
+    if (samples < 1 || tags < 1) {
+        printf("Usage: %s [samples] [tags] [directory] [--segment-mb n] [--segment-min n]\n", argv[0]);
+        return 1;
+    }
+
+    long long steps = (samples + tags - 1) / tags;
+    samples = steps * tags;
+
+    listSegments(directory);
+
+    if (segmentCount > 0) {
+        printf("%s already holds log segments, use an empty directory\n", directory);
+        return 1;
+    }
+
+    char base[300];
+    snprintf(base, sizeof(base), "%s/mms-log", directory);
+
+    /* ===================== write ===================== */
+
+    TsLogWriter* w = tsLogCreate(base, (long long) segmentMb << 20, (int64_t) segmentMinutes * 60000);
+    char (*paths)[64] = malloc(tags * sizeof(paths[0]));
+
+    for (int tag = 0; tag < tags; tag++)
+        tagPath(tag, paths[tag], sizeof(paths[0]));
+
+    long long csvBytes = 0;
+    double writeMs = 0;
+
+    for (long long step = 0; step < steps; step++) {
+        for (int tag = 0; tag < tags; tag++) {
+            TsSample s;
+            makeSample(tag, step, &s);
+
+            /* the mms-log.csv line of the sample, without writing it */
+            char line[TS_TEXT_SIZE + 160];
+            char* end = line + sizeof(line);
+            char* p = fmtTime(line, end, s.timeMs, 1);
+            p = fmtText(p, end, "," IED_NAME ",");
+            p = fmtText(p, end, paths[tag]);
+            p = fmtText(p, end, ",");
+            tsFormatValue(&s, p, (int) (end - p));
+            csvBytes += (long long) (strlen(line) + strlen(",\n"));
+
+            double started = nowMs();
+            tsLogAppend(w, tag, IED_NAME, paths[tag], &s);
+            writeMs += nowMs() - started;
+        }
+    }
+
+    double started = nowMs();
+    tsLogClose(w);
+    writeMs += nowMs() - started;
+
+    listSegments(directory);
+
+    long long bytes = 0;
+
+    for (int i = 0; i < segmentCount; i++) {
+        FILE* f = fopen(segments[i], "rb");
+
+        if (f) {
+            fseek(f, 0, SEEK_END);
+            bytes += ftell(f);
+            fclose(f);
+        }
+    }
+
+    printf("%lld samples of %d tags (%lld cycles of %d ms) written in %.0f ms\n",
+           samples, tags, steps, PERIOD_MS, writeMs);
+    printf("  binary log: %lld bytes in %d segments, %.2f bytes/sample\n",
+           bytes, segmentCount, (double) bytes / samples);
+    printf("  mms-log.csv: %lld bytes, %.1f bytes/sample\n", csvBytes, (double) csvBytes / samples);
+
+    /* ===================== read back ===================== */
+
+    uint8_t* seen = calloc((size_t) ((samples + 7) / 8), 1);
+    long long read = 0, wrong = 0, repeated = 0;
+
+    started = nowMs();
+
+    for (int i = 0; i < segmentCount; i++) {
+        TsLogReader* r = tsReadOpen(segments[i]);
+
+        if (!r) {
+            printf("Cannot open %s\n", segments[i]);
+            wrong++;
+            continue;
+        }
+
+        TsRow* rows;
+        int count;
+
+        while ((count = tsReadBlock(r, &rows)) > 0) {
+            for (int k = 0; k < count; k++) {
+                int tag = rows[k].tag;
+                long long step = (rows[k].sample.timeMs - START_MS) / PERIOD_MS;
+                TsSample expected;
+
+                read++;
+
+                if (tag < 0 || tag >= tags || step < 0 || step >= steps ||
+                    strcmp(tsReadTagPath(r, tag), paths[tag]) != 0) {
+                    wrong++;
+                    continue;
+                }
+
+                makeSample(tag, step, &expected);
+
+                if (!sameSample(&rows[k].sample, &expected)) {
+                    wrong++;
+                    continue;
+                }
+
+                long long n = step * tags + tag;
+
+                if (seen[n >> 3] & (1 << (n & 7)))
+                    repeated++;
+
+                seen[n >> 3] |= (uint8_t) (1 << (n & 7));
+            }
+        }
+
+        if (count < 0) {
+            printf("Corrupt segment: %s\n", segments[i]);
+            wrong++;
+        }
+
+        tsReadClose(r);
+    }
+
+    long long missing = 0;
+
+    for (long long n = 0; n < samples; n++)
+        if (!(seen[n >> 3] & (1 << (n & 7))))
+            missing++;
+
+    printf("  read back in %.0f ms: %lld samples, %lld wrong, %lld repeated, %lld missing\n",
+           nowMs() - started, read, wrong, repeated, missing);
+
+    free(seen);
+    free(paths);
+    free(segments);
+
+    return wrong || repeated || missing ? 2 : 0;
+}
@@ -0,0 +1,1493 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "fmt.h"
+#include "tslog.h"
+
+/* 2: tags carry the IED as well as the path; version 1 segments are still read */
+#define TS_VERSION 2
+
+/* ===================== Text Form ===================== */
+
+void tsFormatTime(int64_t timeMs, char* out, int outLen)
+{
+    *fmtTime(out, out + outLen, timeMs, 1) = 0;
+}
+
+void tsFormatValue(const TsSample* s, char* out, int outLen)
+{
+    char* end = out + outLen;
+    char* p;
+
+    switch (s->kind) {
+
+    case TS_BOOLEAN:
+        p = fmtBoolean(out, end, s->value.boolean);
+        break;
+
+    case TS_INTEGER:
+        p = fmtInt64(out, end, s->value.integer);
+        break;
+
+    case TS_FLOAT:
+        p = fmtDouble(out, end, s->value.real);
+        break;
+
+    case TS_UTC_TIME:
+        p = fmtTime(out, end, s->value.utcMs, 0);
+        break;
+
+    case TS_BITS:
+        p = fmtBits(out, end, s->value.bits, s->bitSize);
+        break;
+
+    default:
+        p = fmtText(out, end, s->value.text);
+        break;
+    }
+
+    *p = 0;
+}
+
+/* ===================== Byte Buffers ===================== */
+
+typedef struct {
+    uint8_t* data;
+    int size;
+    int capacity;
+    long long bits;     /* bit-packed columns: bits used */
+} TsBuffer;
+
+static void reserve(TsBuffer* b, int n)
+{
+    if (b->size + n <= b->capacity)
+        return;
+
+    while (b->size + n > b->capacity)
+        b->capacity = b->capacity ? 2 * b->capacity : 256;
+
+    b->data = realloc(b->data, b->capacity);
+}
+
+static void putByte(TsBuffer* b, uint8_t v)
+{
+    reserve(b, 1);
+    b->data[b->size++] = v;
+}
+
+static void putBytes(TsBuffer* b, const void* p, int n)
+{
+    reserve(b, n);
+    memcpy(b->data + b->size, p, n);
+    b->size += n;
+}
+
+static void putVarint(TsBuffer* b, uint64_t v)
+{
+    while (v >= 0x80) {
+        putByte(b, (uint8_t) (v | 0x80));
+        v >>= 7;
+    }
+    putByte(b, (uint8_t) v);
+}
+
+static uint64_t zigzag(int64_t v)
+{
+    return ((uint64_t) v << 1) ^ (uint64_t) (v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v)
+{
+    return (int64_t) (v >> 1) ^ -(int64_t) (v & 1);
+}
+
+/* Deltas and running sums wrap around in uint64_t, int64_t overflow would be undefined */
+static int64_t wrapSub(int64_t a, int64_t b)
+{
+    return (int64_t) ((uint64_t) a - (uint64_t) b);
+}
+
+static int64_t wrapAdd(int64_t a, int64_t b)
+{
+    return (int64_t) ((uint64_t) a + (uint64_t) b);
+}
+
+/* Most significant bit first */
+static void putBits(TsBuffer* b, uint64_t v, int n)
+{
+    for (int i = n - 1; i >= 0; i--) {
+        if ((b->bits & 7) == 0)
+            putByte(b, 0);
+
+        if ((v >> i) & 1)
+            b->data[b->size - 1] |= 0x80 >> (b->bits & 7);
+
+        b->bits++;
+    }
+}
+
+/* varint length + bytes */
+static void putString(TsBuffer* b, const char* s)
+{
+    int len = (int) strlen(s);
+
+    putVarint(b, len);
+    putBytes(b, s, len);
+}
+
+static void clearBuffer(TsBuffer* b)
+{
+    b->size = 0;
+    b->bits = 0;
+}
+
+static void putLE(uint8_t* p, uint64_t v, int n)
+{
+    for (int i = 0; i < n; i++)
+        p[i] = (uint8_t) (v >> (8 * i));
+}
+
+static uint64_t getLE(const uint8_t* p, int n)
+{
+    uint64_t v = 0;
+
+    for (int i = n - 1; i >= 0; i--)
+        v = (v << 8) | p[i];
+
+    return v;
+}
+
+/* ===================== Writer ===================== */
+
+typedef struct {
+    char* ied;
+    char* path;
+    TsKind kind;
+    int bitSize;
+    int defined;            /* dictionary entry written for the current kind */
+
+    int inSegment;          /* has samples in the current segment */
+    int entryPos;           /* while the segment index is written */
+    int entryCount;
+
+    int count;              /* samples in the current block */
+    int64_t minTime;
+    int64_t maxTime;
+    TsBuffer times;
+    TsBuffer values;
+
+    int64_t lastTime;
+    int64_t lastDelta;
+
+    int64_t lastInt;        /* TS_INTEGER, TS_UTC_TIME */
+
+    uint64_t lastBits;      /* TS_FLOAT */
+    int leading;
+    int trailing;
+
+    uint32_t runValue;      /* TS_BOOLEAN, TS_BITS */
+    uint32_t runLength;
+
+    char lastText[TS_TEXT_SIZE];
+} TsColumn;
+
+/* One column of one block */
+typedef struct {
+    int tag;
+    TsKind kind;
+    int bitSize;
+    long long offset;       /* in the segment file */
+    int samples;
+    int64_t minTime;
+    int64_t maxTime;
+} TsIndexEntry;
+
+struct sTsLogWriter {
+    char baseName[256];
+    long long maxSegmentBytes;
+    int64_t maxSegmentMs;
+
+    FILE* file;             /* current segment, NULL until its first block */
+    long long segmentBytes;
+    int64_t segmentStart;
+
+    TsIndexEntry* index;    /* columns written to the current segment */
+    int indexCount;
+    int indexCapacity;
+    TsBuffer indexEntries;
+
+    TsColumn* columns;      /* indexed by tag */
+    int columnCount;
+
+    int samples;            /* in the current block */
+    int64_t blockStart;     /* earliest sample of the current block */
+    TsBuffer block;
+    long long bytesWritten;
+};
+
+TsLogWriter* tsLogCreate(const char* baseName, long long maxSegmentBytes, int64_t maxSegmentMs)
+{
+    TsLogWriter* w = calloc(1, sizeof(TsLogWriter));
+
+    strncpy(w->baseName, baseName, sizeof(w->baseName) - 1);
+    w->maxSegmentBytes = maxSegmentBytes;
+    w->maxSegmentMs = maxSegmentMs;
+
+    return w;
+}
+
+static int openSegment(TsLogWriter* w, int64_t firstTime)
+{
+    time_t t = (time_t) (firstTime / 1000);
+    struct tm tm;
+#ifdef _WIN32
+    gmtime_s(&tm, &t);
+#else
+    gmtime_r(&t, &tm);
+#endif
+
+    char stamp[32];
+    char name[300];
+
+    strftime(stamp, sizeof(stamp), "%Y%m%dT%H%M%S", &tm);
+    snprintf(name, sizeof(name), "%s-%s%03d.tsl", w->baseName, stamp, (int) (firstTime % 1000));
+
+    w->file = fopen(name, "wb");
+
+    if (!w->file) {
+        printf("Cannot create log segment %s\n", name);
+        return 0;
+    }
+
+    uint8_t header[8] = { 'M', 'T', 'S', 'L', TS_VERSION, 0, 0, 0 };
+    fwrite(header, 1, sizeof(header), w->file);
+
+    w->segmentBytes = sizeof(header);
+    w->segmentStart = firstTime;
+    w->bytesWritten += sizeof(header);
+
+    /* every segment carries its own tag dictionary */
+    for (int i = 0; i < w->columnCount; i++) {
+        w->columns[i].defined = 0;
+        w->columns[i].inSegment = 0;
+    }
+
+    return 1;
+}
+
+static int compareIndexEntries(const void* a, const void* b)
+{
+    const TsIndexEntry* ea = (const TsIndexEntry*) a;
+    const TsIndexEntry* eb = (const TsIndexEntry*) b;
+
+    if (ea->tag != eb->tag)
+        return ea->tag - eb->tag;
+
+    return ea->offset < eb->offset ? -1 : ea->offset > eb->offset;
+}
+
+void tsLogCloseSegment(TsLogWriter* w)
+{
+    if (!w->file)
+        return;
+
+    /* by tag, then file offset (= time order of the blocks) */
+    qsort(w->index, w->indexCount, sizeof(TsIndexEntry), compareIndexEntries);
+
+    /* entries first, so the tag directory can point at each tag's run */
+    TsBuffer* entries = &w->indexEntries;
+    clearBuffer(entries);
+
+    int64_t minTime = TS_TIME_MAX;
+    int64_t maxTime = TS_TIME_MIN;
+
+    for (int i = 0; i < w->indexCount; i++) {
+        TsIndexEntry* e = &w->index[i];
+        TsColumn* c = &w->columns[e->tag];
+
+        if (i == 0 || e->tag != w->index[i - 1].tag) {
+            c->entryPos = entries->size;
+            c->entryCount = 0;
+        }
+        c->entryCount++;
+
+        putByte(entries, (uint8_t) e->kind);
+        putByte(entries, (uint8_t) e->bitSize);
+        putVarint(entries, e->offset);
+        putVarint(entries, e->samples);
+        putVarint(entries, zigzag(e->minTime));
+        putVarint(entries, zigzag(e->maxTime));
+
+        if (e->minTime < minTime) minTime = e->minTime;
+        if (e->maxTime > maxTime) maxTime = e->maxTime;
+    }
+
+    TsBuffer* b = &w->block;
+    clearBuffer(b);
+
+    putVarint(b, zigzag(minTime));
+    putVarint(b, zigzag(maxTime));
+
+    int tags = 0;
+    for (int i = 0; i < w->columnCount; i++)
+        if (w->columns[i].inSegment) tags++;
+
+    putVarint(b, tags);
+
+    for (int i = 0; i < w->columnCount; i++) {
+        TsColumn* c = &w->columns[i];
+
+        if (!c->inSegment)
+            continue;
+
+        putVarint(b, i);
+        putString(b, c->path);
+        putString(b, c->ied);
+        putVarint(b, c->entryCount);
+        putVarint(b, c->entryPos);
+    }
+
+    putVarint(b, entries->size);
+    putBytes(b, entries->data, entries->size);
+
+    uint8_t header[8] = { 'T', 'S', 'I', 'X' };
+    uint8_t trailer[12] = { 'T', 'S', 'F', 'T' };
+
+    putLE(header + 4, b->size, 4);
+    putLE(trailer + 4, w->segmentBytes, 8);
+
+    fwrite(header, 1, sizeof(header), w->file);
+    fwrite(b->data, 1, b->size, w->file);
+    fwrite(trailer, 1, sizeof(trailer), w->file);
+    fclose(w->file);
+
+    w->bytesWritten += sizeof(header) + b->size + sizeof(trailer);
+    w->file = NULL;
+    w->indexCount = 0;
+}
+
+static void addIndexEntry(TsLogWriter* w, int tag, TsColumn* c, long long offset)
+{
+    if (w->indexCount == w->indexCapacity) {
+        w->indexCapacity = w->indexCapacity ? 2 * w->indexCapacity : 1024;
+        w->index = realloc(w->index, w->indexCapacity * sizeof(TsIndexEntry));
+    }
+
+    TsIndexEntry* e = &w->index[w->indexCount++];
+
+    e->tag = tag;
+    e->kind = c->kind;
+    e->bitSize = c->bitSize;
+    e->offset = offset;
+    e->samples = c->count;
+    e->minTime = c->minTime;
+    e->maxTime = c->maxTime;
+}
+
+static void putTime(TsColumn* c, int64_t t)
+{
+    if (c->count == 0) {
+        putVarint(&c->times, zigzag(t));
+        c->lastDelta = 0;
+    }
+    else {
+        int64_t delta = wrapSub(t, c->lastTime);
+        putVarint(&c->times, zigzag(wrapSub(delta, c->lastDelta)));
+        c->lastDelta = delta;
+    }
+
+    c->lastTime = t;
+}
+
+static void putFloat(TsColumn* c, double real)
+{
+    uint64_t bits;
+    memcpy(&bits, &real, sizeof(bits));
+
+    if (c->count == 0) {
+        putBits(&c->values, bits, 64);
+        c->leading = -1;
+    }
+    else {
+        uint64_t x = bits ^ c->lastBits;
+
+        if (x == 0) {
+            putBits(&c->values, 0, 1);
+        }
+        else {
+            int leading = __builtin_clzll(x);
+            int trailing = __builtin_ctzll(x);
+
+            if (leading > 31)
+                leading = 31;
+
+            if (c->leading >= 0 && leading >= c->leading && trailing >= c->trailing) {
+                /* '10': meaningful bits fit the previous window */
+                putBits(&c->values, 2, 2);
+                putBits(&c->values, x >> c->trailing, 64 - c->leading - c->trailing);
+            }
+            else {
+                /* '11': new window, 5 bits leading zeros, 6 bits length - 1 */
+                int length = 64 - leading - trailing;
+
+                putBits(&c->values, 3, 2);
+                putBits(&c->values, leading, 5);
+                putBits(&c->values, length - 1, 6);
+                putBits(&c->values, x >> trailing, length);
+
+                c->leading = leading;
+                c->trailing = trailing;
+            }
+        }
+    }
+
+    c->lastBits = bits;
+}
+
+static void endRun(TsColumn* c)
+{
+    if (c->runLength == 0)
+        return;
+
+    putVarint(&c->values, c->runValue);
+    putVarint(&c->values, c->runLength);
+    c->runLength = 0;
+}
+
+static void putRun(TsColumn* c, uint32_t v)
+{
+    if (c->runLength > 0 && v == c->runValue) {
+        c->runLength++;
+        return;
+    }
+
+    endRun(c);
+    c->runValue = v;
+    c->runLength = 1;
+}
+
+static void putText(TsColumn* c, const char* text)
+{
+    if (c->count > 0 && strcmp(text, c->lastText) == 0) {
+        putVarint(&c->values, 0);
+        return;
+    }
+
+    int len = (int) strnlen(text, TS_TEXT_SIZE - 1);
+
+    putVarint(&c->values, len + 1);
+    putBytes(&c->values, text, len);
+
+    memcpy(c->lastText, text, len);
+    c->lastText[len] = 0;
+}
+
+static void discardBlock(TsLogWriter* w)
+{
+    for (int i = 0; i < w->columnCount; i++) {
+        TsColumn* c = &w->columns[i];
+
+        clearBuffer(&c->times);
+        clearBuffer(&c->values);
+        c->count = 0;
+        c->runLength = 0;
+        c->lastInt = 0;
+    }
+
+    w->samples = 0;
+}
+
+void tsLogFlush(TsLogWriter* w)
+{
+    if (w->samples == 0)
+        return;
+
+    if (w->file) {
+        int full = w->maxSegmentBytes > 0 && w->segmentBytes >= w->maxSegmentBytes;
+        int old = w->maxSegmentMs > 0 && w->blockStart - w->segmentStart >= w->maxSegmentMs;
+
+        if (full || old)
+            tsLogCloseSegment(w);
+    }
+
+    if (!w->file && !openSegment(w, w->blockStart)) {
+        discardBlock(w);
+        return;
+    }
+
+    /* the payload starts after the 8 byte block header */
+    long long payloadOffset = w->segmentBytes + 8;
+
+    TsBuffer* b = &w->block;
+    clearBuffer(b);
+
+    int newTags = 0;
+    int columns = 0;
+
+    for (int i = 0; i < w->columnCount; i++) {
+        if (w->columns[i].count > 0) {
+            columns++;
+            if (!w->columns[i].defined) newTags++;
+        }
+    }
+
+    putVarint(b, newTags);
+
+    for (int i = 0; i < w->columnCount; i++) {
+        TsColumn* c = &w->columns[i];
+
+        if (c->count == 0 || c->defined)
+            continue;
+
+        putVarint(b, i);
+        putByte(b, (uint8_t) c->kind);
+        putByte(b, (uint8_t) c->bitSize);
+        putString(b, c->path);
+        putString(b, c->ied);
+
+        c->defined = 1;
+    }
+
+    putVarint(b, columns);
+
+    for (int i = 0; i < w->columnCount; i++) {
+        TsColumn* c = &w->columns[i];
+
+        if (c->count == 0)
+            continue;
+
+        endRun(c);
+
+        addIndexEntry(w, i, c, payloadOffset + b->size);
+        c->inSegment = 1;
+
+        putVarint(b, i);
+        putVarint(b, c->count);
+        putVarint(b, c->times.size);
+        putBytes(b, c->times.data, c->times.size);
+        putVarint(b, c->values.size);
+        putBytes(b, c->values.data, c->values.size);
+
+        clearBuffer(&c->times);
+        clearBuffer(&c->values);
+        c->count = 0;
+        c->lastInt = 0;
+    }
+
+    uint8_t header[8] = { 'T', 'S', 'B', 'K' };
+    putLE(header + 4, b->size, 4);
+
+    fwrite(header, 1, sizeof(header), w->file);
+    fwrite(b->data, 1, b->size, w->file);
+    fflush(w->file);
+
+    w->segmentBytes += sizeof(header) + b->size;
+    w->bytesWritten += sizeof(header) + b->size;
+    w->samples = 0;
+}
+
+void tsLogAppend(TsLogWriter* w, int tag, const char* ied, const char* path, const TsSample* s)
+{
+    if (tag >= w->columnCount) {
+        int n = w->columnCount ? w->columnCount : 64;
+        while (n <= tag) n *= 2;
+
+        w->columns = realloc(w->columns, n * sizeof(TsColumn));
+        memset(&w->columns[w->columnCount], 0, (n - w->columnCount) * sizeof(TsColumn));
+        w->columnCount = n;
+    }
+
+    TsColumn* c = &w->columns[tag];
+
+    if (!c->path) {
+        c->ied = strdup(ied ? ied : "");
+        c->path = strdup(path);
+        c->kind = s->kind;
+        c->bitSize = s->bitSize;
+    }
+    else if (c->kind != s->kind || (s->kind == TS_BITS && c->bitSize != s->bitSize)) {
+        /* a column has one kind per block: close the block and redefine the tag */
+        tsLogFlush(w);
+        c->kind = s->kind;
+        c->bitSize = s->bitSize;
+        c->defined = 0;
+    }
+
+    if (w->samples == 0 || s->timeMs < w->blockStart)
+        w->blockStart = s->timeMs;
+
+    if (c->count == 0 || s->timeMs < c->minTime) c->minTime = s->timeMs;
+    if (c->count == 0 || s->timeMs > c->maxTime) c->maxTime = s->timeMs;
+
+    putTime(c, s->timeMs);
+
+    switch (s->kind) {
+
+    case TS_BOOLEAN:
+        putRun(c, s->value.boolean ? 1 : 0);
+        break;
+
+    case TS_BITS:
+        putRun(c, s->value.bits);
+        break;
+
+    case TS_INTEGER:
+    case TS_UTC_TIME: {
+        int64_t v = s->kind == TS_INTEGER ? s->value.integer : s->value.utcMs;
+        putVarint(&c->values, zigzag(wrapSub(v, c->lastInt)));
+        c->lastInt = v;
+        break;
+    }
+
+    case TS_FLOAT:
+        putFloat(c, s->value.real);
+        break;
+
+    default:
+        putText(c, s->value.text);
+        break;
+    }
+
+    c->count++;
+    w->samples++;
+
+    if (w->samples >= TS_BLOCK_SAMPLES)
+        tsLogFlush(w);
+}
+
+long long tsLogBytesWritten(TsLogWriter* w)
+{
+    return w->bytesWritten;
+}
+
+void tsLogClose(TsLogWriter* w)
+{
+    tsLogFlush(w);
+    tsLogCloseSegment(w);
+
+    for (int i = 0; i < w->columnCount; i++) {
+        free(w->columns[i].ied);
+        free(w->columns[i].path);
+        free(w->columns[i].times.data);
+        free(w->columns[i].values.data);
+    }
+
+    free(w->columns);
+    free(w->index);
+    free(w->indexEntries.data);
+    free(w->block.data);
+    free(w);
+}
+
+/* ===================== Reader ===================== */
+
+typedef struct {
+    const uint8_t* data;
+    int size;
+    int pos;
+    long long bits;
+    int error;
+} TsInput;
+
+static uint8_t getByte(TsInput* in)
+{
+    if (in->pos >= in->size) {
+        in->error = 1;
+        return 0;
+    }
+    return in->data[in->pos++];
+}
+
+static uint64_t getVarint(TsInput* in)
+{
+    uint64_t v = 0;
+
+    for (int shift = 0; shift < 64; shift += 7) {
+        uint8_t b = getByte(in);
+        v |= (uint64_t) (b & 0x7f) << shift;
+        if (!(b & 0x80))
+            return v;
+    }
+
+    in->error = 1;
+    return v;
+}
+
+static uint64_t getBits(TsInput* in, int n)
+{
+    uint64_t v = 0;
+
+    for (int i = 0; i < n; i++) {
+        long long byte = in->bits >> 3;
+
+        if (byte >= in->size) {
+            in->error = 1;
+            return v;
+        }
+
+        v = (v << 1) | ((in->data[byte] >> (7 - (in->bits & 7))) & 1);
+        in->bits++;
+    }
+
+    return v;
+}
+
+typedef struct {
+    char* ied;              /* "" in version 1 segments */
+    char* path;
+    TsKind kind;
+    int bitSize;
+} TsTag;
+
+/* Name of a tag as stored: varint length + bytes, still in the input */
+typedef struct {
+    const uint8_t* data;
+    int len;
+} TsName;
+
+typedef struct {
+    TsTag* tags;            /* indexed by tag */
+    int count;
+} TsTagTable;
+
+typedef struct {
+    TsRow* rows;
+    int count;
+    int capacity;
+} TsRowBuffer;
+
+struct sTsLogReader {
+    FILE* file;
+    int version;
+
+    TsTagTable tags;
+
+    uint8_t* block;
+    int blockCapacity;
+
+    TsRowBuffer rows;
+};
+
+TsLogReader* tsReadOpen(const char* fileName)
+{
+    FILE* f = fopen(fileName, "rb");
+
+    if (!f)
+        return NULL;
+
+    uint8_t header[8];
+
+    if (fread(header, 1, sizeof(header), f) != sizeof(header) || memcmp(header, "MTSL", 4) != 0
+            || header[4] < 1 || header[4] > TS_VERSION) {
+        fclose(f);
+        return NULL;
+    }
+
+    TsLogReader* r = calloc(1, sizeof(TsLogReader));
+    r->file = f;
+    r->version = header[4];
+
+    return r;
+}
+
+static char* copyName(TsName name)
+{
+    char* s = malloc(name.len + 1);
+
+    memcpy(s, name.data, name.len);
+    s[name.len] = 0;
+
+    return s;
+}
+
+static void defineTag(TsTagTable* table, int tag, TsKind kind, int bitSize, TsName path, TsName ied)
+{
+    if (tag >= table->count) {
+        int n = table->count ? table->count : 64;
+        while (n <= tag) n *= 2;
+
+        table->tags = realloc(table->tags, n * sizeof(TsTag));
+        memset(&table->tags[table->count], 0, (n - table->count) * sizeof(TsTag));
+        table->count = n;
+    }
+
+    TsTag* t = &table->tags[tag];
+
+    free(t->ied);
+    free(t->path);
+    t->ied = copyName(ied);
+    t->path = copyName(path);
+
+    t->kind = kind;
+    t->bitSize = bitSize;
+}
+
+static void freeTags(TsTagTable* table)
+{
+    for (int i = 0; i < table->count; i++) {
+        free(table->tags[i].ied);
+        free(table->tags[i].path);
+    }
+
+    free(table->tags);
+}
+
+static TsRow* addRow(TsRowBuffer* b)
+{
+    if (b->count == b->capacity) {
+        b->capacity = b->capacity ? 2 * b->capacity : 1024;
+        b->rows = realloc(b->rows, b->capacity * sizeof(TsRow));
+    }
+
+    TsRow* row = &b->rows[b->count++];
+    memset(row, 0, sizeof(*row));
+    return row;
+}
+
+/* Path, and from version 2 on the IED, of a tag definition */
+static int getTagName(TsInput* in, int version, TsName* path, TsName* ied)
+{
+    TsName* names[2] = { path, ied };
+
+    ied->data = NULL;
+    ied->len = 0;
+
+    for (int i = 0; i < (version >= 2 ? 2 : 1); i++) {
+        names[i]->len = (int) getVarint(in);
+
+        if (in->error || names[i]->len < 0 || in->pos + names[i]->len > in->size)
+            return 0;
+
+        names[i]->data = in->data + in->pos;
+        in->pos += names[i]->len;
+    }
+
+    return 1;
+}
+
+/* Column header: tag, sample count, time bytes, value bytes */
+static int parseColumn(TsInput* in, int* tag, int* samples, TsInput* times, TsInput* values)
+{
+    *tag = (int) getVarint(in);
+    *samples = (int) getVarint(in);
+
+    int timeLen = (int) getVarint(in);
+    if (in->error || *tag < 0 || *samples < 0 || timeLen < 0 || in->pos + timeLen > in->size)
+        return 0;
+
+    TsInput t = { in->data + in->pos, timeLen, 0, 0, 0 };
+    *times = t;
+    in->pos += timeLen;
+
+    int valueLen = (int) getVarint(in);
+    if (in->error || valueLen < 0 || in->pos + valueLen > in->size)
+        return 0;
+
+    TsInput v = { in->data + in->pos, valueLen, 0, 0, 0 };
+    *values = v;
+    in->pos += valueLen;
+
+    return 1;
+}
+
+/* Decode one column into rows */
+static int readColumn(const TsTag* tag, int tagId, int samples,
+                      TsInput* times, TsInput* values, TsRowBuffer* out)
+{
+    int64_t time = 0;
+    int64_t delta = 0;
+    int64_t lastInt = 0;
+
+    uint64_t lastBits = 0;
+    int leading = 0;
+    int trailing = 0;
+
+    uint32_t runValue = 0;
+    uint64_t runLeft = 0;
+
+    char lastText[TS_TEXT_SIZE] = "";
+
+    for (int i = 0; i < samples; i++) {
+        TsRow* row = addRow(out);
+        TsSample* s = &row->sample;
+
+        row->tag = tagId;
+        s->kind = tag->kind;
+        s->bitSize = tag->bitSize;
+
+        if (i == 0) {
+            time = unzigzag(getVarint(times));
+        }
+        else {
+            delta = wrapAdd(delta, unzigzag(getVarint(times)));
+            time = wrapAdd(time, delta);
+        }
+        s->timeMs = time;
+
+        switch (tag->kind) {
+
+        case TS_BOOLEAN:
+        case TS_BITS:
+            if (runLeft == 0) {
+                runValue = (uint32_t) getVarint(values);
+                runLeft = getVarint(values);
+                if (runLeft == 0) return 0;
+            }
+            runLeft--;
+
+            if (tag->kind == TS_BOOLEAN)
+                s->value.boolean = (int) runValue;
+            else
+                s->value.bits = runValue;
+            break;
+
+        case TS_INTEGER:
+        case TS_UTC_TIME:
+            lastInt = wrapAdd(lastInt, unzigzag(getVarint(values)));
+
+            if (tag->kind == TS_INTEGER)
+                s->value.integer = lastInt;
+            else
+                s->value.utcMs = lastInt;
+            break;
+
+        case TS_FLOAT:
+            if (i == 0) {
+                lastBits = getBits(values, 64);
+            }
+            else if (getBits(values, 1)) {
+                if (getBits(values, 1)) {
+                    leading = (int) getBits(values, 5);
+                    int length = (int) getBits(values, 6) + 1;
+                    trailing = 64 - leading - length;
+                    if (trailing < 0) return 0;
+                }
+                lastBits ^= getBits(values, 64 - leading - trailing) << trailing;
+            }
+            memcpy(&s->value.real, &lastBits, sizeof(double));
+            break;
+
+        case TS_TEXT: {
+            int len = (int) getVarint(values);
+
+            if (len > 0) {
+                len--;
+                if (len >= TS_TEXT_SIZE || values->pos + len > values->size) return 0;
+
+                memcpy(lastText, values->data + values->pos, len);
+                lastText[len] = 0;
+                values->pos += len;
+            }
+            strcpy(s->value.text, lastText);
+            break;
+        }
+
+        default:
+            return 0;
+        }
+
+        if (times->error || values->error)
+            return 0;
+    }
+
+    return 1;
+}
+
+static int compareRows(const void* a, const void* b)
+{
+    const TsRow* ra = (const TsRow*) a;
+    const TsRow* rb = (const TsRow*) b;
+
+    if (ra->sample.timeMs != rb->sample.timeMs)
+        return ra->sample.timeMs < rb->sample.timeMs ? -1 : 1;
+
+    return ra->tag - rb->tag;
+}
+
+int tsReadBlock(TsLogReader* r, TsRow** rows)
+{
+    uint8_t header[8];
+
+    size_t got = fread(header, 1, sizeof(header), r->file);
+
+    /* end of the file, or the index of a closed segment */
+    if (got == 0 || (got == sizeof(header) && memcmp(header, "TSIX", 4) == 0))
+        return 0;
+
+    if (got != sizeof(header) || memcmp(header, "TSBK", 4) != 0)
+        return -1;
+
+    int size = (int) getLE(header + 4, 4);
+
+    if (size > r->blockCapacity) {
+        r->block = realloc(r->block, size);
+        r->blockCapacity = size;
+    }
+
+    if ((int) fread(r->block, 1, size, r->file) != size)
+        return -1;
+
+    TsInput in = { r->block, size, 0, 0, 0 };
+
+    int newTags = (int) getVarint(&in);
+
+    for (int i = 0; i < newTags && !in.error; i++) {
+        int tag = (int) getVarint(&in);
+        TsKind kind = (TsKind) getByte(&in);
+        int bitSize = getByte(&in);
+        TsName path, ied;
+
+        if (tag < 0 || !getTagName(&in, r->version, &path, &ied))
+            return -1;
+
+        defineTag(&r->tags, tag, kind, bitSize, path, ied);
+    }
+
+    int columns = (int) getVarint(&in);
+
+    r->rows.count = 0;
+
+    for (int i = 0; i < columns && !in.error; i++) {
+        int tag;
+        int samples;
+        TsInput times;
+        TsInput values;
+
+        if (!parseColumn(&in, &tag, &samples, &times, &values))
+            return -1;
+
+        if (tag >= r->tags.count || !r->tags.tags[tag].path)
+            return -1;
+
+        if (!readColumn(&r->tags.tags[tag], tag, samples, &times, &values, &r->rows))
+            return -1;
+    }
+
+    if (in.error)
+        return -1;
+
+    qsort(r->rows.rows, r->rows.count, sizeof(TsRow), compareRows);
+
+    *rows = r->rows.rows;
+    return r->rows.count;
+}
+
+const char* tsReadTagPath(TsLogReader* r, int tag)
+{
+    return (tag >= 0 && tag < r->tags.count && r->tags.tags[tag].path) ? r->tags.tags[tag].path : "?";
+}
+
+const char* tsReadTagIed(TsLogReader* r, int tag)
+{
+    return (tag >= 0 && tag < r->tags.count && r->tags.tags[tag].ied) ? r->tags.tags[tag].ied : "?";
+}
+
+void tsReadClose(TsLogReader* r)
+{
+    fclose(r->file);
+
+    freeTags(&r->tags);
+    free(r->block);
+    free(r->rows.rows);
+    free(r);
+}
+
+/* ===================== Segment Queries ===================== */
+
+typedef struct {
+    int pos;                /* in the entry area of the index */
+    int count;
+} TsEntryRun;
+
+struct sTsSegment {
+    const uint8_t* data;    /* the whole file, mapped read-only */
+    long long size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+    int version;
+
+    TsTagTable tags;        /* names only; kinds are per index entry */
+
+    /* closed segments: where each tag's index entries are, decoded per query */
+    TsEntryRun* runs;       /* by tag */
+    const uint8_t* entries;
+    int entriesSize;
+
+    TsIndexEntry* index;    /* scanned segments: all entries by tag, then offset; else one tag's */
+    int indexCount;
+    int indexCapacity;
+
+    int64_t minTime;
+    int64_t maxTime;
+
+    TsRowBuffer rows;
+};
+
+static int mapSegment(TsSegment* seg, const char* fileName)
+{
+#ifdef _WIN32
+    seg->file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (seg->file == INVALID_HANDLE_VALUE)
+        return 0;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(seg->file, &size) || size.QuadPart < 8)
+        return 0;
+
+    seg->mapping = CreateFileMappingA(seg->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!seg->mapping)
+        return 0;
+
+    seg->data = MapViewOfFile(seg->mapping, FILE_MAP_READ, 0, 0, 0);
+    seg->size = size.QuadPart;
+#else
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0)
+        return 0;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 8) {
+        close(fd);
+        return 0;
+    }
+
+    void* p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    seg->data = p == MAP_FAILED ? NULL : p;
+    seg->size = st.st_size;
+#endif
+
+    return seg->data != NULL;
+}
+
+static void unmapSegment(TsSegment* seg)
+{
+#ifdef _WIN32
+    if (seg->data) UnmapViewOfFile(seg->data);
+    if (seg->mapping) CloseHandle(seg->mapping);
+    if (seg->file && seg->file != INVALID_HANDLE_VALUE) CloseHandle(seg->file);
+#else
+    if (seg->data) munmap((void*) seg->data, seg->size);
+#endif
+}
+
+static TsIndexEntry* addSegmentEntry(TsSegment* seg)
+{
+    if (seg->indexCount == seg->indexCapacity) {
+        seg->indexCapacity = seg->indexCapacity ? 2 * seg->indexCapacity : 1024;
+        seg->index = realloc(seg->index, seg->indexCapacity * sizeof(TsIndexEntry));
+    }
+
+    return &seg->index[seg->indexCount++];
+}
+
+/* Index written by the logger when it closed the segment; only the tag directory is read here */
+static int loadIndex(TsSegment* seg)
+{
+    if (seg->size < 8 + 8 + 12)
+        return 0;
+
+    const uint8_t* trailer = seg->data + seg->size - 12;
+
+    if (memcmp(trailer, "TSFT", 4) != 0)
+        return 0;
+
+    long long offset = (long long) getLE(trailer + 4, 8);
+
+    if (offset < 8 || offset + 8 > seg->size - 12 || memcmp(seg->data + offset, "TSIX", 4) != 0)
+        return 0;
+
+    int size = (int) getLE(seg->data + offset + 4, 4);
+
+    if (offset + 8 + size > seg->size - 12)
+        return 0;
+
+    TsInput in = { seg->data + offset + 8, size, 0, 0, 0 };
+
+    seg->minTime = unzigzag(getVarint(&in));
+    seg->maxTime = unzigzag(getVarint(&in));
+
+    int tags = (int) getVarint(&in);
+
+    for (int i = 0; i < tags && !in.error; i++) {
+        int tag = (int) getVarint(&in);
+        TsName path, ied;
+
+        if (tag < 0 || !getTagName(&in, seg->version, &path, &ied))
+            return 0;
+
+        int oldCount = seg->tags.count;
+        defineTag(&seg->tags, tag, TS_TEXT, 0, path, ied);
+
+        if (seg->tags.count != oldCount) {
+            seg->runs = realloc(seg->runs, seg->tags.count * sizeof(TsEntryRun));
+            memset(&seg->runs[oldCount], 0, (seg->tags.count - oldCount) * sizeof(TsEntryRun));
+        }
+
+        seg->runs[tag].count = (int) getVarint(&in);
+        seg->runs[tag].pos = (int) getVarint(&in);
+    }
+
+    seg->entriesSize = (int) getVarint(&in);
+
+    if (in.error || seg->entriesSize < 0 || in.pos + seg->entriesSize > in.size)
+        return 0;
+
+    seg->entries = in.data + in.pos;
+
+    return 1;
+}
+
+/* Entries of one tag from the index of a closed segment */
+static int loadEntryRun(TsSegment* seg, int tag)
+{
+    TsEntryRun* run = &seg->runs[tag];
+    TsInput in = { seg->entries, seg->entriesSize, run->pos, 0, 0 };
+
+    seg->indexCount = 0;
+
+    for (int i = 0; i < run->count && !in.error; i++) {
+        TsIndexEntry* e = addSegmentEntry(seg);
+
+        e->tag = tag;
+        e->kind = (TsKind) getByte(&in);
+        e->bitSize = getByte(&in);
+        e->offset = (long long) getVarint(&in);
+        e->samples = (int) getVarint(&in);
+        e->minTime = unzigzag(getVarint(&in));
+        e->maxTime = unzigzag(getVarint(&in));
+
+        if (e->offset < 8 || e->offset >= seg->size)
+            return 0;
+    }
+
+    return !in.error;
+}
+
+/* No index (segment still open or not closed cleanly): walk the blocks */
+static int scanBlocks(TsSegment* seg)
+{
+    long long pos = 8;
+
+    /* kind of every tag as of the current block */
+    TsTagTable kinds = { NULL, 0 };
+
+    while (pos + 8 <= seg->size && memcmp(seg->data + pos, "TSBK", 4) == 0) {
+        int size = (int) getLE(seg->data + pos + 4, 4);
+
+        /* a block still being written */
+        if (pos + 8 + size > seg->size)
+            break;
+
+        TsInput in = { seg->data + pos + 8, size, 0, 0, 0 };
+
+        int newTags = (int) getVarint(&in);
+
+        for (int i = 0; i < newTags && !in.error; i++) {
+            int tag = (int) getVarint(&in);
+            TsKind kind = (TsKind) getByte(&in);
+            int bitSize = getByte(&in);
+            TsName path, ied;
+
+            if (tag < 0 || !getTagName(&in, seg->version, &path, &ied))
+                break;
+
+            defineTag(&seg->tags, tag, kind, bitSize, path, ied);
+            defineTag(&kinds, tag, kind, bitSize, path, ied);
+        }
+
+        int columns = (int) getVarint(&in);
+
+        for (int i = 0; i < columns && !in.error; i++) {
+            long long columnOffset = pos + 8 + in.pos;
+            int tag;
+            int samples;
+            TsInput times;
+            TsInput values;
+
+            if (!parseColumn(&in, &tag, &samples, &times, &values) || tag >= kinds.count || !kinds.tags[tag].path)
+                break;
+
+            TsIndexEntry* e = addSegmentEntry(seg);
+
+            e->tag = tag;
+            e->kind = kinds.tags[tag].kind;
+            e->bitSize = kinds.tags[tag].bitSize;
+            e->offset = columnOffset;
+            e->samples = samples;
+            e->minTime = TS_TIME_MAX;
+            e->maxTime = TS_TIME_MIN;
+
+            /* only the time column is decoded */
+            int64_t time = 0;
+            int64_t delta = 0;
+
+            for (int k = 0; k < samples && !times.error; k++) {
+                if (k == 0) {
+                    time = unzigzag(getVarint(&times));
+                }
+                else {
+                    delta = wrapAdd(delta, unzigzag(getVarint(&times)));
+                    time = wrapAdd(time, delta);
+                }
+
+                if (time < e->minTime) e->minTime = time;
+                if (time > e->maxTime) e->maxTime = time;
+            }
+        }
+
+        pos += 8 + size;
+    }
+
+    freeTags(&kinds);
+
+    qsort(seg->index, seg->indexCount, sizeof(TsIndexEntry), compareIndexEntries);
+
+    return 1;
+}
+
+TsSegment* tsSegmentOpen(const char* fileName)
+{
+    TsSegment* seg = calloc(1, sizeof(TsSegment));
+
+    if (!mapSegment(seg, fileName) || memcmp(seg->data, "MTSL", 4) != 0
+            || seg->data[4] < 1 || seg->data[4] > TS_VERSION) {
+        tsSegmentClose(seg);
+        return NULL;
+    }
+
+    seg->version = seg->data[4];
+
+    if (loadIndex(seg))
+        return seg;
+
+    freeTags(&seg->tags);
+    memset(&seg->tags, 0, sizeof(seg->tags));
+    free(seg->runs);
+    seg->runs = NULL;
+
+    scanBlocks(seg);
+
+    seg->minTime = TS_TIME_MAX;
+    seg->maxTime = TS_TIME_MIN;
+
+    for (int i = 0; i < seg->indexCount; i++) {
+        if (seg->index[i].minTime < seg->minTime) seg->minTime = seg->index[i].minTime;
+        if (seg->index[i].maxTime > seg->maxTime) seg->maxTime = seg->index[i].maxTime;
+    }
+
+    return seg;
+}
+
+void tsSegmentRange(TsSegment* seg, int64_t* minTime, int64_t* maxTime)
+{
+    *minTime = seg->minTime;
+    *maxTime = seg->maxTime;
+}
+
+/* Append the samples of one tag in the range to seg->rows */
+static int queryTag(TsSegment* seg, int tag, int64_t from, int64_t to)
+{
+    int lo = 0;
+    int hi = seg->indexCount;
+
+    if (seg->runs) {
+        if (!loadEntryRun(seg, tag))
+            return 0;
+        hi = 0;
+    }
+
+    /* first index entry of the tag */
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (seg->index[mid].tag < tag) lo = mid + 1; else hi = mid;
+    }
+
+    for (int i = lo; i < seg->indexCount && seg->index[i].tag == tag; i++) {
+        TsIndexEntry* e = &seg->index[i];
+
+        if (e->maxTime < from || e->minTime > to)
+            continue;
+
+        long long left = seg->size - e->offset;
+        TsInput in = { seg->data + e->offset, left < 0x7fffffff ? (int) left : 0x7fffffff, 0, 0, 0 };
+        int columnTag;
+        int samples;
+        TsInput times;
+        TsInput values;
+
+        if (!parseColumn(&in, &columnTag, &samples, &times, &values) || columnTag != tag)
+            return 0;
+
+        TsTag kind = { NULL, NULL, e->kind, e->bitSize };
+        int first = seg->rows.count;
+
+        if (!readColumn(&kind, tag, samples, &times, &values, &seg->rows))
+            return 0;
+
+        /* drop the samples of the column outside the range */
+        int n = first;
+        for (int k = first; k < seg->rows.count; k++) {
+            int64_t t = seg->rows.rows[k].sample.timeMs;
+            if (t >= from && t <= to)
+                seg->rows.rows[n++] = seg->rows.rows[k];
+        }
+        seg->rows.count = n;
+    }
+
+    return 1;
+}
+
+int tsSegmentQuery(TsSegment* seg, const char* ied, const char* path, int64_t from, int64_t to, TsRow** rows)
+{
+    seg->rows.count = 0;
+    *rows = NULL;
+
+    if (to < seg->minTime || from > seg->maxTime)
+        return 0;
+
+    /* the same path on several IEDs is one tag per IED */
+    for (int i = 0; i < seg->tags.count; i++) {
+        const TsTag* t = &seg->tags.tags[i];
+
+        if (!t->path || strcmp(t->path, path) != 0 || (ied && *ied && strcmp(t->ied, ied) != 0))
+            continue;
+
+        if (!queryTag(seg, i, from, to))
+            return -1;
+    }
+
+    qsort(seg->rows.rows, seg->rows.count, sizeof(TsRow), compareRows);
+
+    *rows = seg->rows.rows;
+    return seg->rows.count;
+}
+
+const char* tsSegmentTagIed(TsSegment* seg, int tag)
+{
+    return (tag >= 0 && tag < seg->tags.count && seg->tags.tags[tag].ied) ? seg->tags.tags[tag].ied : "?";
+}
+
+void tsSegmentClose(TsSegment* seg)
+{
+    unmapSegment(seg);
+    freeTags(&seg->tags);
+    free(seg->runs);
+    free(seg->index);
+    free(seg->rows.rows);
+    free(seg);
+}
@@ -0,0 +1,125 @@
+/*
+ * Binary time-series log (.tsl)
+ *
+ * Samples are collected per tag and written in blocks, one column per tag:
+ *   timestamps     delta-of-delta, zigzag varints (1 byte for a steady period)
+ *   floats         XOR with the previous value (Gorilla), bit packed
+ *   integers, UTC  zigzag varint deltas
+ *   booleans, bit strings (quality)   run-length (value, count) pairs
+ *   text           varint length + bytes, 0 = same as the previous sample
+ * Every block starts with the tags it introduces (id, kind, reference, IED) and
+ * can be decoded on its own.
+ *
+ * The log is written as segments of bounded size and time span, named
+ * <base>-<first sample time>.tsl. A closed segment ends with an index of its
+ * columns (tag -> file offset, sample count, min/max time), so a query maps
+ * the file and decodes only the columns of the tag and time range asked for.
+ * A segment without an index (still open, or the logger was killed) is
+ * indexed by walking its blocks.
+ *
+ * Segment: "MTSL" version(1) reserved(3)  block*  [index]
+ * Block:   "TSBK" payloadLength(u32 LE)  payload
+ * Index:   "TSIX" payloadLength(u32 LE)  payload  "TSFT" indexOffset(u64 LE)
+ */
+
+#ifndef TSLOG_H
+#define TSLOG_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define TS_TEXT_SIZE 96
+
+/* Samples kept in memory before a block is written */
+#define TS_BLOCK_SAMPLES 65536
+
+#define TS_TIME_MIN INT64_MIN
+#define TS_TIME_MAX INT64_MAX
+
+typedef enum {
+    TS_BOOLEAN = 1,
+    TS_INTEGER,
+    TS_FLOAT,
+    TS_UTC_TIME,
+    TS_BITS,        /* bit strings up to 32 bits, e.g. quality */
+    TS_TEXT
+} TsKind;
+
+typedef struct {
+    int64_t timeMs;             /* ms since 1970-01-01 UTC */
+    TsKind kind;
+    int bitSize;                /* TS_BITS only */
+    union {
+        int boolean;
+        int64_t integer;
+        double real;
+        int64_t utcMs;
+        uint32_t bits;          /* bit i of the bit string is (bits >> i) & 1 */
+        char text[TS_TEXT_SIZE];
+    } value;
+} TsSample;
+
+/* Text form used by the CSV/JSON logs */
+void tsFormatValue(const TsSample* s, char* out, int outLen);
+void tsFormatTime(int64_t timeMs, char* out, int outLen);
+
+/* ===================== Writer ===================== */
+
+typedef struct sTsLogWriter TsLogWriter;
+
+/* A new segment is started when one exceeds maxSegmentBytes or spans maxSegmentMs (0: no limit) */
+TsLogWriter* tsLogCreate(const char* baseName, long long maxSegmentBytes, int64_t maxSegmentMs);
+
+/* tag is a small dense id, one per IED and path; both are copied when the tag is first seen */
+void tsLogAppend(TsLogWriter* w, int tag, const char* ied, const char* path, const TsSample* s);
+
+/* Write the samples collected so far as one block */
+void tsLogFlush(TsLogWriter* w);
+
+/* Index and close the current segment; the next block starts a new one */
+void tsLogCloseSegment(TsLogWriter* w);
+
+long long tsLogBytesWritten(TsLogWriter* w);
+
+void tsLogClose(TsLogWriter* w);
+
+/* ===================== Reader ===================== */
+
+typedef struct {
+    int tag;
+    TsSample sample;
+} TsRow;
+
+typedef struct sTsLogReader TsLogReader;
+
+TsLogReader* tsReadOpen(const char* fileName);
+
+/* Decode the next block, rows sorted by time. Returns the row count, 0 at the end, -1 if corrupt */
+int tsReadBlock(TsLogReader* r, TsRow** rows);
+
+const char* tsReadTagPath(TsLogReader* r, int tag);
+
+/* "host:port" of the tag, "" in segments written before tags carried the IED */
+const char* tsReadTagIed(TsLogReader* r, int tag);
+
+void tsReadClose(TsLogReader* r);
+
+/* ===================== Segment Queries ===================== */
+
+typedef struct sTsSegment TsSegment;
+
+/* Map a segment and load its index (or build it from the blocks) */
+TsSegment* tsSegmentOpen(const char* fileName);
+
+/* Time range of all samples in the segment */
+void tsSegmentRange(TsSegment* seg, int64_t* minTime, int64_t* maxTime);
+
+/* Samples of a path with from <= time <= to, sorted by time; ied NULL or "" takes the path of
+ * every IED, TsRow.tag tells them apart. Returns the row count, -1 if corrupt */
+int tsSegmentQuery(TsSegment* seg, const char* ied, const char* path, int64_t from, int64_t to, TsRow** rows);
+
+const char* tsSegmentTagIed(TsSegment* seg, int tag);
+
+void tsSegmentClose(TsSegment* seg);
+
+#endif /* TSLOG_H */
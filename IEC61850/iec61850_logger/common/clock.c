@@ -0,0 +1,152 @@
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "clock.h"
+
+/* System time and counter taken at the same moment */
+typedef struct {
+    int64_t wallUs;
+    int64_t counter;
+} Anchor;
+
+/*
+ * Two anchors: clockResync() fills the one not in use, then switches. A
+ * reader only sees a half written anchor if it is preempted across two
+ * resyncs, CLOCK_RESYNC_MS apart.
+ */
+static Anchor anchors[2];
+static volatile int current = -1;
+
+#ifdef _WIN32
+
+static int64_t counterFrequency;
+
+typedef VOID (WINAPI *PreciseTimeFunction)(LPFILETIME);
+
+static int64_t counterNow(void)
+{
+    LARGE_INTEGER c;
+    QueryPerformanceCounter(&c);
+    return c.QuadPart;
+}
+
+static int64_t fileTimeToUs(FILETIME ft)
+{
+    int64_t t = ((int64_t) ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+    return (t - 116444736000000000LL) / 10;
+}
+
+static void takeAnchor(Anchor* a)
+{
+    static PreciseTimeFunction precise;
+    static int looked;
+    FILETIME ft;
+
+    if (!looked) {
+        /* Windows 8 and later */
+        precise = (PreciseTimeFunction) GetProcAddress(GetModuleHandleA("kernel32.dll"),
+                                                       "GetSystemTimePreciseAsFileTime");
+        looked = 1;
+    }
+
+    if (precise) {
+        int64_t before = counterNow();
+        precise(&ft);
+        a->counter = before + (counterNow() - before) / 2;
+        a->wallUs = fileTimeToUs(ft);
+        return;
+    }
+
+    /*
+     * GetSystemTimeAsFileTime only moves once per timer tick (up to 15.6 ms):
+     * wait for the next tick, the moment the time read is exact.
+     */
+    FILETIME start;
+    GetSystemTimeAsFileTime(&start);
+
+    do {
+        GetSystemTimeAsFileTime(&ft);
+        a->counter = counterNow();
+    } while (ft.dwLowDateTime == start.dwLowDateTime && ft.dwHighDateTime == start.dwHighDateTime);
+
+    a->wallUs = fileTimeToUs(ft);
+}
+
+static int64_t counterToUs(int64_t ticks)
+{
+    /* split so the multiplication cannot overflow for long uptimes */
+    return ticks / counterFrequency * 1000000
+         + ticks % counterFrequency * 1000000 / counterFrequency;
+}
+
+#else
+
+static int64_t counterNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void takeAnchor(Anchor* a)
+{
+    struct timespec ts;
+    int64_t before = counterNow();
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    a->counter = before + (counterNow() - before) / 2;
+    a->wallUs = (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int64_t counterToUs(int64_t ticks)
+{
+    return ticks / 1000;
+}
+
+#endif
+
+void clockInit(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    counterFrequency = freq.QuadPart;
+#endif
+
+    takeAnchor(&anchors[0]);
+    current = 0;
+}
+
+void clockResync(void)
+{
+    if (current < 0) {
+        clockInit();
+        return;
+    }
+
+    int next = current ^ 1;
+
+    takeAnchor(&anchors[next]);
+
+    __atomic_store_n(&current, next, __ATOMIC_RELEASE);
+}
+
+int64_t clockWallUs(void)
+{
+    /* programs with a single thread may skip clockInit() */
+    if (current < 0)
+        clockInit();
+
+    const Anchor* a = &anchors[__atomic_load_n(&current, __ATOMIC_ACQUIRE)];
+
+    return a->wallUs + counterToUs(counterNow() - a->counter);
+}
+
+int64_t clockWallMs(void)
+{
+    return clockWallUs() / 1000;
+}
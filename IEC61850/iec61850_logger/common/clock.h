@@ -0,0 +1,32 @@
+/*
+ * Wall clock for log records
+ *
+ * The system time is read once as an anchor, together with the monotonic
+ * counter (QueryPerformanceCounter, CLOCK_MONOTONIC); after that the time
+ * is the anchor plus the counter. That is microsecond resolution at the
+ * cost of a counter read, and within one anchor stamps taken one after the
+ * other are never out of order. clockResync() takes a new anchor, so the
+ * clock follows NTP corrections: a stamp taken after it can be earlier than
+ * one taken before, by the drift and correction since the last anchor.
+ * Between two anchors the counter drifts a few ms per hour at most.
+ */
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stdint.h>
+
+/* How often a long running program should call clockResync() */
+#define CLOCK_RESYNC_MS 60000
+
+/* Take the first anchor; call before the threads that read the clock start */
+void clockInit(void);
+
+/* Take a new anchor. One thread at a time; readers are not blocked */
+void clockResync(void);
+
+/* Microseconds / milliseconds since 1970-01-01 UTC */
+int64_t clockWallUs(void);
+int64_t clockWallMs(void);
+
+#endif /* CLOCK_H */
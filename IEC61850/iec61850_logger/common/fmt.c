@@ -0,0 +1,496 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "fmt.h"
+
+static const char digitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/* Copy n bytes, cut at end - 1 */
+static char* put(char* p, char* end, const char* s, int n)
+{
+    if (n > end - 1 - p)
+        n = (int) (end - 1 - p);
+
+    if (n > 0) {
+        memcpy(p, s, n);
+        p += n;
+    }
+
+    return p;
+}
+
+static char* putChar(char* p, char* end, char c)
+{
+    if (p < end - 1)
+        *p++ = c;
+
+    return p;
+}
+
+/* Digits of value right-aligned ending at out; returns the first digit */
+static char* digitsBackwards(char* out, uint64_t value)
+{
+    while (value >= 100) {
+        unsigned pair = (unsigned) (value % 100) * 2;
+        value /= 100;
+        *--out = digitPairs[pair + 1];
+        *--out = digitPairs[pair];
+    }
+
+    if (value >= 10) {
+        unsigned pair = (unsigned) value * 2;
+        *--out = digitPairs[pair + 1];
+        *--out = digitPairs[pair];
+    }
+    else {
+        *--out = (char) ('0' + value);
+    }
+
+    return out;
+}
+
+/* ===================== Integers ===================== */
+
+char* fmtBoolean(char* p, char* end, int value)
+{
+    return value ? put(p, end, "TRUE", 4) : put(p, end, "FALSE", 5);
+}
+
+char* fmtUint64(char* p, char* end, uint64_t value)
+{
+    char text[FMT_NUMBER_SIZE];
+    char* first = digitsBackwards(text + sizeof(text), value);
+
+    return put(p, end, first, (int) (text + sizeof(text) - first));
+}
+
+char* fmtInt64(char* p, char* end, int64_t value)
+{
+    char text[FMT_NUMBER_SIZE];
+    uint64_t magnitude = value < 0 ? 0 - (uint64_t) value : (uint64_t) value;
+    char* first = digitsBackwards(text + sizeof(text), magnitude);
+
+    if (value < 0)
+        *--first = '-';
+
+    return put(p, end, first, (int) (text + sizeof(text) - first));
+}
+
+/* ===================== Floats ===================== */
+
+/*
+ * Shortest round-trip digits of a float, after Ulf Adams, "Ryu: fast
+ * float-to-string conversion" (PLDI 2018): the interval of decimals that
+ * read back as the float is computed with 64-bit multiplications by
+ * precomputed powers of 5, and digits are dropped while the interval still
+ * holds a shorter one.
+ */
+
+#define FLOAT_MANTISSA_BITS 23
+#define FLOAT_BIAS 127
+#define FLOAT_POW5_INV_BITCOUNT 59
+#define FLOAT_POW5_BITCOUNT 61
+
+/* ceil(2^(pow5bits(i) - 1 + 59) / 5^i) */
+static const uint64_t floatPow5InvSplit[31] = {
+    576460752303423489u, 461168601842738791u, 368934881474191033u,
+    295147905179352826u, 472236648286964522u, 377789318629571618u,
+    302231454903657294u, 483570327845851670u, 386856262276681336u,
+    309485009821345069u, 495176015714152110u, 396140812571321688u,
+    316912650057057351u, 507060240091291761u, 405648192073033409u,
+    324518553658426727u, 519229685853482763u, 415383748682786211u,
+    332306998946228969u, 531691198313966350u, 425352958651173080u,
+    340282366920938464u, 544451787073501542u, 435561429658801234u,
+    348449143727040987u, 557518629963265579u, 446014903970612463u,
+    356811923176489971u, 570899077082383953u, 456719261665907162u,
+    365375409332725730u
+};
+
+/* 5^i scaled to 61 bits */
+static const uint64_t floatPow5Split[47] = {
+    1152921504606846976u, 1441151880758558720u, 1801439850948198400u,
+    2251799813685248000u, 1407374883553280000u, 1759218604441600000u,
+    2199023255552000000u, 1374389534720000000u, 1717986918400000000u,
+    2147483648000000000u, 1342177280000000000u, 1677721600000000000u,
+    2097152000000000000u, 1310720000000000000u, 1638400000000000000u,
+    2048000000000000000u, 1280000000000000000u, 1600000000000000000u,
+    2000000000000000000u, 1250000000000000000u, 1562500000000000000u,
+    1953125000000000000u, 1220703125000000000u, 1525878906250000000u,
+    1907348632812500000u, 1192092895507812500u, 1490116119384765625u,
+    1862645149230957031u, 1164153218269348144u, 1455191522836685180u,
+    1818989403545856475u, 2273736754432320594u, 1421085471520200371u,
+    1776356839400250464u, 2220446049250313080u, 1387778780781445675u,
+    1734723475976807094u, 2168404344971008868u, 1355252715606880542u,
+    1694065894508600678u, 2117582368135750847u, 1323488980084844279u,
+    1654361225106055349u, 2067951531382569187u, 1292469707114105741u,
+    1615587133892632177u, 2019483917365790221u
+};
+
+/* ceil(log2(5^e)), floor(log10(2^e)), floor(log10(5^e)) */
+static int pow5bits(int e) { return (int) (((uint32_t) e * 1217359) >> 19) + 1; }
+static uint32_t log10Pow2(int e) { return ((uint32_t) e * 78913) >> 18; }
+static uint32_t log10Pow5(int e) { return ((uint32_t) e * 732923) >> 20; }
+
+static int multipleOfPowerOf5(uint32_t value, uint32_t p)
+{
+    uint32_t count = 0;
+
+    while (value % 5 == 0) {
+        value /= 5;
+        count++;
+    }
+
+    return count >= p;
+}
+
+static int multipleOfPowerOf2(uint32_t value, uint32_t p)
+{
+    return (value & ((1u << p) - 1)) == 0;
+}
+
+static uint32_t mulShift(uint32_t m, uint64_t factor, int shift)
+{
+    uint64_t low = (uint64_t) m * (uint32_t) factor;
+    uint64_t high = (uint64_t) m * (uint32_t) (factor >> 32);
+
+    return (uint32_t) (((low >> 32) + high) >> (shift - 32));
+}
+
+/* value = *digits * 10^*exponent, with as few digits as possible */
+static void floatDecimal(uint32_t bits, uint32_t* digits, int* exponent)
+{
+    uint32_t ieeeMantissa = bits & ((1u << FLOAT_MANTISSA_BITS) - 1);
+    uint32_t ieeeExponent = (bits >> FLOAT_MANTISSA_BITS) & 0xff;
+
+    int e2;
+    uint32_t m2;
+
+    if (ieeeExponent == 0) {
+        e2 = 1 - FLOAT_BIAS - FLOAT_MANTISSA_BITS - 2;
+        m2 = ieeeMantissa;
+    }
+    else {
+        e2 = (int) ieeeExponent - FLOAT_BIAS - FLOAT_MANTISSA_BITS - 2;
+        m2 = (1u << FLOAT_MANTISSA_BITS) | ieeeMantissa;
+    }
+
+    int acceptBounds = (m2 & 1) == 0;
+
+    /* the float and the midpoints to its neighbours, times 4 */
+    uint32_t mv = 4 * m2;
+    uint32_t mp = 4 * m2 + 2;
+    uint32_t mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+    uint32_t mm = 4 * m2 - 1 - mmShift;
+
+    uint32_t vr, vp, vm;
+    int e10;
+    int vmIsTrailingZeros = 0;
+    int vrIsTrailingZeros = 0;
+    uint8_t lastRemovedDigit = 0;
+
+    if (e2 >= 0) {
+        uint32_t q = log10Pow2(e2);
+        int k = FLOAT_POW5_INV_BITCOUNT + pow5bits((int) q) - 1;
+        int i = -e2 + (int) q + k;
+
+        e10 = (int) q;
+        vr = mulShift(mv, floatPow5InvSplit[q], i);
+        vp = mulShift(mp, floatPow5InvSplit[q], i);
+        vm = mulShift(mm, floatPow5InvSplit[q], i);
+
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            int l = FLOAT_POW5_INV_BITCOUNT + pow5bits((int) (q - 1)) - 1;
+            lastRemovedDigit = (uint8_t) (mulShift(mv, floatPow5InvSplit[q - 1], -e2 + (int) q - 1 + l) % 10);
+        }
+
+        if (q <= 9) {
+            /* only one of mp, mv and mm can be a multiple of 5 */
+            if (mv % 5 == 0)
+                vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+            else if (acceptBounds)
+                vmIsTrailingZeros = multipleOfPowerOf5(mm, q);
+            else
+                vp -= multipleOfPowerOf5(mp, q);
+        }
+    }
+    else {
+        uint32_t q = log10Pow5(-e2);
+        int i = -e2 - (int) q;
+        int k = pow5bits(i) - FLOAT_POW5_BITCOUNT;
+        int j = (int) q - k;
+
+        e10 = (int) q + e2;
+        vr = mulShift(mv, floatPow5Split[i], j);
+        vp = mulShift(mp, floatPow5Split[i], j);
+        vm = mulShift(mm, floatPow5Split[i], j);
+
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            j = (int) q - 1 - (pow5bits(i + 1) - FLOAT_POW5_BITCOUNT);
+            lastRemovedDigit = (uint8_t) (mulShift(mv, floatPow5Split[i + 1], j) % 10);
+        }
+
+        if (q <= 1) {
+            /* mv = 4 * m2 always has two trailing zero bits */
+            vrIsTrailingZeros = 1;
+
+            if (acceptBounds)
+                vmIsTrailingZeros = mmShift == 1;
+            else
+                vp--;
+        }
+        else if (q < 31) {
+            vrIsTrailingZeros = multipleOfPowerOf2(mv, q - 1);
+        }
+    }
+
+    /* drop digits while the interval still holds a shorter decimal */
+    int removed = 0;
+    uint32_t output;
+
+    if (vmIsTrailingZeros || vrIsTrailingZeros) {
+        while (vp / 10 > vm / 10) {
+            vmIsTrailingZeros &= vm % 10 == 0;
+            vrIsTrailingZeros &= lastRemovedDigit == 0;
+            lastRemovedDigit = (uint8_t) (vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+
+        if (vmIsTrailingZeros) {
+            while (vm % 10 == 0) {
+                vrIsTrailingZeros &= lastRemovedDigit == 0;
+                lastRemovedDigit = (uint8_t) (vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+
+        /* exactly halfway: round to even */
+        if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0)
+            lastRemovedDigit = 4;
+
+        output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5);
+    }
+    else {
+        while (vp / 10 > vm / 10) {
+            lastRemovedDigit = (uint8_t) (vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+
+        output = vr + (vr == vm || lastRemovedDigit >= 5);
+    }
+
+    *digits = output;
+    *exponent = e10 + removed;
+}
+
+/* digits * 10^exponent as plain decimal ("0.00125", "1250") or, far from 1, as "1.25e-7" */
+static char* putDecimal(char* p, char* end, int negative, uint64_t digits, int exponent)
+{
+    char text[FMT_NUMBER_SIZE + 24];
+    char digitText[FMT_NUMBER_SIZE];
+
+    char* first = digitsBackwards(digitText + sizeof(digitText), digits);
+    int length = (int) (digitText + sizeof(digitText) - first);
+    int scientific = exponent + length - 1;     /* d.ddd * 10^scientific */
+
+    char* t = text;
+
+    if (negative)
+        *t++ = '-';
+
+    if (scientific < -6 || scientific >= 21) {
+        *t++ = first[0];
+
+        if (length > 1) {
+            *t++ = '.';
+            memcpy(t, first + 1, length - 1);
+            t += length - 1;
+        }
+
+        *t++ = 'e';
+        *t++ = scientific < 0 ? '-' : '+';
+
+        char exponentText[8];
+        char* e = digitsBackwards(exponentText + sizeof(exponentText),
+                                  (uint64_t) (scientific < 0 ? -scientific : scientific));
+        int n = (int) (exponentText + sizeof(exponentText) - e);
+
+        memcpy(t, e, n);
+        t += n;
+    }
+    else if (exponent >= 0) {
+        memcpy(t, first, length);
+        t += length;
+        memset(t, '0', exponent);
+        t += exponent;
+    }
+    else if (scientific >= 0) {
+        memcpy(t, first, scientific + 1);
+        t += scientific + 1;
+        *t++ = '.';
+        memcpy(t, first + scientific + 1, length - scientific - 1);
+        t += length - scientific - 1;
+    }
+    else {
+        *t++ = '0';
+        *t++ = '.';
+        memset(t, '0', -scientific - 1);
+        t += -scientific - 1;
+        memcpy(t, first, length);
+        t += length;
+    }
+
+    return put(p, end, text, (int) (t - text));
+}
+
+char* fmtFloat(char* p, char* end, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    int negative = bits >> 31;
+    uint32_t exponentBits = (bits >> FLOAT_MANTISSA_BITS) & 0xff;
+    uint32_t mantissaBits = bits & ((1u << FLOAT_MANTISSA_BITS) - 1);
+
+    if (exponentBits == 0xff) {
+        if (mantissaBits)
+            return put(p, end, "nan", 3);
+
+        return negative ? put(p, end, "-inf", 4) : put(p, end, "inf", 3);
+    }
+
+    if (exponentBits == 0 && mantissaBits == 0)
+        return negative ? put(p, end, "-0", 2) : put(p, end, "0", 1);
+
+    uint32_t digits;
+    int exponent;
+
+    floatDecimal(bits, &digits, &exponent);
+
+    return putDecimal(p, end, negative, digits, exponent);
+}
+
+char* fmtDouble(char* p, char* end, double value)
+{
+    /* also true for nan and inf */
+    if ((double) (float) value == value || value != value)
+        return fmtFloat(p, end, (float) value);
+
+    /* FLOAT64 is rare in IEC 61850 models: 15 digits, 17 when 15 do not read back */
+    char text[FMT_NUMBER_SIZE];
+    int n = snprintf(text, sizeof(text), "%.15g", value);
+
+    double back;
+    if (sscanf(text, "%lf", &back) != 1 || back != value)
+        n = snprintf(text, sizeof(text), "%.17g", value);
+
+    return put(p, end, text, n);
+}
+
+/* ===================== Times ===================== */
+
+/* Proleptic Gregorian date of a day count since 1970-01-01 */
+static void civilFromDays(int64_t z, int* year, int* month, int* day)
+{
+    z += 719468;
+
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    unsigned doe = (unsigned) (z - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+
+    *day = (int) (doy - (153 * mp + 2) / 5 + 1);
+    *month = (int) (mp < 10 ? mp + 3 : mp - 9);
+    *year = (int) (yoe + era * 400) + (*month <= 2);
+}
+
+static void put2(char* out, int value)
+{
+    out[0] = digitPairs[value * 2];
+    out[1] = digitPairs[value * 2 + 1];
+}
+
+/* "YYYY-MM-DDTHH:MM:SS" of the last second formatted on this thread */
+static __thread int64_t cachedSecond = INT64_MIN;
+static __thread char cachedText[19];
+
+char* fmtTime(char* p, char* end, int64_t timeMs, int withMs)
+{
+    int64_t second = timeMs >= 0 ? timeMs / 1000 : -((999 - timeMs) / 1000);
+
+    if (second != cachedSecond) {
+        int64_t days = second >= 0 ? second / 86400 : -((86399 - second) / 86400);
+        int secondOfDay = (int) (second - days * 86400);
+        int year, month, day;
+
+        civilFromDays(days, &year, &month, &day);
+
+        year %= 10000;
+        if (year < 0)
+            year += 10000;
+
+        put2(cachedText, year / 100);
+        put2(cachedText + 2, year % 100);
+        cachedText[4] = '-';
+        put2(cachedText + 5, month);
+        cachedText[7] = '-';
+        put2(cachedText + 8, day);
+        cachedText[10] = 'T';
+        put2(cachedText + 11, secondOfDay / 3600);
+        cachedText[13] = ':';
+        put2(cachedText + 14, secondOfDay / 60 % 60);
+        cachedText[16] = ':';
+        put2(cachedText + 17, secondOfDay % 60);
+
+        cachedSecond = second;
+    }
+
+    p = put(p, end, cachedText, sizeof(cachedText));
+
+    if (withMs) {
+        int ms = (int) (timeMs - second * 1000);
+        char text[4] = { '.', (char) ('0' + ms / 100), 0, 0 };
+
+        put2(text + 2, ms % 100);
+        p = put(p, end, text, 4);
+    }
+
+    return putChar(p, end, 'Z');
+}
+
+/* ===================== Other Types ===================== */
+
+char* fmtBits(char* p, char* end, uint32_t bits, int bitSize)
+{
+    for (int i = 0; i < bitSize && p < end - 1; i++)
+        *p++ = ((bits >> i) & 1) ? '1' : '0';
+
+    return p;
+}
+
+char* fmtText(char* p, char* end, const char* text)
+{
+    while (*text && p < end - 1)
+        *p++ = *text++;
+
+    return p;
+}
@@ -0,0 +1,44 @@
+/*
+ * Value formatting shared by the Polling and BRCB loggers and their tools
+ *
+ * Every function appends the text of one value at p and returns the new end
+ * of the text. Nothing is written at or past end - 1, so the caller can
+ * always terminate with *fmtX(p, end, ...) = 0. No allocation, no stdio, no
+ * locale: numbers, dates and times are encoded by hand.
+ *
+ *   integers   decimal, two digits per step
+ *   floats     shortest text that reads back as the same float (Ryu)
+ *   times      "2025-01-31T12:00:00Z"; the text of the current second is
+ *              cached per thread, so successive values of one second only
+ *              copy it
+ */
+
+#ifndef FMT_H
+#define FMT_H
+
+#include <stdint.h>
+
+/* Longest number text: "-9223372036854775808", "-1.17549435e-38" */
+#define FMT_NUMBER_SIZE 32
+
+char* fmtBoolean(char* p, char* end, int value);
+
+char* fmtInt64(char* p, char* end, int64_t value);
+
+char* fmtUint64(char* p, char* end, uint64_t value);
+
+/* Shortest decimal that reads back as the same float */
+char* fmtFloat(char* p, char* end, float value);
+
+/* Doubles that are exactly a float (values read as FLOAT32) are formatted as the float */
+char* fmtDouble(char* p, char* end, double value);
+
+/* ISO 8601 UTC, whole seconds, or with milliseconds */
+char* fmtTime(char* p, char* end, int64_t timeMs, int withMs);
+
+/* Bit i of the bit string is (bits >> i) & 1, printed first to last */
+char* fmtBits(char* p, char* end, uint32_t bits, int bitSize);
+
+char* fmtText(char* p, char* end, const char* text);
+
+#endif /* FMT_H */
@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "hal_thread.h"
+
+#include "clock.h"
+#include "fmt.h"
+#include "logsink.h"
+
+struct sLogSink {
+    char fileName[256];
+    char base[240];
+    char ext[8];
+    char header[128];
+    long long rotateBytes;
+
+    Semaphore lock;
+    FILE* file;
+    long long fileBytes;        /* in the current file, buffer included */
+    long long totalBytes;
+
+    int used;
+    char data[LOG_SINK_BUFFER];
+};
+
+static void openFile(LogSink* s)
+{
+    s->file = fopen(s->fileName, "ab");
+
+    if (!s->file) {
+        printf("Cannot open %s\n", s->fileName);
+        return;
+    }
+
+    /* the sink hands over whole blocks, stdio buffering would only split them */
+    setvbuf(s->file, NULL, _IONBF, 0);
+
+    fseek(s->file, 0, SEEK_END);
+    s->fileBytes = ftell(s->file);
+
+    if (s->fileBytes == 0 && s->header[0]) {
+        int n = (int) strlen(s->header);
+        memcpy(s->data + s->used, s->header, n);
+        s->used += n;
+        s->fileBytes += n;
+    }
+}
+
+static void writeBuffer(LogSink* s)
+{
+    if (s->used > 0 && s->file)
+        fwrite(s->data, 1, s->used, s->file);
+
+    s->totalBytes += s->used;
+    s->used = 0;
+}
+
+static void syncFile(FILE* f)
+{
+    fflush(f);
+
+#ifdef _WIN32
+    _commit(_fileno(f));
+#else
+    fsync(fileno(f));
+#endif
+}
+
+/* Called with the lock held, between lines */
+static void rotate(LogSink* s)
+{
+    char rotated[300];
+    char stamp[32];
+
+    writeBuffer(s);
+
+    /* lines of the old file may already be covered by a checkpoint */
+    if (s->file) {
+        syncFile(s->file);
+        fclose(s->file);
+    }
+
+    /* 2025-01-31T12:00:00.000Z -> 20250131T120000000 */
+    char* end = fmtTime(stamp, stamp + sizeof(stamp), clockWallMs(), 1);
+    char* q = stamp;
+    for (char* p = stamp; p < end; p++)
+        if (*p != '-' && *p != ':' && *p != '.' && *p != 'Z')
+            *q++ = *p;
+    *q = 0;
+
+    snprintf(rotated, sizeof(rotated), "%s-%s.%s", s->base, stamp, s->ext);
+
+    /* never replace an older file rotated in the same ms */
+    for (int n = 1; n < 100; n++) {
+        FILE* existing = fopen(rotated, "rb");
+
+        if (!existing)
+            break;
+
+        fclose(existing);
+        snprintf(rotated, sizeof(rotated), "%s-%s-%d.%s", s->base, stamp, n, s->ext);
+    }
+
+    if (rename(s->fileName, rotated) != 0)
+        printf("Cannot rename %s to %s\n", s->fileName, rotated);
+
+    openFile(s);
+}
+
+LogSink* logSinkOpen(const char* base, const char* ext, const char* header, long long rotateBytes)
+{
+    LogSink* s = calloc(1, sizeof(LogSink));
+
+    strncpy(s->base, base, sizeof(s->base) - 1);
+    strncpy(s->ext, ext, sizeof(s->ext) - 1);
+    strncpy(s->header, header ? header : "", sizeof(s->header) - 1);
+    snprintf(s->fileName, sizeof(s->fileName), "%s.%s", s->base, s->ext);
+    s->rotateBytes = rotateBytes;
+    s->lock = Semaphore_create(1);
+
+    openFile(s);
+
+    if (!s->file) {
+        Semaphore_destroy(s->lock);
+        free(s);
+        return NULL;
+    }
+
+    return s;
+}
+
+void logSinkWrite(LogSink* s, const char* text, int length)
+{
+    Semaphore_wait(s->lock);
+
+    if (s->rotateBytes > 0 && s->fileBytes + length > s->rotateBytes && s->fileBytes > (long long) strlen(s->header))
+        rotate(s);
+
+    if (s->used + length > LOG_SINK_BUFFER)
+        writeBuffer(s);
+
+    if (length > LOG_SINK_BUFFER) {
+        if (s->file)
+            fwrite(text, 1, length, s->file);
+        s->totalBytes += length;
+    }
+    else {
+        memcpy(s->data + s->used, text, length);
+        s->used += length;
+    }
+
+    s->fileBytes += length;
+
+    Semaphore_post(s->lock);
+}
+
+void logSinkFlush(LogSink* s)
+{
+    Semaphore_wait(s->lock);
+
+    writeBuffer(s);
+
+    if (s->file)
+        fflush(s->file);
+
+    Semaphore_post(s->lock);
+}
+
+void logSinkSync(LogSink* s)
+{
+    Semaphore_wait(s->lock);
+
+    writeBuffer(s);
+
+    if (s->file)
+        syncFile(s->file);
+
+    Semaphore_post(s->lock);
+}
+
+long long logSinkBytesWritten(LogSink* s)
+{
+    return s->totalBytes;
+}
+
+void logSinkClose(LogSink* s)
+{
+    if (!s)
+        return;
+
+    logSinkFlush(s);
+
+    if (s->file)
+        fclose(s->file);
+
+    Semaphore_destroy(s->lock);
+    free(s);
+}
@@ -0,0 +1,35 @@
+/*
+ * Log output files of the BRCB logger
+ *
+ * A sink is opened once and kept for the life of the logger. Lines are
+ * collected in a large buffer and handed to the file in whole blocks: when
+ * the buffer is full, on logSinkFlush() (the main loop calls it every
+ * second) and on close. When the file grows past its size limit it is
+ * renamed to <base>-<time>.<ext> and a new one is started with the header.
+ * Writers on several threads are serialized by the sink.
+ */
+
+#ifndef LOGSINK_H
+#define LOGSINK_H
+
+/* Bytes collected before one write */
+#define LOG_SINK_BUFFER 1048576
+
+typedef struct sLogSink LogSink;
+
+/* <base>.<ext>, appended to; header is written to every new file. rotateBytes 0: never rotate */
+LogSink* logSinkOpen(const char* base, const char* ext, const char* header, long long rotateBytes);
+
+/* One or more whole lines */
+void logSinkWrite(LogSink* s, const char* text, int length);
+
+void logSinkFlush(LogSink* s);
+
+/* logSinkFlush, then forced to disk (_commit/fsync), e.g. before a checkpoint that relies on the lines */
+void logSinkSync(LogSink* s);
+
+long long logSinkBytesWritten(LogSink* s);
+
+void logSinkClose(LogSink* s);
+
+#endif /* LOGSINK_H */
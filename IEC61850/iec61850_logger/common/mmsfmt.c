@@ -0,0 +1,82 @@
+#include "mmsfmt.h"
+
+char* fmtMmsValue(char* p, char* end, MmsValue* v)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    if (!v)
+        return fmtText(p, end, "<null>");
+
+    switch (MmsValue_getType(v)) {
+
+    case MMS_BOOLEAN:
+        return fmtBoolean(p, end, MmsValue_getBoolean(v));
+
+    case MMS_INTEGER:
+        return fmtInt64(p, end, MmsValue_toInt64(v));
+
+    case MMS_UNSIGNED:
+        return fmtUint64(p, end, MmsValue_toUint32(v));
+
+    case MMS_FLOAT:
+        return fmtDouble(p, end, MmsValue_toDouble(v));
+
+    case MMS_VISIBLE_STRING:
+    case MMS_STRING: {
+        const char* s = MmsValue_toString(v);
+        return s ? fmtText(p, end, s) : p;
+    }
+
+    case MMS_OCTET_STRING: {
+        const uint8_t* octets = MmsValue_getOctetStringBuffer(v);
+        int size = MmsValue_getOctetStringSize(v);
+
+        for (int i = 0; i < size && p < end - 2; i++) {
+            *p++ = hex[octets[i] >> 4];
+            *p++ = hex[octets[i] & 15];
+        }
+        return p;
+    }
+
+    case MMS_BIT_STRING: {
+        /* getBitStringAsInteger would walk the bits as well */
+        int size = MmsValue_getBitStringSize(v);
+
+        for (int i = 0; i < size && p < end - 1; i++)
+            *p++ = MmsValue_getBitStringBit(v, i) ? '1' : '0';
+        return p;
+    }
+
+    case MMS_UTC_TIME:
+        return fmtTime(p, end, (int64_t) MmsValue_getUtcTimeInMs(v), 0);
+
+    case MMS_BINARY_TIME:
+        return fmtTime(p, end, (int64_t) MmsValue_getBinaryTimeAsUtcMs(v), 1);
+
+    case MMS_STRUCTURE:
+    case MMS_ARRAY: {
+        int n = (int) MmsValue_getArraySize(v);
+
+        p = fmtText(p, end, "{");
+
+        for (int i = 0; i < n; i++) {
+            if (i > 0)
+                p = fmtText(p, end, ",");
+
+            p = fmtMmsValue(p, end, MmsValue_getElement(v, i));
+        }
+
+        return fmtText(p, end, "}");
+    }
+
+    case MMS_DATA_ACCESS_ERROR:
+        p = fmtText(p, end, "ERROR(");
+        p = fmtInt64(p, end, MmsValue_getDataAccessError(v));
+        return fmtText(p, end, ")");
+
+    default:
+        p = fmtText(p, end, "UNSUPPORTED(");
+        p = fmtInt64(p, end, MmsValue_getType(v));
+        return fmtText(p, end, ")");
+    }
+}
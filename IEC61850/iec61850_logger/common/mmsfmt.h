@@ -0,0 +1,16 @@
+/*
+ * MMS values as log text, built on fmt.h: one pass over the value, nested
+ * structures and arrays included, appending into the caller's buffer.
+ */
+
+#ifndef MMSFMT_H
+#define MMSFMT_H
+
+#include "mms_value.h"
+
+#include "fmt.h"
+
+/* Any MMS value; structures and arrays as {a,b,...} */
+char* fmtMmsValue(char* p, char* end, MmsValue* v);
+
+#endif /* MMSFMT_H */
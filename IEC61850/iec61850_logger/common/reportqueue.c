@@ -0,0 +1,54 @@
+#include <stdlib.h>
+
+#include "reportqueue.h"
+
+struct sReportQueue {
+    /* head and tail on their own cache lines, the two threads do not share one */
+    uint32_t head;              /* next record the producer fills */
+    char padHead[60];
+    uint32_t tail;              /* next record the consumer takes */
+    char padTail[60];
+
+    ReportRecord records[REPORT_QUEUE_SIZE];
+};
+
+ReportQueue* reportQueueCreate(void)
+{
+    return calloc(1, sizeof(ReportQueue));
+}
+
+ReportRecord* reportQueueReserve(ReportQueue* q)
+{
+    uint32_t head = q->head;
+
+    if (head - __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE) == REPORT_QUEUE_SIZE)
+        return NULL;
+
+    return &q->records[head & (REPORT_QUEUE_SIZE - 1)];
+}
+
+void reportQueuePublish(ReportQueue* q)
+{
+    /* the record is complete before the consumer can see it */
+    __atomic_store_n(&q->head, q->head + 1, __ATOMIC_RELEASE);
+}
+
+ReportRecord* reportQueuePeek(ReportQueue* q)
+{
+    uint32_t tail = q->tail;
+
+    if (tail == __atomic_load_n(&q->head, __ATOMIC_ACQUIRE))
+        return NULL;
+
+    return &q->records[tail & (REPORT_QUEUE_SIZE - 1)];
+}
+
+void reportQueueRelease(ReportQueue* q)
+{
+    __atomic_store_n(&q->tail, q->tail + 1, __ATOMIC_RELEASE);
+}
+
+void reportQueueDestroy(ReportQueue* q)
+{
+    free(q);
+}
@@ -0,0 +1,76 @@
+/*
+ * Reports handed from the thread that receives them to the writer thread
+ * (BRCB v4 and v5)
+ *
+ * libiec61850 calls the report handler on the connection's receive thread
+ * (v4) or on the worker thread that ticks the connection (v5), which must
+ * not wait for formatting or disk. The handler only copies the report into
+ * a record of a preallocated ring: the metadata, and the values of the
+ * entries included in the report BER encoded one after the other
+ * (MmsValue_encodeMmsData), which takes a few microseconds. The writer
+ * thread decodes and formats the records.
+ *
+ * One producer (v4: the receive thread of one connection, v5: one ring per
+ * worker, for all its connections), one consumer. When the ring is full the
+ * report is dropped and counted, the producer never waits.
+ */
+
+#ifndef REPORTQUEUE_H
+#define REPORTQUEUE_H
+
+#include <stdint.h>
+
+/* Records in the ring (power of two) */
+#define REPORT_QUEUE_SIZE 1024
+
+/* Largest encoded data set a record holds; bigger reports are dropped */
+#define REPORT_PAYLOAD_SIZE 8192
+
+/* Entries a record holds; the rest of a bigger report is dropped */
+#define REPORT_MAX_ENTRIES 512
+
+typedef struct {
+    int64_t receiveUs;          /* clockWallUs() when the handler was called */
+
+    /* v5 only, v4 does not set them */
+    int subscription;           /* index in subscriptions[], see subscriber.h */
+    int generation;             /* the subscription's enable count, SqNum restarts with it */
+    const struct sDataSetColumns* columns;  /* names of the instance's data set, NULL: by index */
+    uint64_t entryKey;          /* EntryID journal key of a BRCB, 0: URCB */
+
+    char rptId[130];
+    int hasSeqNum;
+    uint32_t seqNum;
+    uint32_t subSeqNum;         /* v5: segment of a report split in several, 0 for the first */
+    int hasEntryId;
+    uint8_t entryId[8];
+    int64_t timeOfEntryMs;      /* 0 if the report has none */
+    int bufOvfl;
+
+    int entryCount;                         /* entries included in the report */
+    uint16_t entries[REPORT_MAX_ENTRIES];   /* their index in the data set */
+    uint8_t reasons[REPORT_MAX_ENTRIES];    /* their ReasonForInclusion bits, 0 if not sent */
+
+    int payloadLength;
+    uint8_t payload[REPORT_PAYLOAD_SIZE];   /* BER of their values, in entry order */
+} ReportRecord;
+
+typedef struct sReportQueue ReportQueue;
+
+ReportQueue* reportQueueCreate(void);
+
+/* Producer: the next free record, NULL if the ring is full */
+ReportRecord* reportQueueReserve(ReportQueue* q);
+
+/* Producer: hand the reserved record to the consumer */
+void reportQueuePublish(ReportQueue* q);
+
+/* Consumer: the oldest record, NULL if there is none */
+ReportRecord* reportQueuePeek(ReportQueue* q);
+
+/* Consumer: give the record returned by reportQueuePeek back */
+void reportQueueRelease(ReportQueue* q);
+
+void reportQueueDestroy(ReportQueue* q);
+
+#endif /* REPORTQUEUE_H */
@@ -0,0 +1,746 @@
+/*
+ *  iec61850_proxy.c
+ *
+ *  - Mirrors the data model of one upstream IED into a dynamic IedModel
+ *  - Keeps the mirror fresh over a single upstream association
+ *  - Serves many downstream MMS clients from the cached data model, so the
+ *    IED only ever sees one client
+ */
+
+#include "iec61850_client.h"
+#include "iec61850_server.h"
+#include "iec61850_dynamic_model.h"
+#include "hal_thread.h"
+#include "hal_time.h"
+#include <signal.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define UPSTREAM_PORT 102
+#define PROXY_PORT 10102
+#define POLL_INTERVAL_MS 1000
+#define MAX_CLIENTS 100
+
+#define CONNECT_TIMEOUT_MS 2000
+#define REQUEST_TIMEOUT_MS 3000
+#define RECONNECT_INTERVAL_MS 10000
+
+/* Proxy statistics are printed this often */
+#define STATS_INTERVAL_MS 10000
+
+/* Bytes of a read request/response that are not item names or values */
+#define PDU_OVERHEAD 64
+
+/* Estimated encoded size of a LN$FC structure before it was first read */
+#define DEFAULT_VALUE_SIZE 512
+
+/*
+ * One MMS variable kept fresh: a logical node's attributes of one FC, e.g.
+ * domain "simpleIOGenericIO", item "GGIO1$MX". Its leaf attributes, in the
+ * order MMS encodes them, are leaves[firstLeaf .. firstLeaf + leafCount - 1].
+ */
+typedef struct {
+    char domain[65];
+    char itemId[130];
+    int valueSize;          /* encoded size of the last value read */
+    int firstLeaf;
+    int leafCount;
+    int mismatchReported;
+} MirrorItem;
+
+static int running = 0;
+static IedServer iedServer = NULL;
+
+static MirrorItem* mirrorItems = NULL;
+static int mirrorItemCount = 0;
+static int mirrorItemCapacity = 0;
+
+/* NULL for upstream attributes that are not mirrored (arrays, unknown types) */
+static DataAttribute** leaves = NULL;
+static int leafCount = 0;
+static int leafCapacity = 0;
+static int skippedCount = 0;
+
+static volatile int clientCount = 0;
+
+/* FCs with data worth caching; control, setting groups and control blocks stay on the IED */
+static const char* mirroredFcs[] = { "ST", "MX", "SP", "SV", "CF", "DC", "EX" };
+
+void
+sigint_handler(int signalId)
+{
+    running = 0;
+}
+
+static void
+connectionHandler (IedServer self, ClientConnection connection, bool connected, void* parameter)
+{
+    if (connected)
+        clientCount++;
+    else
+        clientCount--;
+
+    printf("Connection %s: %s (%d clients)\n", connected ? "opened" : "closed",
+           ClientConnection_getPeerAddress(connection), clientCount);
+}
+
+/* ===================== Model Mirroring ===================== */
+
+static int
+isMirroredFc(const char* fc)
+{
+    for (int i = 0; i < (int) (sizeof(mirroredFcs) / sizeof(mirroredFcs[0])); i++)
+        if (strcmp(fc, mirroredFcs[i]) == 0)
+            return 1;
+
+    return 0;
+}
+
+/* Attribute type the server encodes exactly like the upstream variable, IEC61850_UNKNOWN_TYPE if none */
+static DataAttributeType
+attributeType(MmsVariableSpecification* spec)
+{
+    int size = MmsVariableSpecification_getSize(spec);
+
+    /* variable length strings have a negative size */
+    if (size < 0)
+        size = -size;
+
+    switch (MmsVariableSpecification_getType(spec)) {
+
+    case MMS_BOOLEAN:
+        return IEC61850_BOOLEAN;
+
+    case MMS_INTEGER:
+        if (size <= 8) return IEC61850_INT8;
+        if (size <= 16) return IEC61850_INT16;
+        if (size <= 32) return IEC61850_INT32;
+        return IEC61850_INT64;
+
+    case MMS_UNSIGNED:
+        if (size <= 8) return IEC61850_INT8U;
+        if (size <= 16) return IEC61850_INT16U;
+        if (size <= 24) return IEC61850_INT24U;
+        return IEC61850_INT32U;
+
+    case MMS_FLOAT:
+        return size == 64 ? IEC61850_FLOAT64 : IEC61850_FLOAT32;
+
+    case MMS_BIT_STRING:
+        if (size == 2) return IEC61850_CODEDENUM;
+        if (size == 6) return IEC61850_TRGOPS;
+        if (size == 10) return IEC61850_OPTFLDS;
+        if (size == 13) return IEC61850_QUALITY;
+        return IEC61850_UNKNOWN_TYPE;
+
+    case MMS_OCTET_STRING:
+        if (size == 6) return IEC61850_OCTET_STRING_6;
+        if (size == 8) return IEC61850_OCTET_STRING_8;
+        return IEC61850_OCTET_STRING_64;
+
+    case MMS_VISIBLE_STRING:
+        if (size <= 32) return IEC61850_VISIBLE_STRING_32;
+        if (size <= 64) return IEC61850_VISIBLE_STRING_64;
+        if (size <= 65) return IEC61850_VISIBLE_STRING_65;
+        if (size <= 129) return IEC61850_VISIBLE_STRING_129;
+        return IEC61850_VISIBLE_STRING_255;
+
+    case MMS_STRING:
+        return IEC61850_UNICODE_STRING_255;
+
+    case MMS_UTC_TIME:
+        return IEC61850_TIMESTAMP;
+
+    case MMS_BINARY_TIME:
+        return IEC61850_ENTRY_TIME;
+
+    default:
+        return IEC61850_UNKNOWN_TYPE;
+    }
+}
+
+static void
+addLeaf(DataAttribute* da)
+{
+    if (leafCount == leafCapacity) {
+        leafCapacity = leafCapacity ? 2 * leafCapacity : 1024;
+        leaves = realloc(leaves, leafCapacity * sizeof(DataAttribute*));
+    }
+
+    if (!da)
+        skippedCount++;
+
+    leaves[leafCount++] = da;
+}
+
+static void
+mirrorAttributes(MmsVariableSpecification* spec, ModelNode* parent, FunctionalConstraint fc)
+{
+    int count = MmsVariableSpecification_getSize(spec);
+
+    for (int i = 0; i < count; i++) {
+        MmsVariableSpecification* child = MmsVariableSpecification_getChildSpecificationByIndex(spec, i);
+        const char* name = MmsVariableSpecification_getName(child);
+
+        /*
+         * A structure in a data object is taken as a sub data object: like a data object
+         * it spans several FCs (WYE phsA: MX and DC) and is created by the first one. A
+         * constructed attribute (mag) becomes one of a single FC, encoded the same way.
+         */
+        if (MmsVariableSpecification_getType(child) == MMS_STRUCTURE) {
+            ModelNode* node;
+
+            if (parent->modelType == DataObjectModelType) {
+                node = ModelNode_getChild(parent, name);
+
+                if (!node)
+                    node = (ModelNode*) DataObject_create(name, parent, 0);
+            }
+            else {
+                node = (ModelNode*) DataAttribute_create(name, parent, IEC61850_CONSTRUCTED, fc, 0, 0, 0);
+            }
+
+            mirrorAttributes(child, node, fc);
+            continue;
+        }
+
+        DataAttributeType type = attributeType(child);
+
+        if (type == IEC61850_UNKNOWN_TYPE) {
+            addLeaf(NULL);
+            continue;
+        }
+
+        uint8_t triggers = type == IEC61850_QUALITY ? TRG_OPT_QUALITY_CHANGED : TRG_OPT_DATA_CHANGED;
+
+        addLeaf(DataAttribute_create(name, parent, type, fc, triggers, 0, 0));
+    }
+}
+
+static MirrorItem*
+addMirrorItem(const char* domain, const char* lnName, const char* fcName)
+{
+    if (mirrorItemCount == mirrorItemCapacity) {
+        mirrorItemCapacity = mirrorItemCapacity ? 2 * mirrorItemCapacity : 64;
+        mirrorItems = realloc(mirrorItems, mirrorItemCapacity * sizeof(MirrorItem));
+    }
+
+    MirrorItem* item = &mirrorItems[mirrorItemCount++];
+    memset(item, 0, sizeof(*item));
+
+    strncpy(item->domain, domain, sizeof(item->domain) - 1);
+    snprintf(item->itemId, sizeof(item->itemId), "%s$%s", lnName, fcName);
+
+    item->valueSize = DEFAULT_VALUE_SIZE;
+    item->firstLeaf = leafCount;
+
+    return item;
+}
+
+/* The MMS variable of a logical node is a structure of FCs, each a structure of data objects */
+static void
+mirrorLogicalNode(MmsVariableSpecification* spec, LogicalNode* ln, const char* domain, const char* lnName)
+{
+    int fcCount = MmsVariableSpecification_getSize(spec);
+
+    for (int i = 0; i < fcCount; i++) {
+        MmsVariableSpecification* fcSpec = MmsVariableSpecification_getChildSpecificationByIndex(spec, i);
+        const char* fcName = MmsVariableSpecification_getName(fcSpec);
+
+        if (!isMirroredFc(fcName))
+            continue;
+
+        FunctionalConstraint fc = FunctionalConstraint_fromString(fcName);
+        MirrorItem* item = addMirrorItem(domain, lnName, fcName);
+
+        int doCount = MmsVariableSpecification_getSize(fcSpec);
+
+        for (int k = 0; k < doCount; k++) {
+            MmsVariableSpecification* doSpec = MmsVariableSpecification_getChildSpecificationByIndex(fcSpec, k);
+            const char* doName = MmsVariableSpecification_getName(doSpec);
+
+            if (MmsVariableSpecification_getType(doSpec) != MMS_STRUCTURE) {
+                addLeaf(NULL);
+                continue;
+            }
+
+            /* a data object spans several FCs and is created by the first one */
+            ModelNode* dataObject = ModelNode_getChild((ModelNode*) ln, doName);
+
+            if (!dataObject)
+                dataObject = (ModelNode*) DataObject_create(doName, (ModelNode*) ln, 0);
+
+            mirrorAttributes(doSpec, dataObject, fc);
+        }
+
+        item->leafCount = leafCount - item->firstLeaf;
+    }
+}
+
+/* The whole model is taken from the IED once; the server cannot change it later */
+static IedModel*
+mirrorModel(IedConnection con)
+{
+    IedClientError err;
+    MmsConnection mms = IedConnection_getMmsConnection(con);
+
+    LinkedList devices = IedConnection_getLogicalDeviceList(con, &err);
+
+    if (err != IED_ERROR_OK || !devices) {
+        printf("Cannot read the logical devices of the IED (%d)\n", err);
+        return NULL;
+    }
+
+    /* no IED name: the logical devices below carry the full MMS domain names */
+    IedModel* model = IedModel_create("");
+    int nodeCount = 0;
+
+    for (LinkedList d = LinkedList_getNext(devices); d; d = LinkedList_getNext(d)) {
+        const char* domain = (const char*) d->data;
+        LogicalDevice* ld = LogicalDevice_create(domain, model);
+
+        LinkedList nodes = IedConnection_getLogicalDeviceDirectory(con, &err, domain);
+
+        if (err != IED_ERROR_OK || !nodes) {
+            printf("Cannot read the logical nodes of %s (%d)\n", domain, err);
+            continue;
+        }
+
+        for (LinkedList n = LinkedList_getNext(nodes); n; n = LinkedList_getNext(n)) {
+            const char* lnName = (const char*) n->data;
+            MmsError mmsErr = MMS_ERROR_NONE;
+
+            MmsVariableSpecification* spec = MmsConnection_getVariableAccessAttributes(mms, &mmsErr,
+                    domain, lnName);
+
+            if (!spec) {
+                printf("Cannot read the type of %s/%s (%d)\n", domain, lnName, mmsErr);
+                continue;
+            }
+
+            mirrorLogicalNode(spec, LogicalNode_create(lnName, ld), domain, lnName);
+            MmsVariableSpecification_destroy(spec);
+            nodeCount++;
+        }
+
+        LinkedList_destroy(nodes);
+    }
+
+    LinkedList_destroy(devices);
+
+    printf("Mirrored %d logical nodes: %d items, %d attributes (%d not mirrored)\n",
+           nodeCount, mirrorItemCount, leafCount - skippedCount, skippedCount);
+
+    return model;
+}
+
+/* ===================== Cache Refresh ===================== */
+
+static int
+countLeaves(MmsValue* v)
+{
+    if (MmsValue_getType(v) != MMS_STRUCTURE)
+        return 1;
+
+    int count = 0;
+    int size = (int) MmsValue_getArraySize(v);
+
+    for (int i = 0; i < size; i++)
+        count += countLeaves(MmsValue_getElement(v, i));
+
+    return count;
+}
+
+static void
+copyLeaves(MmsValue* v, DataAttribute** da, int* next)
+{
+    if (MmsValue_getType(v) == MMS_STRUCTURE) {
+        int size = (int) MmsValue_getArraySize(v);
+
+        for (int i = 0; i < size; i++)
+            copyLeaves(MmsValue_getElement(v, i), da, next);
+
+        return;
+    }
+
+    DataAttribute* target = da[(*next)++];
+
+    /* the server's copy has a fixed type, a differing value would not fit */
+    if (target && MmsValue_getType(target->mmsValue) == MmsValue_getType(v))
+        IedServer_updateAttributeValue(iedServer, target, v);
+}
+
+/* Called with the data model locked */
+static void
+applyItem(MirrorItem* item, MmsValue* v)
+{
+    if (countLeaves(v) != item->leafCount) {
+        if (!item->mismatchReported)
+            printf("Model of %s/%s changed on the IED, not updated\n", item->domain, item->itemId);
+
+        item->mismatchReported = 1;
+        return;
+    }
+
+    int next = 0;
+    copyLeaves(v, &leaves[item->firstLeaf], &next);
+}
+
+static int
+itemCost(MirrorItem* item)
+{
+    int request = (int) strlen(item->itemId) + 8;
+    return request > item->valueSize ? request : item->valueSize;
+}
+
+/* The IED could not fit the response (or take the request): worth trying in smaller reads */
+static int
+tooLarge(MmsError err)
+{
+    return err == MMS_ERROR_RESOURCE_OTHER || err == MMS_ERROR_RESOURCE_CAPABILITY_UNAVAILABLE;
+}
+
+/* The association is gone or does not answer: the rest of the cycle would only wait for it too */
+static int
+upstreamFailed(MmsError err)
+{
+    return err == MMS_ERROR_SERVICE_TIMEOUT || err == MMS_ERROR_CONNECTION_LOST ||
+           err == MMS_ERROR_CONNECTION_REJECTED;
+}
+
+/*
+ * One MMS Read for mirrorItems[first .. first+count-1], all in the same domain.
+ * Counts the requests sent; returns 0 if the cycle has to be given up.
+ */
+static int
+readBatch(IedConnection con, int first, int count, int* requests)
+{
+    MmsConnection mms = IedConnection_getMmsConnection(con);
+    MmsError mmsErr = MMS_ERROR_NONE;
+
+    LinkedList names = LinkedList_create();
+
+    for (int i = 0; i < count; i++)
+        LinkedList_add(names, mirrorItems[first + i].itemId);
+
+    MmsValue* result = MmsConnection_readMultipleVariables(mms, &mmsErr, mirrorItems[first].domain, names);
+
+    LinkedList_destroyStatic(names);
+
+    (*requests)++;
+
+    if (!result || mmsErr != MMS_ERROR_NONE || MmsValue_getType(result) != MMS_ARRAY
+            || (int) MmsValue_getArraySize(result) != count) {
+
+        if (result) MmsValue_delete(result);
+
+        if (upstreamFailed(mmsErr)) {
+            printf("Read failed: %s/%s (%d), cycle aborted\n", mirrorItems[first].domain, mirrorItems[first].itemId, mmsErr);
+            return 0;
+        }
+
+        /* response exceeded the PDU size: halve the batch */
+        if (count > 1 && tooLarge(mmsErr)) {
+            int half = count / 2;
+            return readBatch(con, first, half, requests) && readBatch(con, first + half, count - half, requests);
+        }
+
+        /* anything else would fail the same way in smaller reads; the items keep their last values */
+        printf("Read failed: %s/%s +%d (%d)\n", mirrorItems[first].domain, mirrorItems[first].itemId, count - 1, mmsErr);
+        return 1;
+    }
+
+    /* readers are only held off while the values are copied, not during the round trip */
+    IedServer_lockDataModel(iedServer);
+
+    for (int i = 0; i < count; i++) {
+        MirrorItem* item = &mirrorItems[first + i];
+        MmsValue* v = MmsValue_getElement(result, i);
+
+        if (v && MmsValue_getType(v) == MMS_STRUCTURE) {
+            item->valueSize = MmsValue_encodeMmsData(v, NULL, 0, false);
+            applyItem(item, v);
+        }
+    }
+
+    IedServer_unlockDataModel(iedServer);
+
+    MmsValue_delete(result);
+
+    return 1;
+}
+
+/* Every item once, packed into as few reads as the PDU allows; 0 if the IED stopped answering */
+static int
+refreshCache(IedConnection con, int maxPduSize, int* requests)
+{
+    int budget = maxPduSize - PDU_OVERHEAD;
+    int first = 0;
+
+    while (first < mirrorItemCount) {
+        const char* domain = mirrorItems[first].domain;
+        int used = itemCost(&mirrorItems[first]);
+        int count = 1;
+
+        while (first + count < mirrorItemCount) {
+            MirrorItem* next = &mirrorItems[first + count];
+
+            if (strcmp(next->domain, domain) != 0 || used + itemCost(next) > budget)
+                break;
+
+            used += itemCost(next);
+            count++;
+        }
+
+        if (!readBatch(con, first, count, requests))
+            return 0;
+
+        first += count;
+    }
+
+    return 1;
+}
+
+/* Upstream lost or not answering: what the clients read is no longer being refreshed */
+static void
+markOldData()
+{
+    IedServer_lockDataModel(iedServer);
+
+    for (int i = 0; i < leafCount; i++) {
+        DataAttribute* da = leaves[i];
+
+        if (!da || da->type != IEC61850_QUALITY)
+            continue;
+
+        Quality q = Quality_fromMmsValue(da->mmsValue);
+        Quality_setValidity(&q, QUALITY_VALIDITY_QUESTIONABLE);
+        Quality_setFlag(&q, QUALITY_DETAIL_OLD_DATA);
+
+        IedServer_updateQuality(iedServer, da, q);
+    }
+
+    IedServer_unlockDataModel(iedServer);
+}
+
+/* ===================== Upstream Connection ===================== */
+
+static IedConnection
+connectUpstream(const char* host, int port, int* maxPduSize)
+{
+    IedClientError err;
+    IedConnection con = IedConnection_create();
+
+    IedConnection_setConnectTimeout(con, CONNECT_TIMEOUT_MS);
+    IedConnection_setRequestTimeout(con, REQUEST_TIMEOUT_MS);
+
+    IedConnection_connect(con, &err, host, port);
+
+    if (err != IED_ERROR_OK) {
+        printf("Connection failed: %s:%d (%d)\n", host, port, err);
+        IedConnection_destroy(con);
+        return NULL;
+    }
+
+    MmsConnectionParameters params = MmsConnection_getMmsConnectionParameters(
+            IedConnection_getMmsConnection(con));
+
+    *maxPduSize = params.maxPduSize;
+
+    printf("Connected to %s:%d (max PDU %d)\n", host, port, *maxPduSize);
+
+    return con;
+}
+
+int
+main(int argc, char** argv)
+{
+    char host[128] = "";
+    int upstreamPort = UPSTREAM_PORT;
+    int tcpPort = PROXY_PORT;
+    int intervalMs = POLL_INTERVAL_MS;
+    int maxClients = MAX_CLIENTS;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+            tcpPort = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc)
+            intervalMs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--clients") == 0 && i + 1 < argc)
+            maxClients = atoi(argv[++i]);
+        else if (argv[i][0] != '-' && host[0] == 0) {
+            strncpy(host, argv[i], sizeof(host) - 1);
+
+            char* colon = strchr(host, ':');
+            if (colon) {
+                *colon = 0;
+                upstreamPort = atoi(colon + 1);
+            }
+        }
+        else {
+            host[0] = 0;
+            break;
+        }
+    }
+
+    if (host[0] == 0 || intervalMs < 1 || maxClients < 1) {
+        printf("Usage: %s host[:port] [--port n] [--interval ms] [--clients n]\n", argv[0]);
+        return 1;
+    }
+
+    printf("Using libIEC61850 version %s\n", LibIEC61850_getVersionString());
+
+    running = 1;
+
+    signal(SIGINT, sigint_handler);
+
+    /* the model has to be known before the server can start */
+    int maxPduSize = 0;
+    IedConnection upstream = NULL;
+
+    while (running && !upstream) {
+        upstream = connectUpstream(host, upstreamPort, &maxPduSize);
+
+        if (!upstream)
+            Thread_sleep(RECONNECT_INTERVAL_MS);
+    }
+
+    if (!upstream)
+        return 0;
+
+    IedModel* model = mirrorModel(upstream);
+
+    if (!model) {
+        IedConnection_destroy(upstream);
+        return 1;
+    }
+
+    /* Create new server configuration object */
+    IedServerConfig config = IedServerConfig_create();
+
+    /* Set buffer size for buffered report control blocks to 200000 bytes */
+    IedServerConfig_setReportBufferSize(config, 200000);
+
+    /* Set stack compliance to a specific edition of the standard */
+    IedServerConfig_setEdition(config, IEC_61850_EDITION_2);
+
+    /* disable MMS file service */
+    IedServerConfig_enableFileService(config, false);
+
+    /* enable dynamic data set service: clients may build their own data sets over the cache */
+    IedServerConfig_enableDynamicDataSetService(config, true);
+
+    /* disable log service */
+    IedServerConfig_enableLogService(config, false);
+
+    /* the point of the proxy: many clients instead of the IED's few */
+    IedServerConfig_setMaxMmsConnections(config, maxClients);
+
+    /* Create a new IEC 61850 server instance */
+    iedServer = IedServer_createWithConfig(model, NULL, config);
+
+    /* configuration object is no longer required */
+    IedServerConfig_destroy(config);
+
+    /* set the identity values for MMS identify service */
+    IedServer_setServerIdentity(iedServer, "MZ", "iec61850 proxy", "1.6.0");
+
+    IedServer_setConnectionIndicationHandler(iedServer, (IedConnectionIndicationHandler) connectionHandler, NULL);
+
+    /* Writes would only change the cache, never the IED */
+    IedServer_setWriteAccessPolicy(iedServer, IEC61850_FC_SP, ACCESS_POLICY_DENY);
+    IedServer_setWriteAccessPolicy(iedServer, IEC61850_FC_SV, ACCESS_POLICY_DENY);
+    IedServer_setWriteAccessPolicy(iedServer, IEC61850_FC_CF, ACCESS_POLICY_DENY);
+    IedServer_setWriteAccessPolicy(iedServer, IEC61850_FC_DC, ACCESS_POLICY_DENY);
+
+    /* fill the cache before the first client can connect */
+    int requests = 0;
+
+    if (!refreshCache(upstream, maxPduSize, &requests))
+        markOldData();
+
+    /* MMS server will be instructed to start listening for client connections. */
+    IedServer_start(iedServer, tcpPort);
+
+    if (!IedServer_isRunning(iedServer))
+    {
+        printf("Starting server failed (maybe need root permissions or another server is already using the port)! Exit.\n");
+        IedServer_destroy(iedServer);
+        IedConnection_destroy(upstream);
+        exit(-1);
+    }
+
+    printf("Serving %s:%d on port %d, refreshed every %d ms\n", host, upstreamPort, tcpPort, intervalMs);
+
+    uint64_t nextCycle = Hal_getTimeInMs();
+    uint64_t nextStats = nextCycle + STATS_INTERVAL_MS;
+    uint64_t retryAt = 0;
+
+    long cycles = 0;
+    uint64_t busyMs = 0;
+
+    requests = 0;
+
+    while (running)
+    {
+        uint64_t start = Hal_getTimeInMs();
+
+        if (upstream && IedConnection_getState(upstream) != IED_STATE_CONNECTED) {
+            printf("Connection lost: %s:%d\n", host, upstreamPort);
+            IedConnection_destroy(upstream);
+            upstream = NULL;
+            markOldData();
+        }
+
+        if (!upstream && start >= retryAt) {
+            upstream = connectUpstream(host, upstreamPort, &maxPduSize);
+
+            if (!upstream)
+                retryAt = start + RECONNECT_INTERVAL_MS;
+        }
+
+        if (upstream) {
+            /* the next cycle tries again; a lost association is found above */
+            if (!refreshCache(upstream, maxPduSize, &requests))
+                markOldData();
+
+            busyMs += Hal_getTimeInMs() - start;
+            cycles++;
+        }
+
+        if (start >= nextStats) {
+            printf("Proxy: %d clients, %ld cycles, %d upstream requests, %.1f ms per cycle\n",
+                   clientCount, cycles, requests, cycles ? (double) busyMs / cycles : 0.0);
+
+            cycles = requests = 0;
+            busyMs = 0;
+            nextStats += STATS_INTERVAL_MS;
+        }
+
+        /* absolute deadlines: the refresh time does not add to the period */
+        nextCycle += intervalMs;
+
+        uint64_t now = Hal_getTimeInMs();
+
+        if (nextCycle > now)
+            Thread_sleep((int) (nextCycle - now));
+        else
+            nextCycle = now;
+    }
+
+    /* stop MMS server - close TCP server socket and all client sockets */
+    IedServer_stop(iedServer);
+
+    /* Cleanup - free all resources */
+    IedServer_destroy(iedServer);
+    IedModel_destroy(model);
+
+    if (upstream)
+        IedConnection_destroy(upstream);
+
+    free(leaves);
+    free(mirrorItems);
+
+    return 0;
+} /* main() */
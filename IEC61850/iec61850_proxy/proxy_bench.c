@@ -0,0 +1,208 @@
+/*
+ *  proxy_bench.c
+ *
+ *  Read throughput and latency seen by many concurrent MMS clients:
+ *    proxy_bench host[:port] reference [--fc FC] [--clients n] [--seconds n]
+ *  Every client opens its own association and reads the reference back to
+ *  back. Run it once against the proxy and once against the IED itself.
+ */
+
+#include "iec61850_client.h"
+#include "hal_thread.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define DEFAULT_CLIENTS 50
+#define DEFAULT_SECONDS 10
+
+/* Latency histogram: 100 us buckets up to 2 s, the last one takes the rest */
+#define BUCKET_US 100
+#define BUCKETS 20000
+
+typedef struct {
+    Thread thread;
+    int connected;
+    long reads;
+    long errors;
+    double maxMs;
+    unsigned int histogram[BUCKETS];
+} Client;
+
+static char host[128];
+static int port = 102;
+static const char* reference;
+static FunctionalConstraint fc = IEC61850_FC_MX;
+
+static volatile int running = 1;
+
+static double
+nowMs()
+{
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER c;
+
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency(&freq);
+
+    QueryPerformanceCounter(&c);
+    return (double) c.QuadPart * 1000.0 / (double) freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+}
+
+static void*
+clientThread(void* parameter)
+{
+    Client* c = (Client*) parameter;
+    IedClientError err;
+
+    IedConnection con = IedConnection_create();
+    IedConnection_connect(con, &err, host, port);
+
+    if (err != IED_ERROR_OK) {
+        IedConnection_destroy(con);
+        return NULL;
+    }
+
+    c->connected = 1;
+
+    while (running) {
+        double start = nowMs();
+
+        MmsValue* v = IedConnection_readObject(con, &err, reference, fc);
+
+        double ms = nowMs() - start;
+
+        if (!v || err != IED_ERROR_OK) {
+            c->errors++;
+
+            if (IedConnection_getState(con) != IED_STATE_CONNECTED)
+                break;
+
+            continue;
+        }
+
+        MmsValue_delete(v);
+
+        int bucket = (int) (ms * 1000.0 / BUCKET_US);
+        c->histogram[bucket < BUCKETS ? bucket : BUCKETS - 1]++;
+        c->reads++;
+
+        if (ms > c->maxMs)
+            c->maxMs = ms;
+    }
+
+    IedConnection_close(con);
+    IedConnection_destroy(con);
+
+    return NULL;
+}
+
+/* Upper edge in ms of the bucket holding the given fraction of all reads */
+static double
+percentile(const unsigned int* histogram, long total, double fraction)
+{
+    long seen = 0;
+
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += histogram[i];
+
+        if (seen >= fraction * total)
+            return (i + 1) * BUCKET_US / 1000.0;
+    }
+
+    return BUCKETS * BUCKET_US / 1000.0;
+}
+
+int
+main(int argc, char** argv)
+{
+    int clientCount = DEFAULT_CLIENTS;
+    int seconds = DEFAULT_SECONDS;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--fc") == 0 && i + 1 < argc)
+            fc = FunctionalConstraint_fromString(argv[++i]);
+        else if (strcmp(argv[i], "--clients") == 0 && i + 1 < argc)
+            clientCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+            seconds = atoi(argv[++i]);
+        else if (argv[i][0] != '-' && host[0] == 0) {
+            strncpy(host, argv[i], sizeof(host) - 1);
+
+            char* colon = strchr(host, ':');
+            if (colon) {
+                *colon = 0;
+                port = atoi(colon + 1);
+            }
+        }
+        else if (argv[i][0] != '-' && !reference)
+            reference = argv[i];
+        else
+            clientCount = 0;
+    }
+
+    if (host[0] == 0 || !reference || clientCount < 1 || seconds < 1 || fc == IEC61850_FC_NONE) {
+        printf("Usage: %s host[:port] reference [--fc FC] [--clients n] [--seconds n]\n", argv[0]);
+        return 1;
+    }
+
+    Client* clients = calloc(clientCount, sizeof(Client));
+
+    for (int i = 0; i < clientCount; i++) {
+        clients[i].thread = Thread_create(clientThread, &clients[i], false);
+        Thread_start(clients[i].thread);
+    }
+
+    double start = nowMs();
+
+    Thread_sleep(seconds * 1000);
+    running = 0;
+
+    double elapsed = (nowMs() - start) / 1000.0;
+
+    for (int i = 0; i < clientCount; i++)
+        Thread_destroy(clients[i].thread);
+
+    /* all clients together */
+    static unsigned int histogram[BUCKETS];
+    long reads = 0, errors = 0;
+    int connected = 0;
+    double maxMs = 0;
+
+    for (int i = 0; i < clientCount; i++) {
+        Client* c = &clients[i];
+
+        connected += c->connected;
+        reads += c->reads;
+        errors += c->errors;
+
+        if (c->maxMs > maxMs)
+            maxMs = c->maxMs;
+
+        for (int k = 0; k < BUCKETS; k++)
+            histogram[k] += c->histogram[k];
+    }
+
+    printf("%s:%d %s, %d of %d clients connected, %.1f s\n", host, port, reference, connected, clientCount, elapsed);
+    printf("Reads: %ld (%.0f/s), %ld errors\n", reads, reads / elapsed, errors);
+
+    if (reads > 0)
+        printf("Latency: p50 %.1f ms, p99 %.1f ms, max %.1f ms\n",
+               percentile(histogram, reads, 0.50), percentile(histogram, reads, 0.99), maxMs);
+
+    free(clients);
+
+    return 0;
+}
@@ -0,0 +1,1200 @@
+/*
+ *  genindex.c
+ *
+ *  Writes static_model_index.c, the object reference index of a static model
+ *  generated by genmodel.jar (see modelindex.h):
+ *
+ *    genindex static_model.c static_model_index.c
+ *
+ *  The table is a perfect hash built by hash and displace: the references are
+ *  hashed into buckets of about four, and for every bucket, the largest
+ *  first, a seed is searched that puts all of its references into free slots.
+ *  A lookup hashes the reference once, reads the seed of its bucket and then
+ *  the one slot the reference can be in.
+ *
+ *  With --compact, static_model.c and static_model.h are rewritten as well:
+ *
+ *    genindex --compact static_model.c static_model_index.c
+ *
+ *  The LDs, LNs, DOs, DAs, data sets, data set entries and RCBs each become
+ *  one array in model order instead of a global per definition, so a walk
+ *  through the tree stays within a few contiguous blocks; static_model.h
+ *  defines the old names as the array elements, code using them or the
+ *  IEDMODEL_ macros compiles unchanged. The initializeValues statements
+ *  become a const table read by one loop, and values equal to the defaults
+ *  the server's value cache starts with (0, false, "") are left out, which
+ *  saves an allocation each at startup. The nodes stay writable: the server
+ *  keeps its state (mmsValue, data set entry values) in them and follows
+ *  their sibling and child pointers.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "modelindex.h"
+
+#define MAX_FIELDS 32
+
+/* References per bucket, and free slots per 16 references */
+#define BUCKET_SIZE 4
+#define SLOT_RESERVE 16
+
+#define MAX_SEED (1u << 24)
+
+typedef enum {
+    DEF_LD,
+    DEF_LN,
+    DEF_DO,
+    DEF_DA,
+    DEF_DATA_SET,
+    DEF_RCB,
+    DEF_DATA_SET_ENTRY,
+    DEF_COUNT
+} DefinitionType;
+
+static const char* definitionTypes[] = {
+    "LogicalDevice", "LogicalNode", "DataObject", "DataAttribute", "DataSet", "ReportControlBlock",
+    "DataSetEntry"
+};
+
+/* --compact: the definitions of a type become the elements of one array */
+static const char* arrayNames[] = {
+    "iedModelDevices", "iedModelNodes", "iedModelObjects", "iedModelAttributes", "iedModelDataSets",
+    "iedModelReports", "iedModelDataSetEntries"
+};
+
+/* FunctionalConstraint in enum order */
+static const char* fcNames[] = {
+    "ST", "MX", "SP", "SV", "CF", "DC", "SG", "SE", "SR", "OR",
+    "BL", "EX", "CO", "US", "MS", "RP", "BR", "LG", "GO"
+};
+
+#define FC_COUNT ((int) (sizeof(fcNames) / sizeof(fcNames[0])))
+
+typedef struct {
+    DefinitionType type;
+    char* symbol;
+    char* name;         /* NULL: array element */
+    int parent;         /* definition index, -1: the model */
+    int fc;             /* DA: index into fcNames */
+    uint32_t fcs;       /* DO: FCs of its attributes */
+    char* ldName;       /* data set */
+    bool buffered;      /* RCB */
+    char* initializer;  /* between the braces */
+    const char* start;  /* the definition in static_model.c, up to the end of its line */
+    const char* end;
+    int element;        /* index in its array of the compact layout */
+} Definition;
+
+typedef struct {
+    char* reference;
+    ModelIndexKind kind;
+    int fc;             /* -1: none */
+    int definition;
+    uint64_t hash;
+} Key;
+
+static Definition* definitions = NULL;
+static int definitionCount = 0;
+static int definitionCapacity = 0;
+
+static Key* keys = NULL;
+static int keyCount = 0;
+static int keyCapacity = 0;
+
+static void
+fail(const char* format, const char* argument)
+{
+    fprintf(stderr, "genindex: ");
+    fprintf(stderr, format, argument);
+    fprintf(stderr, "\n");
+    exit(1);
+}
+
+static void*
+grow(void* array, int* capacity, size_t elementSize)
+{
+    *capacity = *capacity ? *capacity * 2 : 256;
+    array = realloc(array, *capacity * elementSize);
+
+    if (array == NULL)
+        fail("out of memory%s", "");
+
+    return array;
+}
+
+static char*
+copyString(const char* s, size_t length)
+{
+    char* copy = (char*) malloc(length + 1);
+
+    if (copy == NULL)
+        fail("out of memory%s", "");
+
+    memcpy(copy, s, length);
+    copy[length] = 0;
+
+    return copy;
+}
+
+static char*
+readFile(const char* fileName)
+{
+    FILE* file = fopen(fileName, "rb");
+
+    if (file == NULL)
+        fail("cannot open %s", fileName);
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char* text = (char*) malloc(size + 1);
+
+    if (text == NULL || fread(text, 1, size, file) != (size_t) size)
+        fail("cannot read %s", fileName);
+
+    text[size] = 0;
+    fclose(file);
+
+    return text;
+}
+
+/* Splits an initializer at the top level commas, fields trimmed */
+static int
+splitFields(char* s, char** fields)
+{
+    int count = 0;
+    int depth = 0;
+    bool quoted = false;
+    char* start = s;
+
+    for (;; s++) {
+        if (*s == '"')
+            quoted = !quoted;
+        else if (!quoted && *s == '{')
+            depth++;
+        else if (!quoted && *s == '}')
+            depth--;
+
+        if (*s == 0 || (!quoted && depth == 0 && *s == ',')) {
+            char* end = s;
+
+            while (start < end && strchr(" \t\r\n", *start))
+                start++;
+
+            while (end > start && strchr(" \t\r\n", end[-1]))
+                end--;
+
+            if (count < MAX_FIELDS)
+                fields[count++] = copyString(start, end - start);
+
+            if (*s == 0)
+                return count;
+
+            start = s + 1;
+        }
+    }
+}
+
+/* "name" -> name, NULL -> NULL */
+static char*
+unquote(const char* field)
+{
+    size_t length = strlen(field);
+
+    if (length < 2 || field[0] != '"' || field[length - 1] != '"')
+        return NULL;
+
+    return copyString(field + 1, length - 2);
+}
+
+/* (ModelNode*) &symbol or &symbol -> symbol */
+static const char*
+pointerTarget(const char* field)
+{
+    const char* ampersand = strchr(field, '&');
+
+    return ampersand ? ampersand + 1 : NULL;
+}
+
+/* Definition indices, sorted by symbol */
+static int* symbolOrder = NULL;
+static int symbolCount = 0;
+
+static int
+compareSymbols(const void* a, const void* b)
+{
+    return strcmp(definitions[*(const int*) a].symbol, definitions[*(const int*) b].symbol);
+}
+
+static int
+findDefinition(const char* symbol)
+{
+    int low = 0;
+    int high = symbolCount - 1;
+
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        int c = strcmp(definitions[symbolOrder[middle]].symbol, symbol);
+
+        if (c == 0)
+            return symbolOrder[middle];
+
+        if (c < 0)
+            low = middle + 1;
+        else
+            high = middle - 1;
+    }
+
+    return -1;
+}
+
+static int
+findFc(const char* field)
+{
+    if (strncmp(field, "IEC61850_FC_", 12) == 0) {
+        for (int i = 0; i < FC_COUNT; i++)
+            if (strcmp(field + 12, fcNames[i]) == 0)
+                return i;
+    }
+
+    return -1;
+}
+
+/* Collects the definitions of the model's nodes, data sets and RCBs */
+static void
+parseModel(char* text)
+{
+    char** parentSymbols = NULL;
+
+    for (char* line = text; line && *line; ) {
+        char* next = strchr(line, '\n');
+        int type;
+
+        for (type = DEF_LD; type < DEF_COUNT; type++) {
+            size_t length = strlen(definitionTypes[type]);
+
+            if (strncmp(line, definitionTypes[type], length) == 0 && line[length] == ' ')
+                break;
+        }
+
+        char* open = type < DEF_COUNT ? strstr(line, " = {") : NULL;
+
+        if (open == NULL || (next && open > next)) {
+            line = next ? next + 1 : NULL;
+            continue;
+        }
+
+        /* the initializer ends with }; at the end of a line */
+        char* close = strstr(open, "};");
+
+        if (close == NULL)
+            fail("unterminated %s", definitionTypes[type]);
+
+        char* symbolStart = line + strlen(definitionTypes[type]);
+
+        while (*symbolStart == ' ')
+            symbolStart++;
+
+        char* initializer = copyString(open + 4, close - (open + 4));
+        char* fields[MAX_FIELDS];
+        int fieldCount = splitFields(initializer, fields);
+
+        if (definitionCount == definitionCapacity) {
+            definitions = (Definition*) grow(definitions, &definitionCapacity, sizeof(Definition));
+            parentSymbols = (char**) realloc(parentSymbols, definitionCapacity * sizeof(char*));
+
+            if (parentSymbols == NULL)
+                fail("out of memory%s", "");
+        }
+
+        Definition* d = &definitions[definitionCount];
+        const char* parent = NULL;
+
+        memset(d, 0, sizeof(Definition));
+        d->type = (DefinitionType) type;
+        d->symbol = copyString(symbolStart, open - symbolStart);
+        d->parent = -1;
+        d->fc = -1;
+        d->initializer = initializer;
+        d->start = line;
+
+        if (type <= DEF_DA) {
+            /* ModelType, name, parent, sibling, child, ...; DA: FC at 7 */
+            if (fieldCount < 3 || (type == DEF_DA && fieldCount < 8))
+                fail("unexpected initializer of %s", d->symbol);
+
+            d->name = unquote(fields[1]);
+            parent = pointerTarget(fields[2]);
+
+            if (type == DEF_DA && (d->fc = findFc(fields[7])) < 0)
+                fail("unknown functional constraint of %s", d->symbol);
+        }
+        else if (type == DEF_DATA_SET) {
+            /* LD name, LN$name, ... */
+            if (fieldCount < 2)
+                fail("unexpected initializer of %s", d->symbol);
+
+            d->ldName = unquote(fields[0]);
+            d->name = unquote(fields[1]);
+        }
+        else if (type == DEF_RCB) {
+            /* &parent LN, name, rptId, buffered, ... */
+            if (fieldCount < 4)
+                fail("unexpected initializer of %s", d->symbol);
+
+            parent = pointerTarget(fields[0]);
+            d->name = unquote(fields[1]);
+            d->buffered = strcmp(fields[3], "true") == 0;
+        }
+
+        parentSymbols[definitionCount] = parent && strcmp(parent, "iedModel") != 0 ? copyString(parent, strlen(parent)) : NULL;
+        definitionCount++;
+
+        for (int i = 0; i < fieldCount; i++)
+            free(fields[i]);
+
+        line = strchr(close, '\n');
+        line = line ? line + 1 : close + strlen(close);
+        d->end = line;
+    }
+
+    /* parents are defined after their children at times */
+    symbolOrder = (int*) malloc((definitionCount + 1) * sizeof(int));
+
+    if (symbolOrder == NULL)
+        fail("out of memory%s", "");
+
+    for (int i = 0; i < definitionCount; i++)
+        symbolOrder[symbolCount++] = i;
+
+    qsort(symbolOrder, symbolCount, sizeof(int), compareSymbols);
+
+    for (int i = 0; i < definitionCount; i++) {
+        if (parentSymbols[i]) {
+            definitions[i].parent = findDefinition(parentSymbols[i]);
+
+            if (definitions[i].parent < 0 || definitions[definitions[i].parent].type > DEF_DA)
+                fail("parent %s not found", parentSymbols[i]);
+
+            free(parentSymbols[i]);
+        }
+    }
+
+    free(parentSymbols);
+}
+
+static void
+addKey(char* reference, ModelIndexKind kind, int fc, int definition)
+{
+    if (keyCount == keyCapacity)
+        keys = (Key*) grow(keys, &keyCapacity, sizeof(Key));
+
+    keys[keyCount].reference = reference;
+    keys[keyCount].kind = kind;
+    keys[keyCount].fc = fc;
+    keys[keyCount].definition = definition;
+    keys[keyCount].hash = ModelIndex_hash(reference);
+    keyCount++;
+}
+
+/* The names from the LN down to the node, separated by separator; false for array elements */
+static bool
+appendPath(char* buffer, size_t size, int node, int stopType, const char* separator)
+{
+    const Definition* d = &definitions[node];
+
+    if (d->name == NULL)
+        return false;
+
+    if ((int) d->type > stopType && d->parent >= 0) {
+        if (!appendPath(buffer, size, d->parent, stopType, separator))
+            return false;
+
+        strncat(buffer, separator, size - strlen(buffer) - 1);
+    }
+
+    strncat(buffer, d->name, size - strlen(buffer) - 1);
+
+    return true;
+}
+
+static int
+ancestor(int node, DefinitionType type)
+{
+    while (node >= 0 && definitions[node].type != type)
+        node = definitions[node].parent;
+
+    return node;
+}
+
+static char*
+makeReference(const char* ld, const char* ln, const char* fc, int node, DefinitionType from)
+{
+    char reference[1024];
+
+    snprintf(reference, sizeof(reference), "%s/%s", ld, ln);
+
+    if (fc) {
+        strncat(reference, "$", sizeof(reference) - strlen(reference) - 1);
+        strncat(reference, fc, sizeof(reference) - strlen(reference) - 1);
+    }
+
+    if (node >= 0) {
+        strncat(reference, fc ? "$" : ".", sizeof(reference) - strlen(reference) - 1);
+
+        if (!appendPath(reference, sizeof(reference), node, from, fc ? "$" : "."))
+            return NULL;
+    }
+
+    if (strlen(reference) >= sizeof(reference) - 1)
+        fail("reference too long: %s", reference);
+
+    return copyString(reference, strlen(reference));
+}
+
+static void
+collectKeys(void)
+{
+    /* the FCs under every DO */
+    for (int i = 0; i < definitionCount; i++) {
+        if (definitions[i].type == DEF_DA) {
+            for (int p = definitions[i].parent; p >= 0 && definitions[p].type >= DEF_DO; p = definitions[p].parent)
+                if (definitions[p].type == DEF_DO)
+                    definitions[p].fcs |= 1u << definitions[i].fc;
+        }
+    }
+
+    for (int i = 0; i < definitionCount; i++) {
+        Definition* d = &definitions[i];
+        char* reference;
+
+        if (d->type == DEF_DATA_SET_ENTRY)
+            continue;
+
+        if (d->type == DEF_LD) {
+            if (d->name)
+                addKey(copyString(d->name, strlen(d->name)), MODEL_INDEX_NODE, -1, i);
+        }
+        else if (d->type == DEF_DATA_SET) {
+            if (d->ldName == NULL || d->name == NULL)
+                fail("unnamed data set %s", d->symbol);
+
+            /* LN$name, and LN.name */
+            reference = makeReference(d->ldName, d->name, NULL, -1, DEF_DO);
+            addKey(reference, MODEL_INDEX_DATA_SET, -1, i);
+
+            reference = copyString(reference, strlen(reference));
+
+            for (char* c = strchr(reference, '/'); *c; c++)
+                if (*c == '$')
+                    *c = '.';
+
+            addKey(reference, MODEL_INDEX_DATA_SET, -1, i);
+        }
+        else {
+            int ln = ancestor(d->type == DEF_RCB ? d->parent : i, DEF_LN);
+            int ld = ancestor(ln, DEF_LD);
+
+            if (ln < 0 || ld < 0 || definitions[ln].name == NULL || definitions[ld].name == NULL)
+                fail("%s is not in a logical node", d->symbol);
+
+            const char* ldName = definitions[ld].name;
+            const char* lnName = definitions[ln].name;
+
+            if (d->type == DEF_LN) {
+                addKey(makeReference(ldName, lnName, NULL, -1, DEF_DO), MODEL_INDEX_NODE, -1, i);
+            }
+            else if (d->type == DEF_RCB) {
+                char buffer[1024];
+                const char* fc = d->buffered ? "BR" : "RP";
+
+                if (d->name == NULL)
+                    fail("unnamed RCB %s", d->symbol);
+
+                snprintf(buffer, sizeof(buffer), "%s/%s.%s.%s", ldName, lnName, fc, d->name);
+                addKey(copyString(buffer, strlen(buffer)), MODEL_INDEX_RCB, -1, i);
+
+                snprintf(buffer, sizeof(buffer), "%s/%s$%s$%s", ldName, lnName, fc, d->name);
+                addKey(copyString(buffer, strlen(buffer)), MODEL_INDEX_RCB, -1, i);
+            }
+            else {
+                /* DO or DA: skipped under array elements, which have no name */
+                reference = makeReference(ldName, lnName, NULL, i, DEF_DO);
+
+                if (reference == NULL)
+                    continue;
+
+                addKey(reference, MODEL_INDEX_NODE, -1, i);
+
+                for (int fc = 0; fc < FC_COUNT; fc++) {
+                    if (d->type == DEF_DA ? d->fc == fc : (d->fcs & (1u << fc)) != 0)
+                        addKey(makeReference(ldName, lnName, fcNames[fc], i, DEF_DO), MODEL_INDEX_NODE, fc, i);
+                }
+            }
+        }
+    }
+}
+
+static int
+compareHashes(const void* a, const void* b)
+{
+    const Key* x = (const Key*) a;
+    const Key* y = (const Key*) b;
+
+    return x->hash < y->hash ? -1 : x->hash > y->hash;
+}
+
+static uint32_t bucketCount;
+static uint32_t slotCount;
+static uint32_t* seeds;
+static int* slots;              /* key index, -1: free */
+
+static void
+buildTable(void)
+{
+    qsort(keys, keyCount, sizeof(Key), compareHashes);
+
+    for (int i = 1; i < keyCount; i++) {
+        if (keys[i].hash == keys[i - 1].hash) {
+            if (strcmp(keys[i].reference, keys[i - 1].reference) == 0)
+                fail("duplicate reference %s", keys[i].reference);
+
+            fail("hash collision at %s, rename a node", keys[i].reference);
+        }
+    }
+
+    bucketCount = (keyCount + BUCKET_SIZE - 1) / BUCKET_SIZE;
+    slotCount = keyCount + keyCount / SLOT_RESERVE + 1;
+
+    if (bucketCount == 0)
+        bucketCount = 1;
+
+    seeds = (uint32_t*) calloc(bucketCount, sizeof(uint32_t));
+    slots = (int*) malloc(slotCount * sizeof(int));
+
+    int* bucketOf = (int*) malloc((keyCount + 1) * sizeof(int));
+    int* bucketStart = (int*) calloc(bucketCount + 1, sizeof(int));
+    int* members = (int*) malloc((keyCount + 1) * sizeof(int));
+    int* order = (int*) malloc(bucketCount * sizeof(int));
+    uint32_t* placed = (uint32_t*) malloc(BUCKET_SIZE * 64 * sizeof(uint32_t));
+
+    if (!seeds || !slots || !bucketOf || !bucketStart || !members || !order || !placed)
+        fail("out of memory%s", "");
+
+    for (uint32_t s = 0; s < slotCount; s++)
+        slots[s] = -1;
+
+    /* bucket member lists, counting sort */
+    for (int i = 0; i < keyCount; i++) {
+        bucketOf[i] = ModelIndex_slot(keys[i].hash, 0, bucketCount);
+        bucketStart[bucketOf[i] + 1]++;
+    }
+
+    int largest = 0;
+
+    for (uint32_t b = 0; b < bucketCount; b++) {
+        if (bucketStart[b + 1] > largest)
+            largest = bucketStart[b + 1];
+
+        bucketStart[b + 1] += bucketStart[b];
+    }
+
+    if (largest > BUCKET_SIZE * 64)
+        fail("bucket too large%s", "");
+
+    int* fill = (int*) calloc(bucketCount, sizeof(int));
+
+    for (int i = 0; i < keyCount; i++)
+        members[bucketStart[bucketOf[i]] + fill[bucketOf[i]]++] = i;
+
+    /* the largest buckets first, while most slots are free */
+    int orderCount = 0;
+
+    for (int size = largest; size > 0; size--)
+        for (uint32_t b = 0; b < bucketCount; b++)
+            if (bucketStart[b + 1] - bucketStart[b] == size)
+                order[orderCount++] = b;
+
+    for (int o = 0; o < orderCount; o++) {
+        int b = order[o];
+        int size = bucketStart[b + 1] - bucketStart[b];
+        uint32_t seed;
+
+        for (seed = 1; seed < MAX_SEED; seed++) {
+            int m;
+
+            for (m = 0; m < size; m++) {
+                uint32_t slot = ModelIndex_slot(keys[members[bucketStart[b] + m]].hash, seed, slotCount);
+                int k;
+
+                if (slots[slot] >= 0)
+                    break;
+
+                for (k = 0; k < m; k++)
+                    if (placed[k] == slot)
+                        break;
+
+                if (k < m)
+                    break;
+
+                placed[m] = slot;
+            }
+
+            if (m == size)
+                break;
+        }
+
+        if (seed == MAX_SEED)
+            fail("no perfect hash found%s", "");
+
+        seeds[b] = seed;
+
+        for (int m = 0; m < size; m++)
+            slots[placed[m]] = members[bucketStart[b] + m];
+    }
+
+    free(fill);
+    free(placed);
+    free(order);
+    free(members);
+    free(bucketStart);
+    free(bucketOf);
+}
+
+static void
+writeIndex(const char* fileName, const char* modelFileName, bool compact)
+{
+    FILE* file = fopen(fileName, "w");
+
+    if (file == NULL)
+        fail("cannot create %s", fileName);
+
+    fprintf(file, "/*\n * %s\n *\n * automatically generated from %s by genindex\n */\n", fileName, modelFileName);
+    fprintf(file, "#include \"static_model.h\"\n#include \"modelindex.h\"\n\n");
+
+    /* the compact static_model.h has them as array elements */
+    for (int i = 0; i < definitionCount && !compact; i++) {
+        if (definitions[i].type == DEF_DATA_SET)
+            fprintf(file, "extern DataSet %s;\n", definitions[i].symbol);
+        else if (definitions[i].type == DEF_RCB)
+            fprintf(file, "extern ReportControlBlock %s;\n", definitions[i].symbol);
+    }
+
+    fprintf(file, "\nconst uint32_t modelIndexBucketCount = %u;\n", bucketCount);
+    fprintf(file, "const uint32_t modelIndexSlotCount = %u;\n\n", slotCount);
+
+    fprintf(file, "const uint32_t modelIndexSeeds[] = {");
+
+    for (uint32_t b = 0; b < bucketCount; b++)
+        fprintf(file, "%s%u%s", b % 16 ? " " : "\n    ", seeds[b], b + 1 < bucketCount ? "," : "");
+
+    fprintf(file, "\n};\n\nconst ModelIndexEntry modelIndexEntries[] = {\n");
+
+    static const char* kinds[] = { "MODEL_INDEX_NODE", "MODEL_INDEX_DATA_SET", "MODEL_INDEX_RCB" };
+
+    for (uint32_t s = 0; s < slotCount; s++) {
+        const char* separator = s + 1 < slotCount ? "," : "";
+
+        if (slots[s] < 0) {
+            fprintf(file, "    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL }%s\n", separator);
+            continue;
+        }
+
+        const Key* key = &keys[slots[s]];
+
+        fprintf(file, "    { \"%s\", %s, IEC61850_FC_%s, &%s }%s\n", key->reference, kinds[key->kind],
+                key->fc >= 0 ? fcNames[key->fc] : "NONE", definitions[key->definition].symbol, separator);
+    }
+
+    fprintf(file, "};\n");
+
+    if (fclose(file) != 0)
+        fail("cannot write %s", fileName);
+}
+
+/* An initializeValues statement: symbol.mmsValue = MmsValue_new...(argument); */
+typedef enum {
+    VALUE_INT32,
+    VALUE_UINT32,
+    VALUE_BOOLEAN,
+    VALUE_FLOAT,
+    VALUE_VISIBLE_STRING,
+    VALUE_COUNT
+} ValueType;
+
+static const char* valueConstructors[] = {
+    "MmsValue_newIntegerFromInt32", "MmsValue_newUnsignedFromUint32", "MmsValue_newBoolean",
+    "MmsValue_newFloat", "MmsValue_newVisibleString"
+};
+
+static const char* valueTypeNames[] = {
+    "VALUE_INT32", "VALUE_UINT32", "VALUE_BOOLEAN", "VALUE_FLOAT", "VALUE_VISIBLE_STRING"
+};
+
+typedef struct {
+    int attribute;      /* definition index */
+    ValueType type;
+    char* argument;
+    bool isDefault;     /* what the server's value cache starts with anyway */
+} InitialValue;
+
+static InitialValue* initialValues = NULL;
+static int initialValueCount = 0;
+static int initialValueCapacity = 0;
+
+/* Whether the line is a statement the table can hold */
+static bool
+parseInitialValue(const char* line, const char* end, InitialValue* value)
+{
+    static const char pattern[] = ".mmsValue = MmsValue_new";
+    const char* assignment = line;
+
+    /* within the line only */
+    while ((assignment = (const char*) memchr(assignment, '.', end - assignment)) != NULL &&
+            strncmp(assignment, pattern, sizeof(pattern) - 1) != 0)
+        assignment++;
+
+    if (assignment == NULL)
+        return false;
+
+    char* symbol = copyString(line, assignment - line);
+    int attribute = findDefinition(symbol);
+
+    free(symbol);
+
+    if (attribute < 0 || definitions[attribute].type != DEF_DA)
+        return false;
+
+    const char* call = assignment + strlen(".mmsValue = ");
+
+    while (end > call && strchr(" \t\r", end[-1]))
+        end--;
+
+    for (int type = 0; type < VALUE_COUNT; type++) {
+        size_t length = strlen(valueConstructors[type]);
+
+        if (strncmp(call, valueConstructors[type], length) != 0 || call[length] != '(')
+            continue;
+
+        if (end - call < (long) length + 3 || strncmp(end - 2, ");", 2) != 0)
+            return false;
+
+        char* argument = copyString(call + length + 1, end - 2 - (call + length + 1));
+        char* rest = NULL;
+        bool isDefault = false;
+
+        if (type == VALUE_INT32 || type == VALUE_UINT32)
+            isDefault = strtol(argument, &rest, 0) == 0;
+        else if (type == VALUE_FLOAT)
+            isDefault = strtod(argument, &rest) == 0;
+        else if (type == VALUE_BOOLEAN) {
+            rest = argument + (strcmp(argument, "true") == 0 ? 4 : strcmp(argument, "false") == 0 ? 5 : 0);
+            isDefault = strcmp(argument, "false") == 0;
+        }
+        else {
+            size_t argumentLength = strlen(argument);
+
+            rest = argumentLength >= 2 && argument[0] == '"' && argument[argumentLength - 1] == '"' ? argument + argumentLength : argument;
+            isDefault = strcmp(argument, "\"\"") == 0;
+        }
+
+        /* expressions stay statements */
+        if (rest == argument || *rest != 0) {
+            free(argument);
+            return false;
+        }
+
+        value->attribute = attribute;
+        value->type = (ValueType) type;
+        value->argument = argument;
+        value->isDefault = isDefault;
+
+        return true;
+    }
+
+    return false;
+}
+
+static void
+collectInitialValues(const char* text)
+{
+    for (const char* line = text; *line; ) {
+        const char* end = strchr(line, '\n');
+
+        if (end == NULL)
+            end = line + strlen(line);
+
+        InitialValue value;
+
+        if (parseInitialValue(line, end, &value)) {
+            if (initialValueCount == initialValueCapacity)
+                initialValues = (InitialValue*) grow(initialValues, &initialValueCapacity, sizeof(InitialValue));
+
+            initialValues[initialValueCount++] = value;
+        }
+
+        line = *end ? end + 1 : end;
+    }
+}
+
+static void
+writeInitialValues(FILE* file)
+{
+    int count = 0;
+
+    for (int i = 0; i < initialValueCount; i++)
+        if (!initialValues[i].isDefault)
+            count++;
+
+    if (count == 0)
+        return;
+
+    fprintf(file, "/* Initial values other than the defaults of the server's value cache */\n");
+    fprintf(file, "enum {\n");
+
+    for (int type = 0; type < VALUE_COUNT; type++)
+        fprintf(file, "    %s%s\n", valueTypeNames[type], type + 1 < VALUE_COUNT ? "," : "");
+
+    fprintf(file, "};\n\ntypedef struct {\n    uint32_t attribute;\n    uint8_t type;\n    int32_t integer;\n");
+    fprintf(file, "    float real;\n    const char* text;\n} StaticModelInitialValue;\n\n");
+    fprintf(file, "static const StaticModelInitialValue initialValues[] = {\n");
+
+    for (int i = 0; i < initialValueCount; i++) {
+        const InitialValue* v = &initialValues[i];
+
+        if (v->isDefault)
+            continue;
+
+        fprintf(file, "    { %i, %s, ", definitions[v->attribute].element, valueTypeNames[v->type]);
+
+        if (v->type == VALUE_INT32)
+            fprintf(file, "%s, 0, NULL }", v->argument);
+        else if (v->type == VALUE_UINT32)
+            fprintf(file, "(int32_t) %su, 0, NULL }", v->argument);
+        else if (v->type == VALUE_BOOLEAN)
+            fprintf(file, "%s, 0, NULL }", v->argument);
+        else if (v->type == VALUE_FLOAT)
+            fprintf(file, "0, (float) %s, NULL }", v->argument);
+        else
+            fprintf(file, "0, 0, %s }", v->argument);
+
+        fprintf(file, "%s /* %s */\n", --count ? "," : "", definitions[v->attribute].symbol);
+    }
+
+    fprintf(file, "};\n\n");
+
+    fprintf(file,
+            "static void\n"
+            "installInitialValues()\n"
+            "{\n"
+            "    for (size_t i = 0; i < sizeof(initialValues) / sizeof(initialValues[0]); i++) {\n"
+            "        const StaticModelInitialValue* v = &initialValues[i];\n"
+            "        MmsValue* value = NULL;\n"
+            "\n"
+            "        switch (v->type) {\n"
+            "        case VALUE_INT32:\n"
+            "            value = MmsValue_newIntegerFromInt32(v->integer);\n"
+            "            break;\n"
+            "        case VALUE_UINT32:\n"
+            "            value = MmsValue_newUnsignedFromUint32((uint32_t) v->integer);\n"
+            "            break;\n"
+            "        case VALUE_BOOLEAN:\n"
+            "            value = MmsValue_newBoolean(v->integer != 0);\n"
+            "            break;\n"
+            "        case VALUE_FLOAT:\n"
+            "            value = MmsValue_newFloat(v->real);\n"
+            "            break;\n"
+            "        case VALUE_VISIBLE_STRING:\n"
+            "            value = MmsValue_newVisibleString(v->text);\n"
+            "            break;\n"
+            "        }\n"
+            "\n"
+            "        iedModelAttributes[v->attribute].mmsValue = value;\n"
+            "    }\n"
+            "}\n\n");
+}
+
+/* Order of the arrays: the model tree first, as the server walks it */
+static const DefinitionType arrayOrder[] = {
+    DEF_LD, DEF_LN, DEF_DO, DEF_DA, DEF_DATA_SET_ENTRY, DEF_DATA_SET, DEF_RCB
+};
+
+static void
+writeArrays(FILE* file)
+{
+    fprintf(file, "/* Compact layout (genindex --compact): the definitions of each type in one array, in model order */\n\n");
+
+    for (int a = 0; a < DEF_COUNT; a++) {
+        DefinitionType type = arrayOrder[a];
+        int count = 0;
+
+        for (int i = 0; i < definitionCount; i++)
+            if (definitions[i].type == type)
+                count++;
+
+        if (count == 0)
+            continue;
+
+        fprintf(file, "%s %s[%i] = {\n", definitionTypes[type], arrayNames[type], count);
+
+        for (int i = 0; i < definitionCount; i++) {
+            if (definitions[i].type != type)
+                continue;
+
+            char* fields[MAX_FIELDS];
+            int fieldCount = splitFields(definitions[i].initializer, fields);
+
+            /* a trailing comma leaves an empty field */
+            if (fieldCount > 0 && fields[fieldCount - 1][0] == 0)
+                free(fields[--fieldCount]);
+
+            fprintf(file, "    {");
+
+            for (int f = 0; f < fieldCount; f++) {
+                fprintf(file, "%s%s", f ? ", " : "", fields[f]);
+                free(fields[f]);
+            }
+
+            fprintf(file, "}%s /* %s */\n", --count ? "," : "", definitions[i].symbol);
+        }
+
+        fprintf(file, "};\n\n");
+    }
+
+    writeInitialValues(file);
+}
+
+static const char*
+skipEmptyLine(const char* s)
+{
+    const char* end = s;
+
+    while (*end == ' ' || *end == '\t' || *end == '\r')
+        end++;
+
+    return *end == '\n' ? end + 1 : s;
+}
+
+/* The definition declared by an extern line, -1 for other lines */
+static int
+externDefinition(const char* line, const char* end)
+{
+    if (strncmp(line, "extern ", 7) != 0)
+        return -1;
+
+    const char* symbol = line + 7;
+
+    while (symbol < end && *symbol != ' ')
+        symbol++;
+
+    while (symbol < end && *symbol == ' ')
+        symbol++;
+
+    const char* symbolEnd = symbol;
+
+    while (symbolEnd < end && *symbolEnd != ';' && *symbolEnd != ' ')
+        symbolEnd++;
+
+    char* name = copyString(symbol, symbolEnd - symbol);
+    int definition = findDefinition(name);
+
+    free(name);
+
+    return definition;
+}
+
+/* Rewrites static_model.c, everything else kept as it is */
+static void
+writeCompactModel(const char* fileName, const char* text)
+{
+    FILE* file = fopen(fileName, "w");
+    int next = 0;
+    bool arraysWritten = false;
+    bool installerCalled = false;
+    bool lastEmpty = false;
+
+    if (file == NULL)
+        fail("cannot create %s", fileName);
+
+    for (const char* line = text; *line; ) {
+        const char* newline = strchr(line, '\n');
+        const char* end = newline ? newline + 1 : line + strlen(line);
+
+        if (next < definitionCount && line == definitions[next].start) {
+            if (!arraysWritten) {
+                writeArrays(file);
+                arraysWritten = true;
+            }
+
+            line = skipEmptyLine(definitions[next++].end);
+            continue;
+        }
+
+        InitialValue value;
+
+        if (externDefinition(line, end) >= 0) {
+            line = end;
+            continue;
+        }
+
+        if (parseInitialValue(line, newline ? newline : end, &value)) {
+            if (!value.isDefault && !installerCalled) {
+                fprintf(file, "installInitialValues();\n\n");
+                installerCalled = true;
+            }
+
+            free(value.argument);
+            line = skipEmptyLine(end);
+            continue;
+        }
+
+        /* one empty line where the removed declarations leave several */
+        bool empty = skipEmptyLine(line) == end;
+
+        if (!empty || !lastEmpty)
+            fwrite(line, 1, end - line, file);
+
+        lastEmpty = empty;
+        line = end;
+    }
+
+    if (fclose(file) != 0)
+        fail("cannot write %s", fileName);
+}
+
+/* Rewrites static_model.h: the extern declarations become macros for the array elements */
+static void
+writeCompactHeader(const char* fileName)
+{
+    char* text = readFile(fileName);
+    char* endif = NULL;
+
+    for (char* s = strstr(text, "#endif"); s; s = strstr(s + 1, "#endif"))
+        endif = s;
+
+    if (endif == NULL)
+        fail("no #endif in %s", fileName);
+
+    FILE* file = fopen(fileName, "w");
+    bool* defined = (bool*) calloc(definitionCount + 1, sizeof(bool));
+
+    if (file == NULL)
+        fail("cannot create %s", fileName);
+
+    for (const char* line = text; line < endif; ) {
+        const char* end = strchr(line, '\n');
+
+        end = end && end < endif ? end + 1 : endif;
+
+        int definition = externDefinition(line, end);
+
+        if (definition >= 0) {
+            const Definition* d = &definitions[definition];
+
+            fprintf(file, "#define %s (%s[%i])\n", d->symbol, arrayNames[d->type], d->element);
+            defined[definition] = true;
+        }
+        else
+            fwrite(line, 1, end - line, file);
+
+        line = end;
+    }
+
+    fprintf(file, "/* Compact layout: every definition is an element of one of these arrays */\n");
+
+    for (int a = 0; a < DEF_COUNT; a++) {
+        for (int i = 0; i < definitionCount; i++) {
+            if (definitions[i].type == arrayOrder[a]) {
+                fprintf(file, "extern %s %s[];\n", definitionTypes[arrayOrder[a]], arrayNames[arrayOrder[a]]);
+                break;
+            }
+        }
+    }
+
+    fprintf(file, "\n");
+
+    for (int i = 0; i < definitionCount; i++)
+        if (!defined[i])
+            fprintf(file, "#define %s (%s[%i])\n", definitions[i].symbol, arrayNames[definitions[i].type], definitions[i].element);
+
+    fprintf(file, "\n%s", endif);
+
+    if (fclose(file) != 0)
+        fail("cannot write %s", fileName);
+
+    free(defined);
+    free(text);
+}
+
+static void
+compactModel(const char* modelFileName, const char* text)
+{
+    size_t length = strlen(modelFileName);
+
+    if (length < 2 || strcmp(modelFileName + length - 2, ".c") != 0)
+        fail("%s is not a .c file", modelFileName);
+
+    char* headerFileName = copyString(modelFileName, length);
+
+    headerFileName[length - 1] = 'h';
+
+    int counts[DEF_COUNT] = { 0 };
+
+    for (int i = 0; i < definitionCount; i++)
+        definitions[i].element = counts[definitions[i].type]++;
+
+    collectInitialValues(text);
+
+    writeCompactModel(modelFileName, text);
+    writeCompactHeader(headerFileName);
+
+    int defaults = 0;
+
+    for (int i = 0; i < initialValueCount; i++)
+        if (initialValues[i].isDefault)
+            defaults++;
+
+    printf("genindex: %i definitions in %s and %s as array elements, %i initial values in a table, "
+            "%i left to the value cache\n", definitionCount, modelFileName, headerFileName,
+            initialValueCount - defaults, defaults);
+
+    free(headerFileName);
+}
+
+int
+main(int argc, char** argv)
+{
+    bool compact = argc == 4 && strcmp(argv[1], "--compact") == 0;
+
+    if (argc != 3 && !compact) {
+        printf("Usage: genindex [--compact] static_model.c static_model_index.c\n");
+        return 1;
+    }
+
+    const char* modelFileName = argv[argc - 2];
+    const char* indexFileName = argv[argc - 1];
+    char* text = readFile(modelFileName);
+
+    if (strstr(text, arrayNames[DEF_DA]))
+        fail("%s has the compact layout already, generate it again with genmodel", modelFileName);
+
+    parseModel(text);
+    collectKeys();
+
+    if (keyCount == 0)
+        fail("no model in %s", modelFileName);
+
+    buildTable();
+    writeIndex(indexFileName, modelFileName, compact);
+
+    printf("genindex: %i references, %u buckets, %u slots -> %s\n", keyCount, bucketCount, slotCount, indexFileName);
+
+    if (compact)
+        compactModel(modelFileName, text);
+
+    return 0;
+}
@@ -0,0 +1,716 @@
+/*
+ *  loadgen.c
+ *
+ *  Synthetic points for load testing report and polling clients, see loadgen.h
+ */
+
+#include "loadgen.h"
+#include "iec61850_cdc.h"
+#include "hal_thread.h"
+#include "hal_time.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <mmsystem.h>
+#else
+#include <time.h>
+#endif
+
+#define MAX_GROUPS 64
+
+/* Periods a step holds its level, a burst lasts, and a burst cycle takes */
+#define STEP_PERIODS 10
+#define BURST_PERIODS 10
+#define BURST_CYCLE 100
+
+typedef enum {
+    PATTERN_WALK,
+    PATTERN_STEP,
+    PATTERN_BURST,
+    PATTERN_REPLAY
+} LoadPattern;
+
+static const char* patternNames[] = { "walk", "step", "burst", "replay" };
+
+typedef struct {
+    DataAttribute* value;       /* mag.f or stVal */
+    DataAttribute* t;
+    float level;
+    bool state;
+} LoadPoint;
+
+typedef struct {
+    bool analog;
+    int count;
+    int periodMs;
+    LoadPattern pattern;
+
+    LoadPoint* points;
+    uint64_t nextMs;
+    long periods;               /* periods applied so far */
+    uint32_t random;
+
+    int replayPosition;         /* next record of the recorded log */
+    uint64_t replayBaseMs;      /* local time of the log's start in this loop */
+} LoadGroup;
+
+/* One value of the recorded log */
+typedef struct {
+    int64_t offsetMs;           /* from the first record */
+    int tag;
+    float value;
+} ReplayRecord;
+
+static LoadGroup groups[MAX_GROUPS];
+static int groupCount = 0;
+
+static ReplayRecord* replay = NULL;
+static int replayCount = 0;
+
+static int batchSize = LOADGEN_BATCH;
+
+static IedServer server = NULL;
+static Thread generator = NULL;
+static volatile bool running = false;
+
+/* written by the generator thread */
+static bool locked = false;
+static int lockedUpdates = 0;
+static int64_t lockedSinceUs = 0;
+
+static volatile long long updates = 0;
+static volatile long long lockSections = 0;
+static volatile long long lockHoldUs = 0;
+static volatile long long lockHoldMaxUs = 0;   /* raised by the generator, taken and reset by the statistics */
+static volatile long long latePeriods = 0;
+
+static int64_t
+nowUs(void)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+
+    if (frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
+
+    QueryPerformanceCounter(&counter);
+
+    return (counter.QuadPart / frequency.QuadPart) * 1000000 +
+           (counter.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+/* xorshift32, in [0, 1) */
+static float
+nextRandom(LoadGroup* g)
+{
+    g->random ^= g->random << 13;
+    g->random ^= g->random >> 17;
+    g->random ^= g->random << 5;
+
+    return (g->random >> 8) * (1.0f / 16777216.0f);
+}
+
+/* ===================== Configuration ===================== */
+
+bool
+LoadGen_addGroup(const char* spec)
+{
+    char kind[8] = "";
+    char pattern[16] = "walk";
+    int count = 0;
+    int periodMs = 0;
+
+    if (groupCount == MAX_GROUPS) {
+        printf("LoadGen: at most %i groups\n", MAX_GROUPS);
+        return false;
+    }
+
+    if (sscanf(spec, "%7[^:]:%i:%i:%15s", kind, &count, &periodMs, pattern) < 3 ||
+            (strcmp(kind, "an") != 0 && strcmp(kind, "st") != 0) || count < 1 || periodMs < 1) {
+        printf("LoadGen: expected an|st:points:period ms[:pattern], got %s\n", spec);
+        return false;
+    }
+
+    LoadGroup* g = &groups[groupCount];
+    memset(g, 0, sizeof(LoadGroup));
+
+    g->analog = strcmp(kind, "an") == 0;
+    g->count = count;
+    g->periodMs = periodMs;
+    g->random = 2463534242u + groupCount;
+
+    int p;
+    for (p = 0; p < 4; p++)
+        if (strcmp(pattern, patternNames[p]) == 0)
+            break;
+
+    if (p == 4) {
+        printf("LoadGen: unknown pattern %s (walk, step, burst, replay)\n", pattern);
+        return false;
+    }
+
+    g->pattern = (LoadPattern) p;
+    groupCount++;
+
+    return true;
+}
+
+void
+LoadGen_setBatchSize(int updatesPerLock)
+{
+    batchSize = updatesPerLock > 0 ? updatesPerLock : LOADGEN_BATCH;
+}
+
+/* ===================== Recorded Log ===================== */
+
+static int64_t
+daysFromCivil(int y, int m, int d)
+{
+    y -= m <= 2;
+
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return (int64_t) era * 146097 + doe - 719468;
+}
+
+/* "2025-01-31T12:00:00.123Z" as ms since 1970, -1 if it is not a time */
+static int64_t
+parseTime(const char* text)
+{
+    int y, mo, d, h, mi, s, ms = 0;
+
+    if (sscanf(text, "%d-%d-%dT%d:%d:%d.%3d", &y, &mo, &d, &h, &mi, &s, &ms) < 6)
+        return -1;
+
+    return ((daysFromCivil(y, mo, d) * 24 + h) * 60 + mi) * 60000LL + s * 1000LL + ms;
+}
+
+/* The tags of the log numbered in order of appearance */
+typedef struct {
+    char** names;
+    int count;
+    int capacity;
+    int* slots;                 /* open addressing, index + 1 */
+    int slotCount;
+} TagTable;
+
+static uint32_t
+hashText(const char* s)
+{
+    uint32_t h = 2166136261u;
+
+    while (*s)
+        h = (h ^ (uint8_t) *s++) * 16777619u;
+
+    return h;
+}
+
+static int
+tagIndex(TagTable* t, const char* name)
+{
+    if (2 * (t->count + 1) > t->slotCount) {
+        free(t->slots);
+        t->slotCount = t->slotCount ? t->slotCount * 2 : 1024;
+        t->slots = calloc(t->slotCount, sizeof(int));
+
+        for (int i = 0; i < t->count; i++) {
+            uint32_t k = hashText(t->names[i]) & (t->slotCount - 1);
+
+            while (t->slots[k])
+                k = (k + 1) & (t->slotCount - 1);
+
+            t->slots[k] = i + 1;
+        }
+    }
+
+    uint32_t k = hashText(name) & (t->slotCount - 1);
+
+    while (t->slots[k]) {
+        if (strcmp(t->names[t->slots[k] - 1], name) == 0)
+            return t->slots[k] - 1;
+
+        k = (k + 1) & (t->slotCount - 1);
+    }
+
+    if (t->count == t->capacity) {
+        t->capacity = t->capacity ? t->capacity * 2 : 256;
+        t->names = realloc(t->names, t->capacity * sizeof(char*));
+    }
+
+    t->names[t->count] = strdup(name);
+    t->slots[k] = t->count + 1;
+
+    return t->count++;
+}
+
+static int
+splitFields(char* line, char** fields, int maxFields)
+{
+    int n = 0;
+
+    fields[n++] = line;
+
+    for (char* c = line; *c && n < maxFields; c++) {
+        if (*c == ',') {
+            *c = 0;
+            fields[n++] = c + 1;
+        }
+        else if (*c == '\r' || *c == '\n')
+            *c = 0;
+    }
+
+    return n;
+}
+
+bool
+LoadGen_setReplayFile(const char* fileName)
+{
+    FILE* f = fopen(fileName, "r");
+
+    if (f == NULL) {
+        printf("LoadGen: cannot open %s\n", fileName);
+        return false;
+    }
+
+    char line[2048];
+    char* fields[16];
+
+    /* the columns by their header name: logs of the Polling and BRCB loggers */
+    int timeField = -1, iedField = -1, tagField = -1, valueField = -1;
+    int fieldCount = fgets(line, sizeof(line), f) ? splitFields(line, fields, 16) : 0;
+
+    for (int i = 0; i < fieldCount; i++) {
+        if (strcmp(fields[i], "time") == 0) timeField = i;
+        else if (strcmp(fields[i], "ied") == 0) iedField = i;
+        else if (strcmp(fields[i], "tag") == 0) tagField = i;
+        else if (strcmp(fields[i], "value") == 0) valueField = i;
+    }
+
+    if (timeField < 0 || tagField < 0 || valueField < 0) {
+        printf("LoadGen: %s has no time, tag and value columns\n", fileName);
+        fclose(f);
+        return false;
+    }
+
+    TagTable tags = { 0 };
+    int capacity = 0;
+    int64_t firstMs = -1;
+
+    while (fgets(line, sizeof(line), f)) {
+        /* structures have commas in the value: not a number anyway */
+        if (splitFields(line, fields, 16) != fieldCount)
+            continue;
+
+        int64_t ms = parseTime(fields[timeField]);
+        const char* text = fields[valueField];
+        float value;
+
+        if (ms < 0)
+            continue;
+
+        if (strcmp(text, "true") == 0)
+            value = 1;
+        else if (strcmp(text, "false") == 0)
+            value = 0;
+        else {
+            char* end;
+            value = strtof(text, &end);
+
+            if (end == text)
+                continue;
+        }
+
+        char key[512];
+        snprintf(key, sizeof(key), "%s|%s", iedField >= 0 ? fields[iedField] : "", fields[tagField]);
+
+        if (replayCount == capacity) {
+            capacity = capacity ? capacity * 2 : 4096;
+            replay = realloc(replay, capacity * sizeof(ReplayRecord));
+        }
+
+        if (firstMs < 0)
+            firstMs = ms;
+
+        ReplayRecord* r = &replay[replayCount++];
+
+        r->offsetMs = ms - firstMs;
+        r->tag = tagIndex(&tags, key);
+        r->value = value;
+    }
+
+    fclose(f);
+
+    printf("LoadGen: replaying %i values of %i tags over %.1f s from %s\n", replayCount, tags.count,
+            replayCount ? replay[replayCount - 1].offsetMs / 1000.0 : 0.0, fileName);
+
+    for (int i = 0; i < tags.count; i++)
+        free(tags.names[i]);
+
+    free(tags.names);
+    free(tags.slots);
+
+    return replayCount > 0;
+}
+
+/* ===================== Model ===================== */
+
+void
+LoadGen_createModel(IedModel* model)
+{
+    if (groupCount == 0)
+        return;
+
+    LogicalDevice* ld = LogicalDevice_create("LoadGen", model);
+    LogicalNode* lln0 = LogicalNode_create("LLN0", ld);
+
+    int lnCount = 0;
+    int pointCount = 0;
+
+    for (int i = 0; i < groupCount; i++) {
+        LoadGroup* g = &groups[i];
+        LogicalNode* ggio = NULL;
+        DataSet* dataSet = NULL;
+        char lnName[16];
+
+        g->points = calloc(g->count, sizeof(LoadPoint));
+
+        for (int k = 0; k < g->count; k++) {
+            int index = k % LOADGEN_POINTS_PER_LN;
+
+            /* every group starts its own GGIO; one data set and two RCBs for each */
+            if (index == 0) {
+                char name[32];
+
+                lnCount++;
+                snprintf(lnName, sizeof(lnName), "GGIO%i", lnCount);
+                ggio = LogicalNode_create(lnName, ld);
+
+                snprintf(name, sizeof(name), "Load%i", lnCount);
+                dataSet = DataSet_create(name, lln0);
+
+                char rcbName[32];
+
+                snprintf(rcbName, sizeof(rcbName), "LoadBR%i", lnCount);
+                ReportControlBlock_create(rcbName, lln0, rcbName, true, name, 1,
+                        TRG_OPT_DATA_CHANGED | TRG_OPT_QUALITY_CHANGED | TRG_OPT_INTEGRITY | TRG_OPT_GI,
+                        RPT_OPT_SEQ_NUM | RPT_OPT_TIME_STAMP | RPT_OPT_REASON_FOR_INCLUSION |
+                        RPT_OPT_DATA_SET | RPT_OPT_ENTRY_ID | RPT_OPT_BUFFER_OVERFLOW, 50, 0);
+
+                snprintf(rcbName, sizeof(rcbName), "LoadRP%i", lnCount);
+                ReportControlBlock_create(rcbName, lln0, rcbName, false, name, 1,
+                        TRG_OPT_DATA_CHANGED | TRG_OPT_QUALITY_CHANGED | TRG_OPT_INTEGRITY | TRG_OPT_GI,
+                        RPT_OPT_SEQ_NUM | RPT_OPT_TIME_STAMP | RPT_OPT_REASON_FOR_INCLUSION |
+                        RPT_OPT_DATA_SET, 50, 0);
+            }
+
+            LoadPoint* p = &g->points[k];
+            char doName[16];
+            char member[48];
+
+            snprintf(doName, sizeof(doName), "%s%i", g->analog ? "AnIn" : "Ind", index + 1);
+
+            if (g->analog) {
+                ModelNode* mv = (ModelNode*) CDC_MV_create(doName, (ModelNode*) ggio, 0, false);
+
+                p->value = (DataAttribute*) ModelNode_getChild(ModelNode_getChild(mv, "mag"), "f");
+                p->t = (DataAttribute*) ModelNode_getChild(mv, "t");
+            }
+            else {
+                ModelNode* sps = (ModelNode*) CDC_SPS_create(doName, (ModelNode*) ggio, 0);
+
+                p->value = (DataAttribute*) ModelNode_getChild(sps, "stVal");
+                p->t = (DataAttribute*) ModelNode_getChild(sps, "t");
+            }
+
+            snprintf(member, sizeof(member), "%s$%s$%s", lnName, g->analog ? "MX" : "ST", doName);
+            DataSetEntry_create(dataSet, member, -1, NULL);
+        }
+
+        pointCount += g->count;
+
+        printf("LoadGen: %i %s points every %i ms (%s)\n", g->count, g->analog ? "analog" : "status",
+                g->periodMs, patternNames[g->pattern]);
+    }
+
+    printf("LoadGen: %i points in LoadGen/GGIO1..%i, data sets LLN0.Load1..%i, RCBs LoadBR1.. / LoadRP1..\n",
+            pointCount, lnCount, lnCount);
+}
+
+/* ===================== Generator ===================== */
+
+/* *max = value if larger; a reset by takeMax in between is not overwritten with an older maximum */
+static void
+raiseMax(volatile long long* max, long long value)
+{
+    long long current = *max;
+
+    while (value > current) {
+#ifdef _WIN32
+        long long seen = InterlockedCompareExchange64(max, value, current);
+#else
+        long long seen = __sync_val_compare_and_swap(max, current, value);
+#endif
+        if (seen == current)
+            break;
+
+        current = seen;
+    }
+}
+
+/* The maximum so far, reset to 0 in the same step */
+static long long
+takeMax(volatile long long* max)
+{
+#ifdef _WIN32
+    return InterlockedExchange64(max, 0);
+#else
+    return __sync_lock_test_and_set(max, 0);
+#endif
+}
+
+static void
+endSection(void)
+{
+    if (!locked)
+        return;
+
+    IedServer_unlockDataModel(server);
+
+    int64_t held = nowUs() - lockedSinceUs;
+
+    locked = false;
+    lockSections++;
+    lockHoldUs += held;
+
+    raiseMax(&lockHoldMaxUs, held);
+
+    updates += lockedUpdates;
+}
+
+/* The data model held for the next update; other threads get it every batchSize updates */
+static void
+beginUpdate(void)
+{
+    if (locked && lockedUpdates >= batchSize)
+        endSection();
+
+    if (!locked) {
+        IedServer_lockDataModel(server);
+
+        locked = true;
+        lockedUpdates = 0;
+        lockedSinceUs = nowUs();
+    }
+
+    lockedUpdates++;
+}
+
+static void
+setPoint(LoadGroup* g, LoadPoint* p, float level, bool state, uint64_t now)
+{
+    beginUpdate();
+
+    if (g->analog) {
+        bool changed = level != p->level;
+
+        p->level = level;
+        IedServer_updateFloatAttributeValue(server, p->value, level);
+
+        if (changed)
+            IedServer_updateUTCTimeAttributeValue(server, p->t, now);
+    }
+    else {
+        bool changed = state != p->state;
+
+        p->state = state;
+        IedServer_updateBooleanAttributeValue(server, p->value, state);
+
+        if (changed)
+            IedServer_updateUTCTimeAttributeValue(server, p->t, now);
+    }
+}
+
+/* Every point of the group once */
+static void
+applyPeriod(LoadGroup* g, uint64_t now)
+{
+    long n = g->periods++;
+
+    for (int k = 0; k < g->count; k++) {
+        LoadPoint* p = &g->points[k];
+        float level = p->level;
+        bool state = p->state;
+
+        switch (g->pattern) {
+        case PATTERN_WALK:
+            level += nextRandom(g) - 0.5f;
+            if (nextRandom(g) < 0.02f)
+                state = !state;
+            break;
+
+        case PATTERN_STEP:
+            state = ((n / STEP_PERIODS) & 1) != 0;
+            level = state ? 100.0f : 0.0f;
+            break;
+
+        case PATTERN_BURST:
+            if (n % BURST_CYCLE < BURST_PERIODS) {
+                level += nextRandom(g) - 0.5f;
+                state = !state;
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        setPoint(g, p, level, state, now);
+    }
+}
+
+/* The recorded values due by now, recorded tag i on point i of the group */
+static void
+applyReplay(LoadGroup* g, uint64_t now)
+{
+    while (replayCount > 0 && replay[g->replayPosition].offsetMs <= (int64_t) (now - g->replayBaseMs)) {
+        ReplayRecord* r = &replay[g->replayPosition];
+
+        setPoint(g, &g->points[r->tag % g->count], r->value, r->value != 0, now);
+
+        /* looped, one period after the last record */
+        if (++g->replayPosition == replayCount) {
+            g->replayPosition = 0;
+            g->replayBaseMs += replay[replayCount - 1].offsetMs + g->periodMs;
+        }
+    }
+}
+
+static void*
+generatorThread(void* parameter)
+{
+    uint64_t start = Hal_getTimeInMs();
+
+    /* groups with the same period are spread across it */
+    for (int i = 0; i < groupCount; i++) {
+        groups[i].nextMs = start + (uint64_t) i * groups[i].periodMs / groupCount;
+        groups[i].replayBaseMs = start;
+    }
+
+    while (running) {
+        uint64_t now = Hal_getTimeInMs();
+
+        for (int i = 0; i < groupCount; i++) {
+            LoadGroup* g = &groups[i];
+
+            if (g->pattern == PATTERN_REPLAY) {
+                applyReplay(g, now);
+                continue;
+            }
+
+            if (now < g->nextMs)
+                continue;
+
+            applyPeriod(g, now);
+
+            /* periods that passed while we were late are skipped and counted */
+            g->nextMs += g->periodMs;
+
+            if (g->nextMs <= now) {
+                latePeriods += (now - g->nextMs) / g->periodMs + 1;
+                g->nextMs = now + g->periodMs;
+            }
+        }
+
+        endSection();
+
+        Thread_sleep(1);
+    }
+
+    return NULL;
+}
+
+void
+LoadGen_start(IedServer iedServer)
+{
+    if (groupCount == 0)
+        return;
+
+    for (int i = 0; i < groupCount; i++) {
+        if (groups[i].pattern == PATTERN_REPLAY && replayCount == 0) {
+            printf("LoadGen: replay group without a recorded log (--replay file), not started\n");
+            return;
+        }
+    }
+
+    server = iedServer;
+    running = true;
+
+#ifdef _WIN32
+    /* Thread_sleep(1) of the generator loop sleeps a whole 15.6 ms scheduler tick otherwise */
+    timeBeginPeriod(1);
+#endif
+
+    generator = Thread_create(generatorThread, NULL, false);
+    Thread_start(generator);
+}
+
+void
+LoadGen_stop(void)
+{
+    if (generator == NULL)
+        return;
+
+    running = false;
+    Thread_destroy(generator);
+    generator = NULL;
+
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+void
+LoadGen_printStatistics(void)
+{
+    static int64_t lastUs = 0;
+    static long long lastUpdates = 0, lastSections = 0, lastHoldUs = 0, lastLate = 0;
+
+    if (generator == NULL)
+        return;
+
+    int64_t now = nowUs();
+    double seconds = lastUs ? (now - lastUs) / 1000000.0 : 0;
+
+    long long sections = lockSections - lastSections;
+    long long holdMax = takeMax(&lockHoldMaxUs);
+    double configured = 0;
+
+    for (int i = 0; i < groupCount; i++)
+        if (groups[i].pattern != PATTERN_REPLAY)
+            configured += groups[i].count * 1000.0 / groups[i].periodMs;
+
+    if (seconds > 0)
+        printf("LoadGen: %.0f updates/s (configured %.0f), %lld lock sections, held %.1f us mean, %lld us max, %lld late periods\n",
+                (updates - lastUpdates) / seconds, configured, sections,
+                sections ? (double) (lockHoldUs - lastHoldUs) / sections : 0.0, holdMax, latePeriods - lastLate);
+
+    lastUs = now;
+    lastUpdates = updates;
+    lastSections = lockSections;
+    lastHoldUs = lockHoldUs;
+    lastLate = latePeriods;
+}
@@ -0,0 +1,59 @@
+/*
+ *  loadgen.h
+ *
+ *  Synthetic points for load testing report and polling clients.
+ *
+ *  The points are added to the static model, before the server is created,
+ *  as a logical device LoadGen built with the dynamic model API: 64 points
+ *  per GGIOn (AnInk: MV mag.f/q/t, Indk: SPS stVal/q/t), and in LLN0 per
+ *  GGIOn one data set Loadn with its BRCB LoadBRn and URCB LoadRPn.
+ *
+ *  Points come in groups, each with its own update period (1 ms and up)
+ *  and change pattern:
+ *    walk    analog random walk; status flips now and then
+ *    step    all points jump between two levels every 10 periods
+ *    burst   quiet, then every point changes each period for 10 of 100
+ *    replay  the values of a recorded logger CSV (time,...,tag,...,value),
+ *            at their recorded pace, tag i on point i, looping
+ *
+ *  One generator thread applies everything due per millisecond in batches
+ *  of IedServer_lockDataModel sections, and counts the updates and how
+ *  long the data model was held.
+ */
+
+#ifndef LOADGEN_H_
+#define LOADGEN_H_
+
+#include "iec61850_server.h"
+
+#define LOADGEN_POINTS_PER_LN 64
+
+/* Updates applied in one locked section at most */
+#define LOADGEN_BATCH 512
+
+/* "an:2000:10:walk": analog or status (st), points, period ms, pattern */
+bool
+LoadGen_addGroup(const char* spec);
+
+/* The recorded log used by replay groups */
+bool
+LoadGen_setReplayFile(const char* fileName);
+
+void
+LoadGen_setBatchSize(int updatesPerLock);
+
+/* Adds the LoadGen logical device; before IedServer_createWithConfig */
+void
+LoadGen_createModel(IedModel* model);
+
+void
+LoadGen_start(IedServer server);
+
+void
+LoadGen_stop(void);
+
+/* Achieved update rate and lock hold times since the last call */
+void
+LoadGen_printStatistics(void);
+
+#endif /* LOADGEN_H_ */
@@ -0,0 +1,92 @@
+/*
+ *  modelindex.c
+ *
+ *  Lookups in the generated object reference index, see modelindex.h
+ */
+
+#include "modelindex.h"
+#include "hal_time.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Lookup rounds of the benchmark: at least this long each */
+#define BENCHMARK_MS 500
+
+const ModelIndexEntry*
+ModelIndex_find(const char* reference)
+{
+    uint64_t hash = ModelIndex_hash(reference);
+    uint32_t seed = modelIndexSeeds[ModelIndex_slot(hash, 0, modelIndexBucketCount)];
+    const ModelIndexEntry* entry = &modelIndexEntries[ModelIndex_slot(hash, seed, modelIndexSlotCount)];
+
+    /* a reference the model does not have lands on some other entry */
+    if (entry->reference == NULL || strcmp(entry->reference, reference) != 0)
+        return NULL;
+
+    return entry;
+}
+
+ModelNode*
+ModelIndex_findNode(const char* reference)
+{
+    const ModelIndexEntry* entry = ModelIndex_find(reference);
+
+    return entry && entry->kind == MODEL_INDEX_NODE ? (ModelNode*) entry->target : NULL;
+}
+
+void
+ModelIndex_benchmark(IedModel* model)
+{
+    int count = 0;
+    int mismatches = 0;
+
+    /* the . form of the LN children, which the model's own lookup understands */
+    for (uint32_t i = 0; i < modelIndexSlotCount; i++) {
+        const ModelIndexEntry* e = &modelIndexEntries[i];
+
+        if (e->reference == NULL || e->kind != MODEL_INDEX_NODE || strchr(e->reference, '.') == NULL)
+            continue;
+
+        count++;
+
+        if (ModelIndex_findNode(e->reference) != e->target ||
+                IedModel_getModelNodeByShortObjectReference(model, e->reference) != e->target)
+            mismatches++;
+    }
+
+    if (count == 0) {
+        printf("Index: no references\n");
+        return;
+    }
+
+    printf("Index: %i node references, %u slots, %i mismatches\n", count, modelIndexSlotCount, mismatches);
+
+    for (int round = 0; round < 2; round++) {
+        uint64_t start = Hal_getTimeInMs();
+        long lookups = 0;
+        uintptr_t found = 0;
+
+        do {
+            for (uint32_t i = 0; i < modelIndexSlotCount; i++) {
+                const ModelIndexEntry* e = &modelIndexEntries[i];
+
+                if (e->reference == NULL || e->kind != MODEL_INDEX_NODE || strchr(e->reference, '.') == NULL)
+                    continue;
+
+                if (round == 0)
+                    found += (uintptr_t) ModelIndex_findNode(e->reference);
+                else
+                    found += (uintptr_t) IedModel_getModelNodeByShortObjectReference(model, e->reference);
+
+                lookups++;
+            }
+        } while (Hal_getTimeInMs() - start < BENCHMARK_MS);
+
+        uint64_t elapsed = Hal_getTimeInMs() - start;
+
+        printf("Index: %-45s %9.1f ns per lookup (%li lookups, %lx)\n",
+                round == 0 ? "ModelIndex_findNode" : "IedModel_getModelNodeByShortObjectReference",
+                elapsed * 1000000.0 / lookups, lookups, (unsigned long) (found & 0xfff));
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ *  modelindex.h
+ *
+ *  Object reference index of the generated static model.
+ *
+ *  genindex reads static_model.c and writes static_model_index.c: a perfect
+ *  hash table from every reference of the model to its node, computed once
+ *  when the model is generated. A lookup is one hash of the reference, two
+ *  table reads and one string compare, instead of walking the LD, LN, DO and
+ *  DA child lists (IedModel_getModelNodeByShortObjectReference) or the data
+ *  set and RCB lists.
+ *
+ *  Indexed, without the IED name:
+ *    GenericIO/GGIO1.SPCSO1.stVal      LD, LN, DO, DA
+ *    GenericIO/GGIO1$ST$SPCSO1$stVal   DO and DA per FC, as in MMS and data sets
+ *    GenericIO/LLN0$Events             data sets, also GenericIO/LLN0.Events
+ *    GenericIO/LLN0.BR.EventsBRCB01    RCBs, also GenericIO/LLN0$BR$EventsBRCB01
+ *
+ *  After every genmodel run:
+ *    genindex static_model.c static_model_index.c
+ *  or, for the compact layout of the model tables (see genindex.c):
+ *    genindex --compact static_model.c static_model_index.c
+ */
+
+#ifndef MODELINDEX_H_
+#define MODELINDEX_H_
+
+#include <stdint.h>
+
+#include "iec61850_model.h"
+
+typedef enum {
+    MODEL_INDEX_NODE,
+    MODEL_INDEX_DATA_SET,
+    MODEL_INDEX_RCB
+} ModelIndexKind;
+
+typedef struct {
+    const char* reference;      /* NULL: free slot */
+    ModelIndexKind kind;
+    FunctionalConstraint fc;    /* of the $ form, IEC61850_FC_NONE for the . form */
+    void* target;               /* ModelNode*, DataSet* or ReportControlBlock* */
+} ModelIndexEntry;
+
+/* static_model_index.c */
+extern const uint32_t modelIndexBucketCount;
+extern const uint32_t modelIndexSlotCount;
+extern const uint32_t modelIndexSeeds[];
+extern const ModelIndexEntry modelIndexEntries[];
+
+/* FNV-1a, 64 bit: genindex refuses a model where two references collide */
+static inline uint64_t
+ModelIndex_hash(const char* reference)
+{
+    uint64_t h = 14695981039346656037ull;
+
+    while (*reference)
+        h = (h ^ (uint8_t) *reference++) * 1099511628211ull;
+
+    return h;
+}
+
+/* The hash mixed with a seed, into 0..count-1: seed 0 picks the bucket, the bucket's seed the slot */
+static inline uint32_t
+ModelIndex_slot(uint64_t hash, uint32_t seed, uint32_t count)
+{
+    uint64_t x = hash ^ (seed * 0x9e3779b97f4a7c15ull);
+
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+
+    return (uint32_t) (x % count);
+}
+
+/* The entry of a reference, NULL if the static model has none */
+const ModelIndexEntry*
+ModelIndex_find(const char* reference);
+
+ModelNode*
+ModelIndex_findNode(const char* reference);
+
+/* Every indexed node reference looked up through the index and through the model's lists */
+void
+ModelIndex_benchmark(IedModel* model);
+
+#endif /* MODELINDEX_H_ */
@@ -0,0 +1,1537 @@
+/*
+ *  sclmodel.c
+ *
+ *  Data model from an SCL file with a mapped binary image cache, see sclmodel.h
+ */
+
+#include "sclmodel.h"
+#include "iec61850_dynamic_model.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define IMAGE_VERSION 2
+
+/* Nesting of XML elements and of model nodes */
+#define MAX_DEPTH 64
+
+#define MAX_ATTRIBUTES 64
+#define ARENA_CHUNK (256 * 1024)
+
+/* ===================== XML ===================== */
+
+typedef struct sXmlNode XmlNode;
+
+struct sXmlNode {
+    const char* tag;            /* without namespace prefix */
+    const char** attributes;    /* name, value, name, value ... */
+    int attributeCount;
+    const char* text;           /* first text of the element */
+    XmlNode* firstChild;
+    XmlNode* lastChild;
+    XmlNode* next;
+};
+
+typedef struct sArenaChunk ArenaChunk;
+
+struct sArenaChunk {
+    ArenaChunk* next;
+    size_t used;
+    size_t size;
+    char data[];
+};
+
+typedef struct {
+    const char* tag;            /* LNodeType, DOType, DAType, EnumType */
+    const char* id;
+    const XmlNode* node;
+} TypeEntry;
+
+typedef struct {
+    char* buffer;               /* the file, parsed in place */
+    ArenaChunk* chunks;         /* the elements */
+    XmlNode document;
+
+    TypeEntry* types;           /* open addressing by id */
+    uint32_t typeSlots;
+} Scl;
+
+static void*
+arenaAlloc(Scl* scl, size_t size)
+{
+    ArenaChunk* c = scl->chunks;
+
+    size = (size + 7) & ~(size_t) 7;
+
+    if (c == NULL || c->used + size > c->size) {
+        size_t chunkSize = size > ARENA_CHUNK ? size : ARENA_CHUNK;
+
+        c = (ArenaChunk*) malloc(sizeof(ArenaChunk) + chunkSize);
+        c->next = scl->chunks;
+        c->used = 0;
+        c->size = chunkSize;
+        scl->chunks = c;
+    }
+
+    void* p = c->data + c->used;
+    c->used += size;
+
+    return p;
+}
+
+static int
+encodeUtf8(char* out, unsigned long code)
+{
+    if (code < 0x80) {
+        out[0] = (char) code;
+        return 1;
+    }
+
+    if (code < 0x800) {
+        out[0] = (char) (0xc0 | (code >> 6));
+        out[1] = (char) (0x80 | (code & 0x3f));
+        return 2;
+    }
+
+    if (code < 0x10000) {
+        out[0] = (char) (0xe0 | (code >> 12));
+        out[1] = (char) (0x80 | ((code >> 6) & 0x3f));
+        out[2] = (char) (0x80 | (code & 0x3f));
+        return 3;
+    }
+
+    out[0] = (char) (0xf0 | ((code >> 18) & 0x07));
+    out[1] = (char) (0x80 | ((code >> 12) & 0x3f));
+    out[2] = (char) (0x80 | ((code >> 6) & 0x3f));
+    out[3] = (char) (0x80 | (code & 0x3f));
+    return 4;
+}
+
+/* Entity and character references replaced in place; the result is never longer */
+static void
+decodeText(char* s)
+{
+    char* out = s;
+
+    while (*s) {
+        if (*s == '&') {
+            char* semi = strchr(s, ';');
+            unsigned long code = 0;
+
+            if (semi != NULL && semi - s <= 10) {
+                if (s[1] == '#')
+                    code = s[2] == 'x' ? strtoul(s + 3, NULL, 16) : strtoul(s + 2, NULL, 10);
+                else if (strncmp(s, "&lt;", 4) == 0)
+                    code = '<';
+                else if (strncmp(s, "&gt;", 4) == 0)
+                    code = '>';
+                else if (strncmp(s, "&amp;", 5) == 0)
+                    code = '&';
+                else if (strncmp(s, "&quot;", 6) == 0)
+                    code = '"';
+                else if (strncmp(s, "&apos;", 6) == 0)
+                    code = '\'';
+            }
+
+            if (code > 0 && code <= 0x10ffff) {
+                out += encodeUtf8(out, code);
+                s = semi + 1;
+                continue;
+            }
+        }
+
+        *out++ = *s++;
+    }
+
+    *out = 0;
+}
+
+static bool
+isBlank(const char* s, const char* end)
+{
+    for (; s < end; s++)
+        if (!isspace((unsigned char) *s))
+            return false;
+
+    return true;
+}
+
+static void
+appendChild(XmlNode* parent, XmlNode* child)
+{
+    if (parent->lastChild)
+        parent->lastChild->next = child;
+    else
+        parent->firstChild = child;
+
+    parent->lastChild = child;
+}
+
+/* The start tag after its '<': the element created below parent, the position after the tag, NULL on errors */
+static char*
+parseStartTag(Scl* scl, char* q, XmlNode* parent, XmlNode** created, bool* empty)
+{
+    const char* pairs[2 * MAX_ATTRIBUTES];
+    char* ends[2 * MAX_ATTRIBUTES + 1];
+    int count = 0;
+    int endCount = 0;
+
+    char* name = q;
+
+    while (*q && !isspace((unsigned char) *q) && *q != '/' && *q != '>')
+        q++;
+
+    ends[endCount++] = q;
+
+    for (;;) {
+        while (isspace((unsigned char) *q))
+            q++;
+
+        if (*q == '>') {
+            q++;
+            *empty = false;
+            break;
+        }
+
+        if (q[0] == '/' && q[1] == '>') {
+            q += 2;
+            *empty = true;
+            break;
+        }
+
+        if (*q == 0 || count == 2 * MAX_ATTRIBUTES)
+            return NULL;
+
+        char* attributeName = q;
+
+        while (*q && *q != '=' && !isspace((unsigned char) *q) && *q != '>')
+            q++;
+
+        char* nameEnd = q;
+
+        while (isspace((unsigned char) *q))
+            q++;
+
+        if (*q++ != '=')
+            return NULL;
+
+        while (isspace((unsigned char) *q))
+            q++;
+
+        char quote = *q;
+
+        if (quote != '"' && quote != '\'')
+            return NULL;
+
+        char* value = ++q;
+
+        q = strchr(q, quote);
+
+        if (q == NULL)
+            return NULL;
+
+        ends[endCount++] = nameEnd;
+        ends[endCount++] = q++;
+        pairs[count++] = attributeName;
+        pairs[count++] = value;
+    }
+
+    /* terminated only now: the terminators were delimiters above */
+    for (int i = 0; i < endCount; i++)
+        *ends[i] = 0;
+
+    XmlNode* node = (XmlNode*) arenaAlloc(scl, sizeof(XmlNode));
+    const char* localName = strchr(name, ':');
+
+    memset(node, 0, sizeof(XmlNode));
+    node->tag = localName ? localName + 1 : name;
+    node->attributeCount = count / 2;
+    node->attributes = (const char**) arenaAlloc(scl, count * sizeof(char*));
+
+    for (int i = 0; i < count; i++) {
+        if (i & 1)
+            decodeText((char*) pairs[i]);
+
+        node->attributes[i] = pairs[i];
+    }
+
+    appendChild(parent, node);
+    *created = node;
+
+    return q;
+}
+
+/* Elements, attributes and the first text of every element; comments, PIs and DOCTYPE skipped */
+static bool
+parseXml(Scl* scl)
+{
+    XmlNode* stack[MAX_DEPTH];
+    int depth = 0;
+
+    stack[depth++] = &scl->document;
+
+    char* p = strchr(scl->buffer, '<');
+
+    while (p != NULL) {
+        /* *p may already be the terminator of the text before */
+        char* q = p + 1;
+        char* text = NULL;
+
+        if (*q == '?') {
+            q = strstr(q, "?>");
+            q = q ? q + 2 : NULL;
+        }
+        else if (strncmp(q, "!--", 3) == 0) {
+            q = strstr(q, "-->");
+            q = q ? q + 3 : NULL;
+        }
+        else if (strncmp(q, "![CDATA[", 8) == 0) {
+            text = q + 8;
+            q = strstr(text, "]]>");
+
+            if (q) {
+                *q = 0;
+                q += 3;
+
+                if (depth > 1 && stack[depth - 1]->text == NULL)
+                    stack[depth - 1]->text = text;
+            }
+        }
+        else if (*q == '!') {
+            q = strchr(q, '>');
+            q = q ? q + 1 : NULL;
+        }
+        else if (*q == '/') {
+            q = strchr(q, '>');
+
+            if (depth == 1)
+                q = NULL;
+            else if (q) {
+                q++;
+                depth--;
+            }
+        }
+        else {
+            XmlNode* node;
+            bool empty;
+
+            q = parseStartTag(scl, q, stack[depth - 1], &node, &empty);
+
+            if (q && !empty) {
+                if (depth == MAX_DEPTH)
+                    q = NULL;
+                else
+                    stack[depth++] = node;
+            }
+        }
+
+        if (q == NULL) {
+            printf("SCL: XML syntax error at offset %li\n", (long) (p - scl->buffer));
+            return false;
+        }
+
+        p = strchr(q, '<');
+
+        if (p && depth > 1 && !isBlank(q, p)) {
+            *p = 0;
+            decodeText(q);
+
+            if (stack[depth - 1]->text == NULL)
+                stack[depth - 1]->text = q;
+        }
+    }
+
+    if (depth != 1) {
+        printf("SCL: XML ends inside an element\n");
+        return false;
+    }
+
+    return true;
+}
+
+static const char*
+attribute(const XmlNode* node, const char* name)
+{
+    for (int i = 0; i < node->attributeCount; i++)
+        if (strcmp(node->attributes[2 * i], name) == 0)
+            return node->attributes[2 * i + 1];
+
+    return NULL;
+}
+
+static const char*
+attributeOr(const XmlNode* node, const char* name, const char* defaultValue)
+{
+    const char* value = attribute(node, name);
+
+    return value ? value : defaultValue;
+}
+
+static bool
+attributeIsTrue(const XmlNode* node, const char* name, bool defaultValue)
+{
+    const char* value = attribute(node, name);
+
+    return value ? strcmp(value, "true") == 0 : defaultValue;
+}
+
+static int
+attributeInt(const XmlNode* node, const char* name, int defaultValue)
+{
+    const char* value = attribute(node, name);
+
+    return value ? atoi(value) : defaultValue;
+}
+
+static bool
+isTag(const XmlNode* node, const char* tag)
+{
+    return strcmp(node->tag, tag) == 0;
+}
+
+static const XmlNode*
+child(const XmlNode* node, const char* tag)
+{
+    for (const XmlNode* c = node->firstChild; c; c = c->next)
+        if (isTag(c, tag))
+            return c;
+
+    return NULL;
+}
+
+/* ===================== Data Type Templates ===================== */
+
+static uint32_t
+hashText(const char* s)
+{
+    uint32_t h = 2166136261u;
+
+    while (*s)
+        h = (h ^ (uint8_t) *s++) * 16777619u;
+
+    return h;
+}
+
+/* 64 bit FNV-1a of the whole SCL file, part of the image key */
+static uint64_t
+hashFile(const char* s)
+{
+    uint64_t h = 14695981039346656037ull;
+
+    while (*s)
+        h = (h ^ (uint8_t) *s++) * 1099511628211ull;
+
+    return h;
+}
+
+static void
+indexTypes(Scl* scl, const XmlNode* templates)
+{
+    uint32_t count = 0;
+
+    for (const XmlNode* t = templates->firstChild; t; t = t->next)
+        count++;
+
+    scl->typeSlots = 64;
+
+    while (scl->typeSlots < 2 * count)
+        scl->typeSlots *= 2;
+
+    scl->types = (TypeEntry*) calloc(scl->typeSlots, sizeof(TypeEntry));
+
+    for (const XmlNode* t = templates->firstChild; t; t = t->next) {
+        const char* id = attribute(t, "id");
+
+        if (id == NULL)
+            continue;
+
+        uint32_t k = hashText(id) & (scl->typeSlots - 1);
+
+        while (scl->types[k].id)
+            k = (k + 1) & (scl->typeSlots - 1);
+
+        scl->types[k].tag = t->tag;
+        scl->types[k].id = id;
+        scl->types[k].node = t;
+    }
+}
+
+static const XmlNode*
+findType(const Scl* scl, const char* tag, const char* id)
+{
+    if (id == NULL || scl->types == NULL)
+        return NULL;
+
+    uint32_t k = hashText(id) & (scl->typeSlots - 1);
+
+    for (; scl->types[k].id; k = (k + 1) & (scl->typeSlots - 1))
+        if (strcmp(scl->types[k].id, id) == 0 && strcmp(scl->types[k].tag, tag) == 0)
+            return scl->types[k].node;
+
+    return NULL;
+}
+
+static const struct {
+    const char* name;
+    DataAttributeType type;
+} basicTypes[] = {
+    { "BOOLEAN", IEC61850_BOOLEAN },
+    { "INT8", IEC61850_INT8 },
+    { "INT16", IEC61850_INT16 },
+    { "INT32", IEC61850_INT32 },
+    { "INT64", IEC61850_INT64 },
+    { "INT128", IEC61850_INT128 },
+    { "INT8U", IEC61850_INT8U },
+    { "INT16U", IEC61850_INT16U },
+    { "INT24U", IEC61850_INT24U },
+    { "INT32U", IEC61850_INT32U },
+    { "FLOAT32", IEC61850_FLOAT32 },
+    { "FLOAT64", IEC61850_FLOAT64 },
+    { "Enum", IEC61850_ENUMERATED },
+    { "Dbpos", IEC61850_CODEDENUM },
+    { "Tcmd", IEC61850_CODEDENUM },
+    { "Quality", IEC61850_QUALITY },
+    { "Timestamp", IEC61850_TIMESTAMP },
+    { "EntryTime", IEC61850_ENTRY_TIME },
+    { "Check", IEC61850_CHECK },
+    { "VisString32", IEC61850_VISIBLE_STRING_32 },
+    { "VisString64", IEC61850_VISIBLE_STRING_64 },
+    { "VisString65", IEC61850_VISIBLE_STRING_65 },
+    { "VisString129", IEC61850_VISIBLE_STRING_129 },
+    { "VisString255", IEC61850_VISIBLE_STRING_255 },
+    { "ObjRef", IEC61850_VISIBLE_STRING_129 },
+    { "Unicode255", IEC61850_UNICODE_STRING_255 },
+    { "Octet64", IEC61850_OCTET_STRING_64 },
+    { "EntryID", IEC61850_OCTET_STRING_8 },
+    { "Currency", IEC61850_CURRENCY },
+    { "PhyComAddr", IEC61850_PHYCOMADDR },
+    { "TrgOps", IEC61850_TRGOPS },
+    { "OptFlds", IEC61850_OPTFLDS }
+};
+
+static DataAttributeType
+basicType(const char* bType)
+{
+    for (size_t i = 0; i < sizeof(basicTypes) / sizeof(basicTypes[0]); i++)
+        if (strcmp(basicTypes[i].name, bType) == 0)
+            return basicTypes[i].type;
+
+    return IEC61850_UNKNOWN_TYPE;
+}
+
+/* The Val of a DAI or a template DA/BDA */
+static const char*
+valueOf(const XmlNode* node)
+{
+    const XmlNode* val = node ? child(node, "Val") : NULL;
+
+    if (val == NULL)
+        return NULL;
+
+    return val->text ? val->text : "";
+}
+
+/* The ord of an enumeration value given by name, into buffer; NULL if unknown */
+static const char*
+enumOrd(const Scl* scl, const char* enumType, const char* value, char* buffer, size_t size)
+{
+    const XmlNode* type = findType(scl, "EnumType", enumType);
+
+    if (type) {
+        for (const XmlNode* e = type->firstChild; e; e = e->next) {
+            if (isTag(e, "EnumVal") && e->text && strcmp(e->text, value) == 0) {
+                snprintf(buffer, size, "%s", attributeOr(e, "ord", "0"));
+                return buffer;
+            }
+        }
+    }
+
+    if (isdigit((unsigned char) value[0]) || value[0] == '-')
+        return value;
+
+    printf("SCL: enumeration value %s not in %s, left out\n", value, enumType ? enumType : "?");
+
+    return NULL;
+}
+
+/* The DOI, SDI or DAI named name below instance */
+static const XmlNode*
+findInstance(const XmlNode* instance, const char* name)
+{
+    if (instance == NULL || name == NULL)
+        return NULL;
+
+    for (const XmlNode* c = instance->firstChild; c; c = c->next) {
+        if (isTag(c, "DOI") || isTag(c, "SDI") || isTag(c, "DAI")) {
+            const char* n = attribute(c, "name");
+
+            if (n && strcmp(n, name) == 0)
+                return c;
+        }
+    }
+
+    return NULL;
+}
+
+/* ===================== Image ===================== */
+
+enum {
+    NODE_LD = 1,
+    NODE_LN,
+    NODE_DO,
+    NODE_DA,
+    NODE_DATASET,
+    NODE_FCDA,
+    NODE_RCB
+};
+
+typedef struct {
+    char magic[4];              /* "SCLM" */
+    uint32_t version;
+    uint64_t sourceSize;        /* of the SCL file the image was built from */
+    int64_t sourceTime;
+    uint64_t sourceHash;        /* FNV-1a of its content: an edit that keeps size and time */
+    uint32_t nodeCount;
+    uint32_t reportCount;
+    uint32_t stringBytes;
+    char iedName[64];           /* of the IED the model is of */
+    char requested[64];         /* the IED name asked for, "" for the first IED */
+} ImageHeader;
+
+/*
+ * One model node, followed by its subtree in preorder. Fields by kind:
+ *   LD, LN, DATASET  name
+ *   DO               name, elements
+ *   DA               name, fc, type, trgOps, elements, text: initial value
+ *   FCDA             text: member "LD/LN$FC$DO$DA", elements: index or -1
+ *   RCB              name, elements: index into the report table
+ * Strings are offsets into the string table, 0 for none.
+ */
+typedef struct {
+    uint8_t kind;
+    uint8_t fc;
+    uint8_t type;
+    uint8_t trgOps;
+    uint32_t name;
+    uint32_t text;
+    uint32_t children;          /* nodes on the first level below */
+    int32_t elements;
+} ImageNode;
+
+/* The few RCBs keep their parameters out of the node records */
+typedef struct {
+    uint32_t rptId;
+    uint32_t dataSet;
+    uint32_t intgPd;
+    uint32_t bufTime;
+    uint32_t confRev;
+    uint8_t buffered;
+    uint8_t options;
+    uint8_t trgOps;
+    uint8_t reserved;
+} ImageReport;
+
+typedef struct {
+    ImageNode* nodes;
+    uint32_t nodeCount;
+    uint32_t nodeCapacity;
+
+    ImageReport* reports;
+    uint32_t reportCount;
+    uint32_t reportCapacity;
+
+    char* strings;
+    uint32_t stringBytes;
+    uint32_t stringCapacity;
+
+    uint32_t* slots;            /* string offsets by hash: names repeat a lot */
+    uint32_t slotCount;
+    uint32_t stringCount;
+
+    uint32_t open[MAX_DEPTH];
+    int depth;
+} ImageBuilder;
+
+/* An image in memory or mapped from its file */
+typedef struct {
+    const ImageHeader* header;
+    const ImageNode* nodes;
+    const ImageReport* reports;
+    const char* strings;
+    IedModel* model;
+} ImageView;
+
+static uint32_t
+addString(ImageBuilder* b, const char* s)
+{
+    if (s == NULL || *s == 0)
+        return 0;
+
+    if (2 * (b->stringCount + 1) > b->slotCount) {
+        uint32_t oldCount = b->slotCount;
+        uint32_t* old = b->slots;
+
+        b->slotCount = oldCount ? oldCount * 2 : 1024;
+        b->slots = (uint32_t*) calloc(b->slotCount, sizeof(uint32_t));
+
+        for (uint32_t i = 0; i < oldCount; i++) {
+            if (old[i]) {
+                uint32_t k = hashText(b->strings + old[i]) & (b->slotCount - 1);
+
+                while (b->slots[k])
+                    k = (k + 1) & (b->slotCount - 1);
+
+                b->slots[k] = old[i];
+            }
+        }
+
+        free(old);
+    }
+
+    uint32_t k = hashText(s) & (b->slotCount - 1);
+
+    for (; b->slots[k]; k = (k + 1) & (b->slotCount - 1))
+        if (strcmp(b->strings + b->slots[k], s) == 0)
+            return b->slots[k];
+
+    uint32_t length = (uint32_t) strlen(s) + 1;
+
+    if (b->stringBytes + length > b->stringCapacity) {
+        while (b->stringBytes + length > b->stringCapacity)
+            b->stringCapacity *= 2;
+
+        b->strings = (char*) realloc(b->strings, b->stringCapacity);
+    }
+
+    uint32_t offset = b->stringBytes;
+
+    memcpy(b->strings + offset, s, length);
+    b->stringBytes += length;
+    b->stringCount++;
+    b->slots[k] = offset;
+
+    return offset;
+}
+
+/* A node below the open one; the pointer is valid until the next node is added */
+static ImageNode*
+addNode(ImageBuilder* b, int kind, const char* name)
+{
+    if (b->nodeCount == b->nodeCapacity) {
+        b->nodeCapacity = b->nodeCapacity ? b->nodeCapacity * 2 : 4096;
+        b->nodes = (ImageNode*) realloc(b->nodes, b->nodeCapacity * sizeof(ImageNode));
+    }
+
+    if (b->depth > 0)
+        b->nodes[b->open[b->depth - 1]].children++;
+
+    ImageNode* n = &b->nodes[b->nodeCount++];
+
+    memset(n, 0, sizeof(ImageNode));
+    n->kind = (uint8_t) kind;
+    n->name = addString(b, name);
+
+    return n;
+}
+
+static ImageNode*
+openNode(ImageBuilder* b, int kind, const char* name)
+{
+    ImageNode* n = addNode(b, kind, name);
+
+    b->open[b->depth++] = b->nodeCount - 1;
+
+    return n;
+}
+
+static void
+closeNode(ImageBuilder* b)
+{
+    b->depth--;
+}
+
+static bool
+buildDataAttribute(Scl* scl, ImageBuilder* b, const XmlNode* da, FunctionalConstraint fc, uint8_t trgOps,
+        const XmlNode* instance, int depth)
+{
+    const char* name = attribute(da, "name");
+    const char* bType = attribute(da, "bType");
+    int count = attributeInt(da, "count", 0);
+
+    if (name == NULL || bType == NULL) {
+        printf("SCL: %s without name or bType\n", da->tag);
+        return false;
+    }
+
+    if (strcmp(bType, "Struct") == 0) {
+        const XmlNode* daType = findType(scl, "DAType", attribute(da, "type"));
+
+        if (daType == NULL || depth >= MAX_DEPTH - 8) {
+            printf("SCL: DAType %s of %s not found\n", attributeOr(da, "type", "?"), name);
+            return false;
+        }
+
+        ImageNode* n = openNode(b, NODE_DA, name);
+
+        n->fc = (uint8_t) fc;
+        n->type = (uint8_t) IEC61850_CONSTRUCTED;
+        n->trgOps = trgOps;
+        n->elements = count;
+
+        /* sub attributes have the FC and trigger options of the attribute */
+        for (const XmlNode* bda = daType->firstChild; bda; bda = bda->next) {
+            if (isTag(bda, "BDA") &&
+                    !buildDataAttribute(scl, b, bda, fc, trgOps, findInstance(instance, attribute(bda, "name")), depth + 1))
+                return false;
+        }
+
+        closeNode(b);
+        return true;
+    }
+
+    DataAttributeType type = basicType(bType);
+
+    if (type == IEC61850_UNKNOWN_TYPE) {
+        printf("SCL: %s of type %s not supported, left out\n", name, bType);
+        return true;
+    }
+
+    const char* value = valueOf(instance);
+    char ord[16];
+
+    if (value == NULL)
+        value = valueOf(da);
+
+    if (value && *value && type == IEC61850_ENUMERATED)
+        value = enumOrd(scl, attribute(da, "type"), value, ord, sizeof(ord));
+
+    ImageNode* n = addNode(b, NODE_DA, name);
+
+    n->fc = (uint8_t) fc;
+    n->type = (uint8_t) type;
+    n->trgOps = trgOps;
+    n->elements = count;
+    n->text = addString(b, value);
+
+    return true;
+}
+
+static bool
+buildDataObject(Scl* scl, ImageBuilder* b, const char* name, const char* typeId, int count,
+        const XmlNode* instance, int depth)
+{
+    const XmlNode* doType = findType(scl, "DOType", typeId);
+
+    if (doType == NULL || name == NULL || depth >= MAX_DEPTH - 8) {
+        printf("SCL: DOType %s of %s not found\n", typeId ? typeId : "?", name ? name : "?");
+        return false;
+    }
+
+    ImageNode* n = openNode(b, NODE_DO, name);
+
+    n->elements = count;
+
+    for (const XmlNode* c = doType->firstChild; c; c = c->next) {
+        const char* childName = attribute(c, "name");
+
+        if (isTag(c, "DA")) {
+            const char* fc = attribute(c, "fc");
+            uint8_t trgOps = 0;
+
+            if (fc == NULL) {
+                printf("SCL: %s.%s without fc\n", name, childName ? childName : "?");
+                return false;
+            }
+
+            if (attributeIsTrue(c, "dchg", false))
+                trgOps |= TRG_OPT_DATA_CHANGED;
+
+            if (attributeIsTrue(c, "qchg", false))
+                trgOps |= TRG_OPT_QUALITY_CHANGED;
+
+            if (attributeIsTrue(c, "dupd", false))
+                trgOps |= TRG_OPT_DATA_UPDATE;
+
+            if (!buildDataAttribute(scl, b, c, FunctionalConstraint_fromString(fc), trgOps,
+                    findInstance(instance, childName), depth + 1))
+                return false;
+        }
+        else if (isTag(c, "SDO")) {
+            if (!buildDataObject(scl, b, childName, attribute(c, "type"), attributeInt(c, "count", 0),
+                    findInstance(instance, childName), depth + 1))
+                return false;
+        }
+    }
+
+    closeNode(b);
+
+    return true;
+}
+
+static void
+buildDataSet(ImageBuilder* b, const XmlNode* dataSet, const char* ldInst)
+{
+    openNode(b, NODE_DATASET, attribute(dataSet, "name"));
+
+    for (const XmlNode* fcda = dataSet->firstChild; fcda; fcda = fcda->next) {
+        if (!isTag(fcda, "FCDA"))
+            continue;
+
+        char member[256];
+        const char* daName = attribute(fcda, "daName");
+
+        int length = snprintf(member, sizeof(member), "%s/%s%s%s$%s$%s%s%s",
+                attributeOr(fcda, "ldInst", ldInst), attributeOr(fcda, "prefix", ""),
+                attributeOr(fcda, "lnClass", ""), attributeOr(fcda, "lnInst", ""),
+                attributeOr(fcda, "fc", ""), attributeOr(fcda, "doName", ""),
+                daName ? "$" : "", daName ? daName : "");
+
+        if (length >= (int) sizeof(member)) {
+            printf("SCL: data set member %s too long, left out\n", member);
+            continue;
+        }
+
+        /* "AnIn1.mag" -> "AnIn1$mag", after the LD name */
+        for (char* c = strchr(member, '/'); *c; c++)
+            if (*c == '.')
+                *c = '$';
+
+        ImageNode* n = addNode(b, NODE_FCDA, NULL);
+
+        n->elements = attributeInt(fcda, "ix", -1);
+        n->text = addString(b, member);
+    }
+
+    closeNode(b);
+}
+
+static void
+buildReportControl(ImageBuilder* b, const XmlNode* rc)
+{
+    const XmlNode* trgOps = child(rc, "TrgOps");
+    const XmlNode* optFields = child(rc, "OptFields");
+    const XmlNode* rptEnabled = child(rc, "RptEnabled");
+    const char* name = attribute(rc, "name");
+
+    uint8_t triggers = TRG_OPT_GI;
+    uint8_t options = 0;
+
+    if (trgOps) {
+        triggers = 0;
+
+        if (attributeIsTrue(trgOps, "dchg", false)) triggers |= TRG_OPT_DATA_CHANGED;
+        if (attributeIsTrue(trgOps, "qchg", false)) triggers |= TRG_OPT_QUALITY_CHANGED;
+        if (attributeIsTrue(trgOps, "dupd", false)) triggers |= TRG_OPT_DATA_UPDATE;
+        if (attributeIsTrue(trgOps, "period", false)) triggers |= TRG_OPT_INTEGRITY;
+        if (attributeIsTrue(trgOps, "gi", true)) triggers |= TRG_OPT_GI;
+    }
+
+    if (optFields) {
+        if (attributeIsTrue(optFields, "seqNum", false)) options |= RPT_OPT_SEQ_NUM;
+        if (attributeIsTrue(optFields, "timeStamp", false)) options |= RPT_OPT_TIME_STAMP;
+        if (attributeIsTrue(optFields, "reasonCode", false)) options |= RPT_OPT_REASON_FOR_INCLUSION;
+        if (attributeIsTrue(optFields, "dataSet", false)) options |= RPT_OPT_DATA_SET;
+        if (attributeIsTrue(optFields, "dataRef", false)) options |= RPT_OPT_DATA_REFERENCE;
+        if (attributeIsTrue(optFields, "bufOvfl", true)) options |= RPT_OPT_BUFFER_OVERFLOW;
+        if (attributeIsTrue(optFields, "entryID", false)) options |= RPT_OPT_ENTRY_ID;
+        if (attributeIsTrue(optFields, "configRef", false)) options |= RPT_OPT_CONF_REV;
+    }
+
+    int max = rptEnabled ? attributeInt(rptEnabled, "max", 1) : 1;
+    bool indexed = attributeIsTrue(rc, "indexed", true);
+
+    if (name == NULL)
+        return;
+
+    /* indexed: one RCB per client, EventsIndexed01..03, and EventsRCB01 for max 1, as genmodel */
+    for (int i = 1; i <= (indexed ? max : 1); i++) {
+        char rcbName[80];
+
+        if (indexed)
+            snprintf(rcbName, sizeof(rcbName), "%s%02i", name, i);
+        else
+            snprintf(rcbName, sizeof(rcbName), "%s", name);
+
+        if (b->reportCount == b->reportCapacity) {
+            b->reportCapacity = b->reportCapacity ? b->reportCapacity * 2 : 64;
+            b->reports = (ImageReport*) realloc(b->reports, b->reportCapacity * sizeof(ImageReport));
+        }
+
+        ImageReport* report = &b->reports[b->reportCount];
+
+        memset(report, 0, sizeof(ImageReport));
+        report->rptId = addString(b, attribute(rc, "rptID"));
+        report->dataSet = addString(b, attribute(rc, "datSet"));
+        report->intgPd = (uint32_t) attributeInt(rc, "intgPd", 0);
+        report->bufTime = (uint32_t) attributeInt(rc, "bufTime", 0);
+        report->confRev = (uint32_t) attributeInt(rc, "confRev", 1);
+        report->buffered = attributeIsTrue(rc, "buffered", false);
+        report->options = options;
+        report->trgOps = triggers;
+
+        addNode(b, NODE_RCB, rcbName)->elements = (int32_t) b->reportCount++;
+    }
+}
+
+static bool
+buildLogicalNode(Scl* scl, ImageBuilder* b, const XmlNode* ln, const char* ldInst)
+{
+    char name[80];
+
+    snprintf(name, sizeof(name), "%s%s%s", attributeOr(ln, "prefix", ""), attributeOr(ln, "lnClass", ""),
+            attributeOr(ln, "inst", ""));
+
+    const XmlNode* type = findType(scl, "LNodeType", attribute(ln, "lnType"));
+
+    if (type == NULL) {
+        printf("SCL: LNodeType %s of %s/%s not found\n", attributeOr(ln, "lnType", "?"), ldInst, name);
+        return false;
+    }
+
+    openNode(b, NODE_LN, name);
+
+    for (const XmlNode* d = type->firstChild; d; d = d->next) {
+        if (isTag(d, "DO")) {
+            const char* doName = attribute(d, "name");
+
+            if (!buildDataObject(scl, b, doName, attribute(d, "type"), attributeInt(d, "count", 0),
+                    findInstance(ln, doName), 0))
+                return false;
+        }
+    }
+
+    /* data sets before the RCBs that use them */
+    for (const XmlNode* c = ln->firstChild; c; c = c->next)
+        if (isTag(c, "DataSet"))
+            buildDataSet(b, c, ldInst);
+
+    for (const XmlNode* c = ln->firstChild; c; c = c->next)
+        if (isTag(c, "ReportControl"))
+            buildReportControl(b, c);
+
+    closeNode(b);
+
+    return true;
+}
+
+/* The instance tree of the IED named iedName, or of the first IED */
+static bool
+buildImage(Scl* scl, const char* iedName, ImageBuilder* b, ImageHeader* header)
+{
+    const XmlNode* root = child(&scl->document, "SCL");
+    const XmlNode* ied = NULL;
+    const XmlNode* server = NULL;
+
+    if (root == NULL) {
+        printf("SCL: no SCL element\n");
+        return false;
+    }
+
+    for (const XmlNode* c = root->firstChild; c && ied == NULL; c = c->next)
+        if (isTag(c, "IED") && (iedName == NULL || strcmp(attributeOr(c, "name", ""), iedName) == 0))
+            ied = c;
+
+    if (ied == NULL) {
+        printf("SCL: IED %s not found\n", iedName ? iedName : "");
+        return false;
+    }
+
+    /* the first access point with a server, as genmodel */
+    for (const XmlNode* ap = ied->firstChild; ap && server == NULL; ap = ap->next)
+        if (isTag(ap, "AccessPoint"))
+            server = child(ap, "Server");
+
+    if (server == NULL) {
+        printf("SCL: IED %s has no server\n", attributeOr(ied, "name", ""));
+        return false;
+    }
+
+    const XmlNode* templates = child(root, "DataTypeTemplates");
+
+    if (templates)
+        indexTypes(scl, templates);
+
+    snprintf(header->iedName, sizeof(header->iedName), "%s", attributeOr(ied, "name", ""));
+
+    b->stringCapacity = 64 * 1024;
+    b->strings = (char*) malloc(b->stringCapacity);
+    b->strings[0] = 0;
+    b->stringBytes = 1;
+
+    for (const XmlNode* ld = server->firstChild; ld; ld = ld->next) {
+        if (!isTag(ld, "LDevice"))
+            continue;
+
+        const char* ldInst = attributeOr(ld, "inst", "");
+
+        openNode(b, NODE_LD, ldInst);
+
+        for (const XmlNode* ln = ld->firstChild; ln; ln = ln->next)
+            if ((isTag(ln, "LN0") || isTag(ln, "LN")) && !buildLogicalNode(scl, b, ln, ldInst))
+                return false;
+
+        closeNode(b);
+    }
+
+    header->nodeCount = b->nodeCount;
+    header->reportCount = b->reportCount;
+    header->stringBytes = b->stringBytes;
+
+    return true;
+}
+
+static void
+saveImage(const char* imageName, const ImageHeader* header, const ImageBuilder* b)
+{
+    char tmpName[520];
+
+    snprintf(tmpName, sizeof(tmpName), "%s.tmp", imageName);
+
+    FILE* f = fopen(tmpName, "wb");
+
+    if (f == NULL) {
+        printf("SCL: cannot write %s, the model is parsed again next time\n", tmpName);
+        return;
+    }
+
+    bool ok = fwrite(header, sizeof(ImageHeader), 1, f) == 1 &&
+            fwrite(b->nodes, sizeof(ImageNode), b->nodeCount, f) == b->nodeCount &&
+            fwrite(b->reports, sizeof(ImageReport), b->reportCount, f) == b->reportCount &&
+            fwrite(b->strings, 1, b->stringBytes, f) == b->stringBytes;
+
+    if (fclose(f) != 0)
+        ok = false;
+
+#ifdef _WIN32
+    if (ok)
+        ok = MoveFileExA(tmpName, imageName, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    if (ok)
+        ok = rename(tmpName, imageName) == 0;
+#endif
+
+    if (!ok) {
+        printf("SCL: cannot write %s, the model is parsed again next time\n", imageName);
+        remove(tmpName);
+    }
+}
+
+/* ===================== Model ===================== */
+
+static MmsValue*
+createValue(DataAttributeType type, const char* text)
+{
+    switch (type) {
+    case IEC61850_BOOLEAN:
+        return MmsValue_newBoolean(strcmp(text, "true") == 0 || strcmp(text, "1") == 0);
+
+    case IEC61850_INT8:
+    case IEC61850_INT16:
+    case IEC61850_INT32:
+    case IEC61850_ENUMERATED:
+        return MmsValue_newIntegerFromInt32((int32_t) strtol(text, NULL, 10));
+
+    case IEC61850_INT64:
+        return MmsValue_newIntegerFromInt64((int64_t) strtoll(text, NULL, 10));
+
+    case IEC61850_INT8U:
+    case IEC61850_INT16U:
+    case IEC61850_INT24U:
+    case IEC61850_INT32U:
+        return MmsValue_newUnsignedFromUint32((uint32_t) strtoul(text, NULL, 10));
+
+    case IEC61850_FLOAT32:
+        return MmsValue_newFloat(strtof(text, NULL));
+
+    case IEC61850_FLOAT64:
+        return MmsValue_newDouble(strtod(text, NULL));
+
+    case IEC61850_VISIBLE_STRING_32:
+    case IEC61850_VISIBLE_STRING_64:
+    case IEC61850_VISIBLE_STRING_65:
+    case IEC61850_VISIBLE_STRING_129:
+    case IEC61850_VISIBLE_STRING_255:
+        return MmsValue_newVisibleString(text);
+
+    default:
+        /* other types start with their default value */
+        return NULL;
+    }
+}
+
+static const char*
+imageString(const ImageView* v, uint32_t offset)
+{
+    return offset ? v->strings + offset : NULL;
+}
+
+/* The kind of node each kind is created below, 0: the model */
+static const uint8_t parentKinds[][2] = {
+    [NODE_LD] = { 0, 0 },
+    [NODE_LN] = { NODE_LD, NODE_LD },
+    [NODE_DO] = { NODE_LN, NODE_DO },
+    [NODE_DA] = { NODE_DO, NODE_DA },
+    [NODE_DATASET] = { NODE_LN, NODE_LN },
+    [NODE_FCDA] = { NODE_DATASET, NODE_DATASET },
+    [NODE_RCB] = { NODE_LN, NODE_LN }
+};
+
+/* Node i and its subtree created below parent; the index after the subtree, 0 on errors */
+static uint32_t
+createNode(const ImageView* v, uint32_t i, void* parent, int parentKind, LogicalNode* ln, int depth)
+{
+    if (i >= v->header->nodeCount || depth > MAX_DEPTH)
+        return 0;
+
+    const ImageNode* n = &v->nodes[i];
+    const char* name = imageString(v, n->name);
+    void* created = NULL;
+
+    if (n->kind < NODE_LD || n->kind > NODE_RCB ||
+            (parentKinds[n->kind][0] != parentKind && parentKinds[n->kind][1] != parentKind))
+        return 0;
+
+    switch (n->kind) {
+    case NODE_LD:
+        created = LogicalDevice_create(name, v->model);
+        break;
+
+    case NODE_LN:
+        created = ln = LogicalNode_create(name, (LogicalDevice*) parent);
+        break;
+
+    case NODE_DO:
+        created = DataObject_create(name, (ModelNode*) parent, n->elements);
+        break;
+
+    case NODE_DA: {
+        DataAttribute* da = DataAttribute_create(name, (ModelNode*) parent, (DataAttributeType) n->type,
+                (FunctionalConstraint) n->fc, n->trgOps, n->elements, 0);
+
+        if (n->text)
+            da->mmsValue = createValue(da->type, imageString(v, n->text));
+
+        created = da;
+        break;
+    }
+
+    case NODE_DATASET:
+        created = DataSet_create(name, ln);
+        break;
+
+    case NODE_FCDA:
+        DataSetEntry_create((DataSet*) parent, imageString(v, n->text), n->elements, NULL);
+        break;
+
+    case NODE_RCB: {
+        const ImageReport* r = &v->reports[n->elements];
+
+        ReportControlBlock_create(name, ln, imageString(v, r->rptId), r->buffered != 0, imageString(v, r->dataSet),
+                r->confRev, r->trgOps, r->options, r->bufTime, r->intgPd);
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    uint32_t next = i + 1;
+
+    if (created == NULL && n->children > 0)
+        return 0;
+
+    for (uint32_t c = 0; c < n->children && next != 0; c++)
+        next = createNode(v, next, created, n->kind, ln, depth + 1);
+
+    return next;
+}
+
+static IedModel*
+createModel(ImageView* v)
+{
+    v->model = IedModel_create(v->header->iedName);
+
+    for (uint32_t i = 0; i < v->header->nodeCount; ) {
+        i = createNode(v, i, NULL, 0, NULL, 0);
+
+        if (i == 0) {
+            printf("SCL: model image is corrupt\n");
+            IedModel_destroy(v->model);
+            return NULL;
+        }
+    }
+
+    return v->model;
+}
+
+/* The header, node and string offsets of a mapped image checked against its size */
+static bool
+checkImage(const ImageView* v, size_t size, uint64_t sourceSize, int64_t sourceTime, uint64_t sourceHash,
+        const char* iedName)
+{
+    const ImageHeader* h = v->header;
+
+    /* an image of the first IED does not stand for --ied with that IED's name, nor the other way round */
+    if (size < sizeof(ImageHeader) || memcmp(h->magic, "SCLM", 4) != 0 || h->version != IMAGE_VERSION ||
+            h->sourceSize != sourceSize || h->sourceTime != sourceTime || h->sourceHash != sourceHash ||
+            h->requested[sizeof(h->requested) - 1] != 0 ||
+            strncmp(h->requested, iedName ? iedName : "", sizeof(h->requested)) != 0)
+        return false;
+
+    if (h->stringBytes == 0 || h->nodeCount > size / sizeof(ImageNode) || h->reportCount > size / sizeof(ImageReport) ||
+            size != sizeof(ImageHeader) + (size_t) h->nodeCount * sizeof(ImageNode) +
+                    (size_t) h->reportCount * sizeof(ImageReport) + h->stringBytes ||
+            v->strings[h->stringBytes - 1] != 0 || h->iedName[sizeof(h->iedName) - 1] != 0)
+        return false;
+
+    for (uint32_t i = 0; i < h->nodeCount; i++) {
+        const ImageNode* n = &v->nodes[i];
+
+        if (n->name >= h->stringBytes || n->text >= h->stringBytes ||
+                (n->kind == NODE_RCB && (n->elements < 0 || (uint32_t) n->elements >= h->reportCount)))
+            return false;
+    }
+
+    for (uint32_t i = 0; i < h->reportCount; i++)
+        if (v->reports[i].rptId >= h->stringBytes || v->reports[i].dataSet >= h->stringBytes)
+            return false;
+
+    return true;
+}
+
+/* The model from an up to date image, NULL if there is none */
+static IedModel*
+loadImage(const char* imageName, uint64_t sourceSize, int64_t sourceTime, uint64_t sourceHash, const char* iedName)
+{
+    const char* data;
+    size_t size;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(imageName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+    LARGE_INTEGER fileSize;
+
+    if (file == INVALID_HANDLE_VALUE)
+        return NULL;
+
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < (LONGLONG) sizeof(ImageHeader)) {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    data = mapping ? (const char*) MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    size = (size_t) fileSize.QuadPart;
+#else
+    int fd = open(imageName, O_RDONLY);
+    struct stat st;
+
+    if (fd < 0)
+        return NULL;
+
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(ImageHeader)) {
+        close(fd);
+        return NULL;
+    }
+
+    size = (size_t) st.st_size;
+    data = (const char*) mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (data == MAP_FAILED)
+        data = NULL;
+#endif
+
+    IedModel* model = NULL;
+
+    if (data) {
+        ImageView v;
+
+        v.header = (const ImageHeader*) data;
+        v.nodes = (const ImageNode*) (data + sizeof(ImageHeader));
+        v.reports = (const ImageReport*) (v.nodes + v.header->nodeCount);
+        v.strings = (const char*) (v.reports + v.header->reportCount);
+        v.model = NULL;
+
+        if (checkImage(&v, size, sourceSize, sourceTime, sourceHash, iedName)) {
+            model = createModel(&v);
+
+            if (model)
+                printf("SCL: model of %s mapped from %s (%u nodes, %lu bytes)\n", v.header->iedName, imageName,
+                        v.header->nodeCount, (unsigned long) size);
+        }
+    }
+
+    /* the model has its own copies of names and values */
+#ifdef _WIN32
+    if (data)
+        UnmapViewOfFile(data);
+
+    if (mapping)
+        CloseHandle(mapping);
+
+    CloseHandle(file);
+#else
+    if (data)
+        munmap((void*) data, size);
+
+    close(fd);
+#endif
+
+    return model;
+}
+
+static char*
+readFile(const char* fileName)
+{
+    FILE* f = fopen(fileName, "rb");
+
+    if (f == NULL)
+        return NULL;
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    char* buffer = size >= 0 ? (char*) malloc(size + 1) : NULL;
+
+    if (buffer && fread(buffer, 1, size, f) != (size_t) size) {
+        free(buffer);
+        buffer = NULL;
+    }
+
+    if (buffer)
+        buffer[size] = 0;
+
+    fclose(f);
+
+    return buffer;
+}
+
+/* The model parsed from the SCL file read into buffer (freed here), its image saved for the next start */
+static IedModel*
+parseScl(const char* fileName, char* buffer, const char* imageName, uint64_t sourceSize, int64_t sourceTime,
+        uint64_t sourceHash, const char* iedName)
+{
+    Scl scl;
+    ImageBuilder b;
+    ImageHeader header;
+    IedModel* model = NULL;
+
+    memset(&scl, 0, sizeof(scl));
+    memset(&b, 0, sizeof(b));
+    memset(&header, 0, sizeof(header));
+
+    scl.buffer = buffer;
+
+    if (parseXml(&scl) && buildImage(&scl, iedName, &b, &header)) {
+        ImageView v;
+
+        memcpy(header.magic, "SCLM", 4);
+        header.version = IMAGE_VERSION;
+        header.sourceSize = sourceSize;
+        header.sourceTime = sourceTime;
+        header.sourceHash = sourceHash;
+        snprintf(header.requested, sizeof(header.requested), "%s", iedName ? iedName : "");
+
+        v.header = &header;
+        v.nodes = b.nodes;
+        v.reports = b.reports;
+        v.strings = b.strings;
+
+        model = createModel(&v);
+
+        if (model) {
+            saveImage(imageName, &header, &b);
+
+            printf("SCL: model of %s parsed from %s (%u nodes), image %s (%lu bytes)\n", header.iedName, fileName,
+                    header.nodeCount, imageName, (unsigned long) (sizeof(ImageHeader) +
+                    header.nodeCount * sizeof(ImageNode) + header.reportCount * sizeof(ImageReport) +
+                    header.stringBytes));
+        }
+    }
+
+    while (scl.chunks) {
+        ArenaChunk* next = scl.chunks->next;
+        free(scl.chunks);
+        scl.chunks = next;
+    }
+
+    free(scl.types);
+    free(scl.buffer);
+    free(b.nodes);
+    free(b.reports);
+    free(b.strings);
+    free(b.slots);
+
+    return model;
+}
+
+IedModel*
+SclModel_load(const char* fileName, const char* iedName)
+{
+    struct stat st;
+    char imageName[512];
+
+    if (stat(fileName, &st) != 0) {
+        printf("SCL: cannot open %s\n", fileName);
+        return NULL;
+    }
+
+    snprintf(imageName, sizeof(imageName), "%s.model", fileName);
+
+    /* read once: hashed for the image key, parsed if the image does not match */
+    char* buffer = readFile(fileName);
+
+    if (buffer == NULL) {
+        printf("SCL: cannot read %s\n", fileName);
+        return NULL;
+    }
+
+    uint64_t sourceHash = hashFile(buffer);
+
+    IedModel* model = loadImage(imageName, (uint64_t) st.st_size, (int64_t) st.st_mtime, sourceHash, iedName);
+
+    if (model == NULL)
+        model = parseScl(fileName, buffer, imageName, (uint64_t) st.st_size, (int64_t) st.st_mtime, sourceHash, iedName);
+    else
+        free(buffer);
+
+    return model;
+}
+
+static int
+countLeaves(ModelNode* node)
+{
+    int count = 0;
+
+    for (ModelNode* c = node->firstChild; c; c = c->sibling) {
+        if (c->modelType == DataAttributeModelType && c->firstChild == NULL)
+            count++;
+        else
+            count += countLeaves(c);
+    }
+
+    return count;
+}
+
+int
+SclModel_countAttributes(IedModel* model)
+{
+    int count = 0;
+
+    for (int i = 0; i < IedModel_getLogicalDeviceCount(model); i++)
+        count += countLeaves((ModelNode*) IedModel_getDeviceByIndex(model, i));
+
+    return count;
+}
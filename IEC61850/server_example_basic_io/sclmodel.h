@@ -0,0 +1,35 @@
+/*
+ *  sclmodel.h
+ *
+ *  The server data model read from an SCL file (.cid, .icd, .scd) at
+ *  startup, instead of static_model.c generated by genmodel.jar.
+ *
+ *  The parsed model is kept next to the SCL file as a binary image
+ *  (<file>.model): the instance tree flattened in preorder into fixed size
+ *  records, names and values in one string table, every reference an
+ *  offset, so the file can be mapped at any address and read in place.
+ *  Later starts map it and only create the libiec61850 model nodes from it,
+ *  without XML parsing and type resolution. The image is built again when
+ *  the SCL file's size, modification time or content hash differ, or the IED
+ *  asked for (the name given, or none for the first IED) is another one.
+ *
+ *  Supported: LDevice, LN0/LN, DO/SDO, DA/BDA (structures, arrays) with
+ *  initial values from DAI/Val and DA/Val (enumerations by name), DataSet
+ *  with FCDA, ReportControl (indexed instances). Not: GSE and SMV control
+ *  blocks, log control blocks, setting groups.
+ */
+
+#ifndef SCLMODEL_H_
+#define SCLMODEL_H_
+
+#include "iec61850_server.h"
+
+/* The model of the IED named iedName, or of the first IED (NULL); NULL on errors */
+IedModel*
+SclModel_load(const char* fileName, const char* iedName);
+
+/* Data attributes of the model, leaves only */
+int
+SclModel_countAttributes(IedModel* model);
+
+#endif /* SCLMODEL_H_ */
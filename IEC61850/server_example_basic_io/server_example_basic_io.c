@@ -4,6 +4,24 @@
  *  - How to use simple control models
  *  - How to serve analog measurement data
  *  - Using the IedServerConfig object to configure stack features
+ *
+ *  server_example_basic_io [port] [events/s] [stall ms] [--load spec]...
+ *                          [--replay file] [--batch n]
+ *                          [--model file.cid [--ied name]] [--bench-index]
+ *                          [--clients n]
+ *  With events/s the SPCSO1..4 stVal are toggled in turn at that rate, one
+ *  report each for the Events RCBs (e.g. EventsBRCB01): a load test for
+ *  report clients. With stall ms, once a second an SPCSO1 event is held that
+ *  long in the locked data model: an injected delay for latency statistics.
+ *  With --load, synthetic points at high rates in the logical device LoadGen
+ *  (see loadgen.h), e.g. --load an:2000:10:walk --load st:500:1:burst.
+ *  With --model, the data model is read from that SCL file instead of
+ *  static_model.c, through its binary image after the first start (see
+ *  sclmodel.h); the SPCSO/AnIn features work where the model has GGIO1.
+ *  With --bench-index, the generated object reference index of static_model.c
+ *  (see modelindex.h) is timed against the model's own lookup, then exit.
+ *  --clients sets how many MMS associations are accepted (default 2), e.g.
+ *  50 to benchmark many clients directly against iec61850_proxy.
  */
 
 #include "iec61850_server.h"
@@ -11,13 +29,129 @@
 #include <signal.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#include <mmsystem.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
 #include "static_model.h"
+#include "loadgen.h"
+#include "sclmodel.h"
+#include "modelindex.h"
+
+/* MMS associations accepted (--clients) */
+#define MAX_CLIENTS 2
 
 static int running = 0;
 static IedServer iedServer = NULL;
 
+/* GenericIO/GGIO1 of the served model, NULL where a loaded model has none */
+static ModelNode* spcso[4];
+
+/* SPCSOn.stVal and .t, toggled by the event burst in turn */
+static DataAttribute* burstValues[4];
+static DataAttribute* burstTimes[4];
+
+static DataAttribute* anInValues[4];
+static DataAttribute* anInTimes[4];
+
+static ModelNode*
+findNode(IedModel* model, const char* format, int n)
+{
+    char ref[80];
+
+    snprintf(ref, sizeof(ref), format, n);
+
+    /* the generated index covers the static model only */
+    if (model == &iedModel)
+        return ModelIndex_findNode(ref);
+
+    return IedModel_getModelNodeByShortObjectReference(model, ref);
+}
+
+static void
+resolveNodes(IedModel* model)
+{
+    for (int i = 0; i < 4; i++) {
+        spcso[i] = findNode(model, "GenericIO/GGIO1.SPCSO%i", i + 1);
+        burstValues[i] = (DataAttribute*) findNode(model, "GenericIO/GGIO1.SPCSO%i.stVal", i + 1);
+        burstTimes[i] = (DataAttribute*) findNode(model, "GenericIO/GGIO1.SPCSO%i.t", i + 1);
+        anInValues[i] = (DataAttribute*) findNode(model, "GenericIO/GGIO1.AnIn%i.mag.f", i + 1);
+        anInTimes[i] = (DataAttribute*) findNode(model, "GenericIO/GGIO1.AnIn%i.t", i + 1);
+    }
+}
+
+/* Resident memory of the process, to compare model sources */
+static unsigned long
+residentKB(void)
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return (unsigned long) (counters.WorkingSetSize / 1024);
+
+    return 0;
+#else
+    unsigned long size = 0, resident = 0;
+    FILE* f = fopen("/proc/self/statm", "r");
+
+    if (f) {
+        if (fscanf(f, "%lu %lu", &size, &resident) != 2)
+            resident = 0;
+
+        fclose(f);
+    }
+
+    return resident * (unsigned long) sysconf(_SC_PAGESIZE) / 1024;
+#endif
+}
+
+/* Toggle SPCSOn.stVal for the events due by now */
+static void
+fireEvents(int eventsPerSecond, uint64_t start, uint64_t now, long* fired)
+{
+    long due = (long) ((now - start) * eventsPerSecond / 1000);
+
+    IedServer_lockDataModel(iedServer);
+
+    for (; *fired < due; (*fired)++) {
+        int k = (int) (*fired % 4);
+        bool state = ((*fired / 4) & 1) == 0;
+
+        if (burstValues[k] == NULL || burstTimes[k] == NULL)
+            continue;
+
+        IedServer_updateUTCTimeAttributeValue(iedServer, burstTimes[k], now);
+        IedServer_updateBooleanAttributeValue(iedServer, burstValues[k], state);
+    }
+
+    IedServer_unlockDataModel(iedServer);
+}
+
+/* One SPCSO1 event stamped now, then the data model held for stallMs: its report waits behind it */
+static void
+stallEvent(int stallMs, bool state)
+{
+    if (burstValues[0] == NULL || burstTimes[0] == NULL)
+        return;
+
+    IedServer_lockDataModel(iedServer);
+
+    IedServer_updateUTCTimeAttributeValue(iedServer, burstTimes[0], Hal_getTimeInMs());
+    IedServer_updateBooleanAttributeValue(iedServer, burstValues[0], state);
+
+    Thread_sleep(stallMs);
+
+    IedServer_unlockDataModel(iedServer);
+}
+
 void
 sigint_handler(int signalId)
 {
@@ -43,24 +177,11 @@ controlHandlerForBinaryOutput(ControlAction action, void* parameter, MmsValue* v
 
     uint64_t timeStamp = Hal_getTimeInMs();
 
-    if (parameter == IEDMODEL_GenericIO_GGIO1_SPCSO1) {
-        IedServer_updateUTCTimeAttributeValue(iedServer, IEDMODEL_GenericIO_GGIO1_SPCSO1_t, timeStamp);
-        IedServer_updateAttributeValue(iedServer, IEDMODEL_GenericIO_GGIO1_SPCSO1_stVal, value);
-    }
-
-    if (parameter == IEDMODEL_GenericIO_GGIO1_SPCSO2) {
-        IedServer_updateUTCTimeAttributeValue(iedServer, IEDMODEL_GenericIO_GGIO1_SPCSO2_t, timeStamp);
-        IedServer_updateAttributeValue(iedServer, IEDMODEL_GenericIO_GGIO1_SPCSO2_stVal, value);
-    }
-
-    if (parameter == IEDMODEL_GenericIO_GGIO1_SPCSO3) {
-        IedServer_updateUTCTimeAttributeValue(iedServer, IEDMODEL_GenericIO_GGIO1_SPCSO3_t, timeStamp);
-        IedServer_updateAttributeValue(iedServer, IEDMODEL_GenericIO_GGIO1_SPCSO3_stVal, value);
-    }
-
-    if (parameter == IEDMODEL_GenericIO_GGIO1_SPCSO4) {
-        IedServer_updateUTCTimeAttributeValue(iedServer, IEDMODEL_GenericIO_GGIO1_SPCSO4_t, timeStamp);
-        IedServer_updateAttributeValue(iedServer, IEDMODEL_GenericIO_GGIO1_SPCSO4_stVal, value);
+    for (int i = 0; i < 4; i++) {
+        if (parameter == spcso[i] && burstValues[i] && burstTimes[i]) {
+            IedServer_updateUTCTimeAttributeValue(iedServer, burstTimes[i], timeStamp);
+            IedServer_updateAttributeValue(iedServer, burstValues[i], value);
+        }
     }
 
     return CONTROL_RESULT_OK;
@@ -102,13 +223,54 @@ int
 main(int argc, char** argv)
 {
     int tcpPort = 102;
-
-    if (argc > 1) {
-        tcpPort = atoi(argv[1]);
+    int eventsPerSecond = 0;
+    int stallMs = 0;
+    int positional = 0;
+    const char* modelFile = NULL;
+    const char* iedName = NULL;
+    bool benchIndex = false;
+    int maxClients = MAX_CLIENTS;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--load") == 0 && i + 1 < argc) {
+            if (!LoadGen_addGroup(argv[++i]))
+                return -1;
+        }
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            if (!LoadGen_setReplayFile(argv[++i]))
+                return -1;
+        }
+        else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc)
+            LoadGen_setBatchSize(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--model") == 0 && i + 1 < argc)
+            modelFile = argv[++i];
+        else if (strcmp(argv[i], "--ied") == 0 && i + 1 < argc)
+            iedName = argv[++i];
+        else if (strcmp(argv[i], "--bench-index") == 0)
+            benchIndex = true;
+        else if (strcmp(argv[i], "--clients") == 0 && i + 1 < argc)
+            maxClients = atoi(argv[++i]);
+        else if (positional == 0) {
+            tcpPort = atoi(argv[i]);
+            positional++;
+        }
+        else if (positional == 1) {
+            eventsPerSecond = atoi(argv[i]);
+            positional++;
+        }
+        else if (positional == 2) {
+            stallMs = atoi(argv[i]);
+            positional++;
+        }
     }
 
     printf("Using libIEC61850 version %s\n", LibIEC61850_getVersionString());
 
+    if (benchIndex) {
+        ModelIndex_benchmark(&iedModel);
+        return 0;
+    }
+
     /* Create new server configuration object */
     IedServerConfig config = IedServerConfig_create();
 
@@ -131,10 +293,34 @@ main(int argc, char** argv)
     IedServerConfig_enableLogService(config, false);
 
     /* set maximum number of clients */
-    IedServerConfig_setMaxMmsConnections(config, 2);
+    IedServerConfig_setMaxMmsConnections(config, maxClients > 0 ? maxClients : MAX_CLIENTS);
+
+    /* the generated static model, or one read from an SCL file */
+    IedModel* model = &iedModel;
+    uint64_t loadStart = Hal_getTimeInMs();
+
+    if (modelFile) {
+        model = SclModel_load(modelFile, iedName);
+
+        if (model == NULL) {
+            IedServerConfig_destroy(config);
+            return -1;
+        }
+    }
+
+    /* synthetic points, if any, join the model */
+    LoadGen_createModel(model);
+
+    uint64_t createStart = Hal_getTimeInMs();
 
     /* Create a new IEC 61850 server instance */
-    iedServer = IedServer_createWithConfig(&iedModel, NULL, config);
+    iedServer = IedServer_createWithConfig(model, NULL, config);
+
+    printf("Model from %s: %i attributes, loaded in %i ms, server created in %i ms, %lu KB resident\n",
+            modelFile ? modelFile : "static_model.c", SclModel_countAttributes(model),
+            (int) (createStart - loadStart), (int) (Hal_getTimeInMs() - createStart), residentKB());
+
+    resolveNodes(model);
 
     /* configuration object is no longer required */
     IedServerConfig_destroy(config);
@@ -143,21 +329,12 @@ main(int argc, char** argv)
     IedServer_setServerIdentity(iedServer, "MZ", "basic io", "1.6.0");
 
     /* Install handler for operate command */
-    IedServer_setControlHandler(iedServer, IEDMODEL_GenericIO_GGIO1_SPCSO1,
-            (ControlHandler) controlHandlerForBinaryOutput,
-            IEDMODEL_GenericIO_GGIO1_SPCSO1);
-
-    IedServer_setControlHandler(iedServer, IEDMODEL_GenericIO_GGIO1_SPCSO2,
-            (ControlHandler) controlHandlerForBinaryOutput,
-            IEDMODEL_GenericIO_GGIO1_SPCSO2);
-
-    IedServer_setControlHandler(iedServer, IEDMODEL_GenericIO_GGIO1_SPCSO3,
-            (ControlHandler) controlHandlerForBinaryOutput,
-            IEDMODEL_GenericIO_GGIO1_SPCSO3);
-
-    IedServer_setControlHandler(iedServer, IEDMODEL_GenericIO_GGIO1_SPCSO4,
-            (ControlHandler) controlHandlerForBinaryOutput,
-            IEDMODEL_GenericIO_GGIO1_SPCSO4);
+    for (int i = 0; i < 4; i++) {
+        if (spcso[i])
+            IedServer_setControlHandler(iedServer, (DataObject*) spcso[i],
+                    (ControlHandler) controlHandlerForBinaryOutput,
+                    spcso[i]);
+    }
 
     IedServer_setConnectionIndicationHandler(iedServer, (IedConnectionIndicationHandler) connectionHandler, NULL);
 
@@ -185,6 +362,25 @@ main(int argc, char** argv)
 
     float t = 0.f;
 
+    uint64_t burstStart = Hal_getTimeInMs();
+    long eventsFired = 0;
+
+    if (eventsPerSecond > 0)
+        printf("Event burst: %i events/s on GGIO1.SPCSO1..4.stVal\n", eventsPerSecond);
+
+#ifdef _WIN32
+    /* the 1 ms event steps below would take a 15.6 ms scheduler tick each otherwise */
+    if (eventsPerSecond > 0)
+        timeBeginPeriod(1);
+#endif
+
+    if (stallMs > 0)
+        printf("Injected delay: reports held %i ms once a second\n", stallMs);
+
+    LoadGen_start(iedServer);
+
+    int loops = 0;
+
     while (running)
     {
         uint64_t timestamp = Hal_getTimeInMs();
@@ -207,31 +403,58 @@ main(int argc, char** argv)
             Timestamp_setClockNotSynchronized(&iecTimestamp, true);
 
 #if 1
+        float an[4] = { an1, an2, an3, an4 };
+
         IedServer_lockDataModel(iedServer);
 
-        IedServer_updateTimestampAttributeValue(iedServer, IEDMODEL_GenericIO_GGIO1_AnIn1_t, &iecTimestamp);
-        IedServer_updateFloatAttributeValue(iedServer, IEDMODEL_GenericIO_GGIO1_AnIn1_mag_f, an1);
+        for (int i = 0; i < 4; i++) {
+            if (anInValues[i] && anInTimes[i]) {
+                IedServer_updateTimestampAttributeValue(iedServer, anInTimes[i], &iecTimestamp);
+                IedServer_updateFloatAttributeValue(iedServer, anInValues[i], an[i]);
+            }
+        }
 
-        IedServer_updateTimestampAttributeValue(iedServer, IEDMODEL_GenericIO_GGIO1_AnIn2_t, &iecTimestamp);
-        IedServer_updateFloatAttributeValue(iedServer, IEDMODEL_GenericIO_GGIO1_AnIn2_mag_f, an2);
+        IedServer_unlockDataModel(iedServer);
+#endif
 
-        IedServer_updateTimestampAttributeValue(iedServer, IEDMODEL_GenericIO_GGIO1_AnIn3_t, &iecTimestamp);
-        IedServer_updateFloatAttributeValue(iedServer, IEDMODEL_GenericIO_GGIO1_AnIn3_mag_f, an3);
+        if (eventsPerSecond > 0) {
+            /* events in 1 ms steps between the analog updates */
+            for (int i = 0; i < 100 && running; i++) {
+                fireEvents(eventsPerSecond, burstStart, Hal_getTimeInMs(), &eventsFired);
+                Thread_sleep(1);
+            }
+        }
+        else
+            Thread_sleep(100);
 
-        IedServer_updateTimestampAttributeValue(iedServer, IEDMODEL_GenericIO_GGIO1_AnIn4_t, &iecTimestamp);
-        IedServer_updateFloatAttributeValue(iedServer, IEDMODEL_GenericIO_GGIO1_AnIn4_mag_f, an4);
+        loops++;
 
-        IedServer_unlockDataModel(iedServer);
-#endif
+        if (stallMs > 0 && loops % 10 == 0)
+            stallEvent(stallMs, (loops / 10) & 1);
 
-        Thread_sleep(100);
+        /* about every 10 s */
+        if (loops % 100 == 0)
+            LoadGen_printStatistics();
     }
 
+    LoadGen_stop();
+
+#ifdef _WIN32
+    if (eventsPerSecond > 0)
+        timeEndPeriod(1);
+#endif
+
+    if (eventsPerSecond > 0)
+        printf("%li events fired\n", eventsFired);
+
     /* stop MMS server - close TCP server socket and all client sockets */
     IedServer_stop(iedServer);
 
     /* Cleanup - free all resources */
     IedServer_destroy(iedServer);
 
+    if (model != &iedModel)
+        IedModel_destroy(model);
+
     return 0;
 } /* main() */
@@ -0,0 +1,382 @@
+/*
+ * static_model_index.c
+ *
+ * automatically generated from static_model.c by genindex
+ */
+#include "static_model.h"
+#include "modelindex.h"
+
+extern DataSet iedModelds_GenericIO_LLN0_Events;
+extern DataSet iedModelds_GenericIO_LLN0_Events2;
+extern DataSet iedModelds_GenericIO_LLN0_Measurements;
+extern ReportControlBlock iedModel_GenericIO_LLN0_report0;
+extern ReportControlBlock iedModel_GenericIO_LLN0_report1;
+extern ReportControlBlock iedModel_GenericIO_LLN0_report2;
+extern ReportControlBlock iedModel_GenericIO_LLN0_report3;
+extern ReportControlBlock iedModel_GenericIO_LLN0_report4;
+extern ReportControlBlock iedModel_GenericIO_LLN0_report5;
+extern ReportControlBlock iedModel_GenericIO_LLN0_report6;
+extern ReportControlBlock iedModel_GenericIO_LLN0_report7;
+extern ReportControlBlock iedModel_GenericIO_LLN0_report8;
+extern ReportControlBlock iedModel_GenericIO_LLN0_report9;
+
+const uint32_t modelIndexBucketCount = 82;
+const uint32_t modelIndexSlotCount = 346;
+
+const uint32_t modelIndexSeeds[] = {
+    11, 1, 2, 72, 2, 8, 2, 12, 47, 15, 36, 20, 100, 201, 7, 20,
+    31, 8, 6, 27, 57, 82, 6, 28, 155, 0, 10, 1, 1, 92, 12, 1,
+    1, 20, 2, 31, 5, 4, 21, 34, 2, 23, 33, 113, 127, 3, 2, 13,
+    7, 174, 3, 36, 10, 109, 13, 27, 75, 26, 121, 100, 55, 63, 33, 103,
+    6, 16, 492, 6, 12, 243, 353, 4, 1, 473, 2, 1632, 562, 7, 107, 3,
+    0, 73
+};
+
+const ModelIndexEntry modelIndexEntries[] = {
+    { "GenericIO/GGIO1.SPCSO3.Oper.Test", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO3_Oper_Test },
+    { "GenericIO/GGIO1.SPCSO1.Oper", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO1_Oper },
+    { "GenericIO/GGIO1$ST$Ind2", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Ind2 },
+    { "GenericIO/LPHD1$ST$PhyHealth", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LPHD1_PhyHealth },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/GGIO1$CO$SPCSO1$Oper$ctlNum", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO1_Oper_ctlNum },
+    { "GenericIO/LPHD1$ST$PhyHealth$t", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LPHD1_PhyHealth_t },
+    { "GenericIO/GGIO1$CO$SPCSO2$Oper$origin$orCat", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO2_Oper_origin_orCat },
+    { "GenericIO/GGIO1$CO$SPCSO1", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO1 },
+    { "GenericIO/LLN0$EX$NamPlt", MODEL_INDEX_NODE, IEC61850_FC_EX, &iedModel_GenericIO_LLN0_NamPlt },
+    { "GenericIO/GGIO1$CO$SPCSO2$Oper$T", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO2_Oper_T },
+    { "GenericIO/GGIO1.Ind2.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Ind2_t },
+    { "GenericIO/GGIO1.AnIn4.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn4_q },
+    { "GenericIO/GGIO1$CO$SPCSO1$Oper$Check", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO1_Oper_Check },
+    { "GenericIO/GGIO1.Ind1.stVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Ind1_stVal },
+    { "GenericIO/GGIO1$CO$SPCSO3$Oper$origin$orCat", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO3_Oper_origin_orCat },
+    { "GenericIO/GGIO1$MX$AnIn3$mag$f", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn3_mag_f },
+    { "GenericIO/GGIO1.SPCSO2.stVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO2_stVal },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/GGIO1.SPCSO4.Oper.ctlVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO4_Oper_ctlVal },
+    { "GenericIO/GGIO1.AnIn1.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn1_q },
+    { "GenericIO/LLN0$Measurements", MODEL_INDEX_DATA_SET, IEC61850_FC_NONE, &iedModelds_GenericIO_LLN0_Measurements },
+    { "GenericIO/GGIO1$ST$SPCSO3$stVal", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO3_stVal },
+    { "GenericIO/GGIO1.SPCSO3.ctlModel", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO3_ctlModel },
+    { "GenericIO/LPHD1.PhyHealth", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LPHD1_PhyHealth },
+    { "GenericIO/GGIO1.NamPlt.swRev", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_NamPlt_swRev },
+    { "GenericIO/GGIO1.SPCSO1.ctlModel", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO1_ctlModel },
+    { "GenericIO/GGIO1.SPCSO1.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO1_q },
+    { "GenericIO/GGIO1.Beh.stVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Beh_stVal },
+    { "GenericIO/GGIO1.AnIn4", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn4 },
+    { "GenericIO/GGIO1.SPCSO3.Oper.origin.orCat", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO3_Oper_origin_orCat },
+    { "GenericIO/LLN0$BR$EventsBRCBPreConf01", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report3 },
+    { "GenericIO/GGIO1.SPCSO3.Oper.ctlNum", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO3_Oper_ctlNum },
+    { "GenericIO/GGIO1.SPCSO2.Oper", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO2_Oper },
+    { "GenericIO/GGIO1$CO$SPCSO3$Oper$Check", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO3_Oper_Check },
+    { "GenericIO/GGIO1$ST$Health", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Health },
+    { "GenericIO/GGIO1.Mod.ctlModel", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Mod_ctlModel },
+    { "GenericIO/LLN0.BR.EventsBRCB01", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report2 },
+    { "GenericIO/GGIO1.AnIn1.mag", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn1_mag },
+    { "GenericIO/LLN0$DC$NamPlt$vendor", MODEL_INDEX_NODE, IEC61850_FC_DC, &iedModel_GenericIO_LLN0_NamPlt_vendor },
+    { "GenericIO/GGIO1.Mod", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Mod },
+    { "GenericIO/GGIO1$ST$SPCSO4$q", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO4_q },
+    { "GenericIO/GGIO1.Ind3.stVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Ind3_stVal },
+    { "GenericIO/LPHD1.PhyHealth.stVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LPHD1_PhyHealth_stVal },
+    { "GenericIO/GGIO1.SPCSO1.ctlNum", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO1_ctlNum },
+    { "GenericIO/GGIO1$ST$Ind4", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Ind4 },
+    { "GenericIO/GGIO1.SPCSO2.Oper.ctlNum", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO2_Oper_ctlNum },
+    { "GenericIO/GGIO1.SPCSO1.Oper.origin", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO1_Oper_origin },
+    { "GenericIO/GGIO1$ST$SPCSO1$origin$orIdent", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO1_origin_orIdent },
+    { "GenericIO/GGIO1.SPCSO1.Oper.Test", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO1_Oper_Test },
+    { "GenericIO/LPHD1$DC$PhyNam$vendor", MODEL_INDEX_NODE, IEC61850_FC_DC, &iedModel_GenericIO_LPHD1_PhyNam_vendor },
+    { "GenericIO/LLN0.Health.stVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_Health_stVal },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/GGIO1$CO$SPCSO3$Oper$Test", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO3_Oper_Test },
+    { "GenericIO/GGIO1.SPCSO2.Oper.Check", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO2_Oper_Check },
+    { "GenericIO/GGIO1$ST$Beh$q", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Beh_q },
+    { "GenericIO/GGIO1.Mod.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Mod_q },
+    { "GenericIO/LLN0", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0 },
+    { "GenericIO/GGIO1.SPCSO2.Oper.origin", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO2_Oper_origin },
+    { "GenericIO/GGIO1$ST$SPCSO4", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO4 },
+    { "GenericIO/GGIO1$CO$SPCSO2$Oper$Test", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO2_Oper_Test },
+    { "GenericIO/GGIO1.AnIn3.mag.f", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn3_mag_f },
+    { "GenericIO/LLN0$ST$Mod", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LLN0_Mod },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/LPHD1$DC$PhyNam", MODEL_INDEX_NODE, IEC61850_FC_DC, &iedModel_GenericIO_LPHD1_PhyNam },
+    { "GenericIO/GGIO1$CO$SPCSO3$Oper", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO3_Oper },
+    { "GenericIO/GGIO1.SPCSO1.Oper.ctlNum", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO1_Oper_ctlNum },
+    { "GenericIO/GGIO1.SPCSO1", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO1 },
+    { "GenericIO/GGIO1.Health", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Health },
+    { "GenericIO/GGIO1$CO$SPCSO3$Oper$origin", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO3_Oper_origin },
+    { "GenericIO/GGIO1.SPCSO4.Oper.origin.orCat", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO4_Oper_origin_orCat },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/LLN0.BR.Measurements03", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report9 },
+    { "GenericIO/GGIO1.Ind1.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Ind1_q },
+    { "GenericIO/GGIO1$CF$SPCSO2$ctlModel", MODEL_INDEX_NODE, IEC61850_FC_CF, &iedModel_GenericIO_GGIO1_SPCSO2_ctlModel },
+    { "GenericIO/GGIO1.Ind2.stVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Ind2_stVal },
+    { "GenericIO/GGIO1.SPCSO4.Oper.ctlNum", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO4_Oper_ctlNum },
+    { "GenericIO/GGIO1$ST$Ind3$t", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Ind3_t },
+    { "GenericIO/GGIO1.Mod.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Mod_t },
+    { "GenericIO/LLN0$ST$Health$stVal", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LLN0_Health_stVal },
+    { "GenericIO/GGIO1.AnIn1", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn1 },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/GGIO1$CO$SPCSO1$Oper", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO1_Oper },
+    { "GenericIO/LLN0.BR.Measurements01", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report7 },
+    { "GenericIO/GGIO1.AnIn1.mag.f", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn1_mag_f },
+    { "GenericIO/GGIO1.Mod.stVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Mod_stVal },
+    { "GenericIO/GGIO1.SPCSO3.Oper.ctlVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO3_Oper_ctlVal },
+    { "GenericIO/LLN0$ST$Beh$q", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LLN0_Beh_q },
+    { "GenericIO/GGIO1.Beh.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Beh_q },
+    { "GenericIO/GGIO1.AnIn3", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn3 },
+    { "GenericIO/GGIO1.Health.stVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Health_stVal },
+    { "GenericIO/GGIO1.Ind2.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Ind2_q },
+    { "GenericIO/GGIO1$CO$SPCSO1$Oper$ctlVal", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO1_Oper_ctlVal },
+    { "GenericIO/GGIO1.Ind4.stVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Ind4_stVal },
+    { "GenericIO/GGIO1.AnIn2.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn2_q },
+    { "GenericIO/GGIO1.SPCSO4.ctlModel", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO4_ctlModel },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/GGIO1$ST$SPCSO3$t", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO3_t },
+    { "GenericIO/GGIO1$CO$SPCSO4$Oper$T", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO4_Oper_T },
+    { "GenericIO/GGIO1$MX$AnIn3", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn3 },
+    { "GenericIO/LLN0.Mod", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_Mod },
+    { "GenericIO/LPHD1$ST$Proxy$stVal", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LPHD1_Proxy_stVal },
+    { "GenericIO/GGIO1$CO$SPCSO1$Oper$origin$orCat", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO1_Oper_origin_orCat },
+    { "GenericIO/LPHD1.PhyNam.vendor", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LPHD1_PhyNam_vendor },
+    { "GenericIO/LLN0.NamPlt.d", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_NamPlt_d },
+    { "GenericIO/LLN0$RP$EventsRCBPreConf01", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report1 },
+    { "GenericIO/GGIO1$CO$SPCSO2$Oper$origin$orIdent", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO2_Oper_origin_orIdent },
+    { "GenericIO/LLN0$ST$Health$t", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LLN0_Health_t },
+    { "GenericIO/LPHD1.PhyHealth.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LPHD1_PhyHealth_t },
+    { "GenericIO/GGIO1$ST$Ind4$stVal", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Ind4_stVal },
+    { "GenericIO/GGIO1$DC$NamPlt$d", MODEL_INDEX_NODE, IEC61850_FC_DC, &iedModel_GenericIO_GGIO1_NamPlt_d },
+    { "GenericIO/LLN0.RP.EventsIndexed03", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report6 },
+    { "GenericIO/LLN0.NamPlt", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_NamPlt },
+    { "GenericIO/GGIO1$MX$AnIn3$t", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn3_t },
+    { "GenericIO/GGIO1.SPCSO3.Oper.origin.orIdent", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO3_Oper_origin_orIdent },
+    { "GenericIO/GGIO1$MX$AnIn3$q", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn3_q },
+    { "GenericIO/LPHD1$ST$PhyHealth$stVal", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LPHD1_PhyHealth_stVal },
+    { "GenericIO/LLN0.BR.EventsBRCBPreConf01", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report3 },
+    { "GenericIO/GGIO1$MX$AnIn4$mag", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn4_mag },
+    { "GenericIO/GGIO1$ST$SPCSO2", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO2 },
+    { "GenericIO/GGIO1.SPCSO1.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO1_t },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/GGIO1$MX$AnIn1$mag$f", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn1_mag_f },
+    { "GenericIO/GGIO1$ST$Mod$t", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Mod_t },
+    { "GenericIO/GGIO1.SPCSO2.Oper.T", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO2_Oper_T },
+    { "GenericIO/LLN0.Beh.stVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_Beh_stVal },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/GGIO1$CO$SPCSO3$Oper$origin$orIdent", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO3_Oper_origin_orIdent },
+    { "GenericIO/LLN0.RP.EventsIndexed01", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report4 },
+    { "GenericIO/LLN0.Health.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_Health_t },
+    { "GenericIO/GGIO1.SPCSO2.Oper.origin.orIdent", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO2_Oper_origin_orIdent },
+    { "GenericIO/GGIO1.SPCSO1.Oper.T", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO1_Oper_T },
+    { "GenericIO/GGIO1.SPCSO2.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO2_q },
+    { "GenericIO/GGIO1.SPCSO4.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO4_t },
+    { "GenericIO/GGIO1$ST$Health$q", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Health_q },
+    { "GenericIO/GGIO1$ST$SPCSO2$t", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO2_t },
+    { "GenericIO/GGIO1$CO$SPCSO3$Oper$T", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO3_Oper_T },
+    { "GenericIO/GGIO1$MX$AnIn2$t", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn2_t },
+    { "GenericIO/LLN0$ST$Health$q", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LLN0_Health_q },
+    { "GenericIO/GGIO1.SPCSO1.origin", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO1_origin },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/GGIO1$DC$NamPlt", MODEL_INDEX_NODE, IEC61850_FC_DC, &iedModel_GenericIO_GGIO1_NamPlt },
+    { "GenericIO/GGIO1$ST$Ind1$t", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Ind1_t },
+    { "GenericIO/GGIO1$ST$Mod$q", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Mod_q },
+    { "GenericIO", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO },
+    { "GenericIO/GGIO1.AnIn2.mag.f", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn2_mag_f },
+    { "GenericIO/GGIO1$DC$NamPlt$swRev", MODEL_INDEX_NODE, IEC61850_FC_DC, &iedModel_GenericIO_GGIO1_NamPlt_swRev },
+    { "GenericIO/GGIO1$ST$SPCSO1$origin", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO1_origin },
+    { "GenericIO/GGIO1$CO$SPCSO2", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO2 },
+    { "GenericIO/GGIO1$MX$AnIn4$t", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn4_t },
+    { "GenericIO/GGIO1$CF$SPCSO1$ctlModel", MODEL_INDEX_NODE, IEC61850_FC_CF, &iedModel_GenericIO_GGIO1_SPCSO1_ctlModel },
+    { "GenericIO/LLN0.Beh", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_Beh },
+    { "GenericIO/GGIO1.SPCSO1.Oper.origin.orCat", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO1_Oper_origin_orCat },
+    { "GenericIO/LLN0.Mod.ctlModel", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_Mod_ctlModel },
+    { "GenericIO/LLN0$RP$EventsIndexed02", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report5 },
+    { "GenericIO/GGIO1$ST$Ind4$q", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Ind4_q },
+    { "GenericIO/GGIO1.SPCSO4.Oper", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO4_Oper },
+    { "GenericIO/GGIO1.SPCSO2.ctlModel", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO2_ctlModel },
+    { "GenericIO/GGIO1.SPCSO3.Oper.origin", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO3_Oper_origin },
+    { "GenericIO/LLN0$ST$Beh$t", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LLN0_Beh_t },
+    { "GenericIO/GGIO1$ST$SPCSO3$q", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO3_q },
+    { "GenericIO/GGIO1.SPCSO4.Oper.origin.orIdent", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO4_Oper_origin_orIdent },
+    { "GenericIO/GGIO1$CO$SPCSO2$Oper$Check", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO2_Oper_Check },
+    { "GenericIO/GGIO1$CF$SPCSO1", MODEL_INDEX_NODE, IEC61850_FC_CF, &iedModel_GenericIO_GGIO1_SPCSO1 },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/LPHD1.Proxy.stVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LPHD1_Proxy_stVal },
+    { "GenericIO/GGIO1$CF$Mod", MODEL_INDEX_NODE, IEC61850_FC_CF, &iedModel_GenericIO_GGIO1_Mod },
+    { "GenericIO/LPHD1$ST$Proxy", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LPHD1_Proxy },
+    { "GenericIO/GGIO1$MX$AnIn2$q", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn2_q },
+    { "GenericIO/GGIO1.SPCSO4.Oper.Check", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO4_Oper_Check },
+    { "GenericIO/GGIO1$ST$Ind2$q", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Ind2_q },
+    { "GenericIO/GGIO1$CO$SPCSO2$Oper$origin", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO2_Oper_origin },
+    { "GenericIO/GGIO1.Health.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Health_t },
+    { "GenericIO/LLN0$CF$Mod", MODEL_INDEX_NODE, IEC61850_FC_CF, &iedModel_GenericIO_LLN0_Mod },
+    { "GenericIO/GGIO1.Ind4.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Ind4_t },
+    { "GenericIO/GGIO1.SPCSO2.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO2_t },
+    { "GenericIO/LLN0$ST$Mod$stVal", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LLN0_Mod_stVal },
+    { "GenericIO/GGIO1$ST$Ind3", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Ind3 },
+    { "GenericIO/GGIO1.SPCSO1.origin.orIdent", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO1_origin_orIdent },
+    { "GenericIO/GGIO1.Ind3", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Ind3 },
+    { "GenericIO/GGIO1$ST$SPCSO3", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO3 },
+    { "GenericIO/LLN0.Mod.stVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_Mod_stVal },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/LLN0.NamPlt.ldNs", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_NamPlt_ldNs },
+    { "GenericIO/GGIO1$ST$Health$stVal", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Health_stVal },
+    { "GenericIO/GGIO1.SPCSO2.Oper.origin.orCat", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO2_Oper_origin_orCat },
+    { "GenericIO/GGIO1.SPCSO3.Oper.T", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO3_Oper_T },
+    { "GenericIO/GGIO1$ST$Beh$t", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Beh_t },
+    { "GenericIO/GGIO1$ST$Ind1", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Ind1 },
+    { "GenericIO/GGIO1.SPCSO3.Oper", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO3_Oper },
+    { "GenericIO/GGIO1$MX$AnIn2", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn2 },
+    { "GenericIO/GGIO1$ST$Ind3$stVal", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Ind3_stVal },
+    { "GenericIO/GGIO1.AnIn1.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn1_t },
+    { "GenericIO/GGIO1.AnIn3.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn3_q },
+    { "GenericIO/GGIO1.SPCSO3.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO3_t },
+    { "GenericIO/GGIO1.SPCSO1.Oper.origin.orIdent", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO1_Oper_origin_orIdent },
+    { "GenericIO/GGIO1$ST$Ind3$q", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Ind3_q },
+    { "GenericIO/GGIO1.SPCSO2", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO2 },
+    { "GenericIO/LLN0.Health.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_Health_q },
+    { "GenericIO/GGIO1$ST$SPCSO1$ctlNum", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO1_ctlNum },
+    { "GenericIO/GGIO1$CO$SPCSO1$Oper$T", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO1_Oper_T },
+    { "GenericIO/GGIO1$MX$AnIn4$q", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn4_q },
+    { "GenericIO/GGIO1$ST$SPCSO1$t", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO1_t },
+    { "GenericIO/GGIO1.AnIn2", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn2 },
+    { "GenericIO/GGIO1$CF$SPCSO3$ctlModel", MODEL_INDEX_NODE, IEC61850_FC_CF, &iedModel_GenericIO_GGIO1_SPCSO3_ctlModel },
+    { "GenericIO/GGIO1$ST$SPCSO1", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO1 },
+    { "GenericIO/GGIO1.Ind1", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Ind1 },
+    { "GenericIO/GGIO1$CF$Mod$ctlModel", MODEL_INDEX_NODE, IEC61850_FC_CF, &iedModel_GenericIO_GGIO1_Mod_ctlModel },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/GGIO1", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1 },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/GGIO1.AnIn2.mag", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn2_mag },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/GGIO1$ST$Mod", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Mod },
+    { "GenericIO/GGIO1$ST$Beh", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Beh },
+    { "GenericIO/LPHD1$ST$Proxy$q", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LPHD1_Proxy_q },
+    { "GenericIO/LLN0.Beh.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_Beh_q },
+    { "GenericIO/GGIO1$CO$SPCSO4$Oper$Test", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO4_Oper_Test },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/GGIO1.SPCSO1.Oper.ctlVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO1_Oper_ctlVal },
+    { "GenericIO/GGIO1$MX$AnIn1$t", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn1_t },
+    { "GenericIO/GGIO1$CO$SPCSO1$Oper$origin", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO1_Oper_origin },
+    { "GenericIO/GGIO1$CO$SPCSO4", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO4 },
+    { "GenericIO/GGIO1.AnIn4.mag", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn4_mag },
+    { "GenericIO/GGIO1$CO$SPCSO1$Oper$Test", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO1_Oper_Test },
+    { "GenericIO/GGIO1$ST$SPCSO1$stVal", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO1_stVal },
+    { "GenericIO/GGIO1.SPCSO4", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO4 },
+    { "GenericIO/LLN0.Measurements", MODEL_INDEX_DATA_SET, IEC61850_FC_NONE, &iedModelds_GenericIO_LLN0_Measurements },
+    { "GenericIO/GGIO1$MX$AnIn1$q", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn1_q },
+    { "GenericIO/LPHD1.PhyHealth.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LPHD1_PhyHealth_q },
+    { "GenericIO/LLN0$RP$EventsIndexed01", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report4 },
+    { "GenericIO/LPHD1.Proxy.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LPHD1_Proxy_q },
+    { "GenericIO/LLN0.NamPlt.configRev", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_NamPlt_configRev },
+    { "GenericIO/GGIO1.SPCSO3.stVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO3_stVal },
+    { "GenericIO/GGIO1.AnIn4.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn4_t },
+    { "GenericIO/GGIO1.Ind3.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Ind3_q },
+    { "GenericIO/GGIO1$CO$SPCSO4$Oper$origin$orCat", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO4_Oper_origin_orCat },
+    { "GenericIO/GGIO1$CO$SPCSO4$Oper$origin", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO4_Oper_origin },
+    { "GenericIO/LLN0.Mod.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_Mod_q },
+    { "GenericIO/GGIO1.NamPlt.d", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_NamPlt_d },
+    { "GenericIO/LPHD1.Proxy", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LPHD1_Proxy },
+    { "GenericIO/LLN0.Mod.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_Mod_t },
+    { "GenericIO/LLN0$BR$Measurements03", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report9 },
+    { "GenericIO/GGIO1.SPCSO1.stVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO1_stVal },
+    { "GenericIO/GGIO1$ST$Beh$stVal", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Beh_stVal },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/LLN0.RP.EventsIndexed02", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report5 },
+    { "GenericIO/LLN0$ST$Beh$stVal", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LLN0_Beh_stVal },
+    { "GenericIO/LLN0$DC$NamPlt$d", MODEL_INDEX_NODE, IEC61850_FC_DC, &iedModel_GenericIO_LLN0_NamPlt_d },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/GGIO1.SPCSO4.Oper.Test", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO4_Oper_Test },
+    { "GenericIO/LLN0.NamPlt.vendor", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_NamPlt_vendor },
+    { "GenericIO/LLN0$RP$EventsRCB01", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report0 },
+    { "GenericIO/LLN0$DC$NamPlt$configRev", MODEL_INDEX_NODE, IEC61850_FC_DC, &iedModel_GenericIO_LLN0_NamPlt_configRev },
+    { "GenericIO/GGIO1$ST$SPCSO1$q", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO1_q },
+    { "GenericIO/LLN0.Events", MODEL_INDEX_DATA_SET, IEC61850_FC_NONE, &iedModelds_GenericIO_LLN0_Events },
+    { "GenericIO/LLN0$ST$Beh", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LLN0_Beh },
+    { "GenericIO/GGIO1$ST$SPCSO2$stVal", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO2_stVal },
+    { "GenericIO/GGIO1$MX$AnIn4", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn4 },
+    { "GenericIO/GGIO1$CO$SPCSO3", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO3 },
+    { "GenericIO/LLN0$CF$Mod$ctlModel", MODEL_INDEX_NODE, IEC61850_FC_CF, &iedModel_GenericIO_LLN0_Mod_ctlModel },
+    { "GenericIO/GGIO1$CO$SPCSO4$Oper$origin$orIdent", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO4_Oper_origin_orIdent },
+    { "GenericIO/GGIO1$ST$Ind4$t", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Ind4_t },
+    { "GenericIO/GGIO1.SPCSO4.Oper.origin", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO4_Oper_origin },
+    { "GenericIO/GGIO1.SPCSO3.Oper.Check", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO3_Oper_Check },
+    { "GenericIO/GGIO1.Beh.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Beh_t },
+    { "GenericIO/GGIO1.AnIn3.mag", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn3_mag },
+    { "GenericIO/LLN0.NamPlt.swRev", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_NamPlt_swRev },
+    { "GenericIO/GGIO1$CF$SPCSO2", MODEL_INDEX_NODE, IEC61850_FC_CF, &iedModel_GenericIO_GGIO1_SPCSO2 },
+    { "GenericIO/LLN0$Events2", MODEL_INDEX_DATA_SET, IEC61850_FC_NONE, &iedModelds_GenericIO_LLN0_Events2 },
+    { "GenericIO/GGIO1$CO$SPCSO4$Oper$ctlVal", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO4_Oper_ctlVal },
+    { "GenericIO/LLN0$DC$NamPlt$swRev", MODEL_INDEX_NODE, IEC61850_FC_DC, &iedModel_GenericIO_LLN0_NamPlt_swRev },
+    { "GenericIO/GGIO1$ST$Ind2$stVal", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Ind2_stVal },
+    { "GenericIO/GGIO1.SPCSO4.stVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO4_stVal },
+    { "GenericIO/GGIO1$MX$AnIn1", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn1 },
+    { "GenericIO/LLN0$ST$Mod$t", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LLN0_Mod_t },
+    { "GenericIO/LLN0.RP.EventsRCBPreConf01", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report1 },
+    { "GenericIO/GGIO1$CO$SPCSO4$Oper$ctlNum", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO4_Oper_ctlNum },
+    { "GenericIO/LLN0$BR$EventsBRCB01", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report2 },
+    { "GenericIO/GGIO1$CF$SPCSO3", MODEL_INDEX_NODE, IEC61850_FC_CF, &iedModel_GenericIO_GGIO1_SPCSO3 },
+    { "GenericIO/GGIO1.NamPlt", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_NamPlt },
+    { "GenericIO/GGIO1$MX$AnIn2$mag$f", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn2_mag_f },
+    { "GenericIO/LLN0.Events2", MODEL_INDEX_DATA_SET, IEC61850_FC_NONE, &iedModelds_GenericIO_LLN0_Events2 },
+    { "GenericIO/GGIO1$ST$Mod$stVal", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Mod_stVal },
+    { "GenericIO/LLN0$Events", MODEL_INDEX_DATA_SET, IEC61850_FC_NONE, &iedModelds_GenericIO_LLN0_Events },
+    { "GenericIO/GGIO1$CF$SPCSO4$ctlModel", MODEL_INDEX_NODE, IEC61850_FC_CF, &iedModel_GenericIO_GGIO1_SPCSO4_ctlModel },
+    { "GenericIO/GGIO1$CO$SPCSO3$Oper$ctlNum", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO3_Oper_ctlNum },
+    { "GenericIO/LPHD1$ST$PhyHealth$q", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LPHD1_PhyHealth_q },
+    { "GenericIO/LLN0$RP$EventsIndexed03", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report6 },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/GGIO1.AnIn2.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn2_t },
+    { "GenericIO/LLN0$DC$NamPlt", MODEL_INDEX_NODE, IEC61850_FC_DC, &iedModel_GenericIO_LLN0_NamPlt },
+    { "GenericIO/LLN0$EX$NamPlt$ldNs", MODEL_INDEX_NODE, IEC61850_FC_EX, &iedModel_GenericIO_LLN0_NamPlt_ldNs },
+    { "GenericIO/GGIO1$ST$SPCSO4$stVal", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO4_stVal },
+    { "GenericIO/GGIO1$ST$Health$t", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Health_t },
+    { "GenericIO/LLN0.Beh.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_Beh_t },
+    { "GenericIO/GGIO1.Health.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Health_q },
+    { "GenericIO/GGIO1.Ind4.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Ind4_q },
+    { "GenericIO/GGIO1.SPCSO1.origin.orCat", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO1_origin_orCat },
+    { "GenericIO/GGIO1$CO$SPCSO2$Oper$ctlNum", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO2_Oper_ctlNum },
+    { "GenericIO/GGIO1$CO$SPCSO2$Oper", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO2_Oper },
+    { "GenericIO/GGIO1$ST$Ind1$stVal", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Ind1_stVal },
+    { "GenericIO/GGIO1.Ind3.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Ind3_t },
+    { "GenericIO/GGIO1.AnIn4.mag.f", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn4_mag_f },
+    { NULL, MODEL_INDEX_NODE, IEC61850_FC_NONE, NULL },
+    { "GenericIO/LLN0$BR$Measurements01", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report7 },
+    { "GenericIO/GGIO1.Ind1.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Ind1_t },
+    { "GenericIO/GGIO1.SPCSO3", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO3 },
+    { "GenericIO/LPHD1.Proxy.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LPHD1_Proxy_t },
+    { "GenericIO/GGIO1$CO$SPCSO3$Oper$ctlVal", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO3_Oper_ctlVal },
+    { "GenericIO/GGIO1$ST$Ind2$t", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Ind2_t },
+    { "GenericIO/GGIO1$ST$Ind1$q", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_Ind1_q },
+    { "GenericIO/GGIO1.Ind2", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Ind2 },
+    { "GenericIO/LLN0.RP.EventsRCB01", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report0 },
+    { "GenericIO/LPHD1.PhyNam", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LPHD1_PhyNam },
+    { "GenericIO/LPHD1$ST$Proxy$t", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LPHD1_Proxy_t },
+    { "GenericIO/GGIO1.NamPlt.vendor", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_NamPlt_vendor },
+    { "GenericIO/GGIO1.SPCSO4.Oper.T", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO4_Oper_T },
+    { "GenericIO/GGIO1.SPCSO4.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO4_q },
+    { "GenericIO/GGIO1.SPCSO1.Oper.Check", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO1_Oper_Check },
+    { "GenericIO/GGIO1.Beh", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Beh },
+    { "GenericIO/GGIO1$DC$NamPlt$vendor", MODEL_INDEX_NODE, IEC61850_FC_DC, &iedModel_GenericIO_GGIO1_NamPlt_vendor },
+    { "GenericIO/LPHD1", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LPHD1 },
+    { "GenericIO/GGIO1$CO$SPCSO2$Oper$ctlVal", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO2_Oper_ctlVal },
+    { "GenericIO/LLN0.Health", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_Health },
+    { "GenericIO/LLN0.BR.Measurements02", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report8 },
+    { "GenericIO/LLN0$ST$Health", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LLN0_Health },
+    { "GenericIO/GGIO1$MX$AnIn3$mag", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn3_mag },
+    { "GenericIO/GGIO1$MX$AnIn4$mag$f", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn4_mag_f },
+    { "GenericIO/GGIO1.SPCSO2.Oper.ctlVal", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO2_Oper_ctlVal },
+    { "GenericIO/GGIO1.Ind4", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_Ind4 },
+    { "GenericIO/GGIO1$ST$SPCSO1$origin$orCat", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO1_origin_orCat },
+    { "GenericIO/LLN0$BR$Measurements02", MODEL_INDEX_RCB, IEC61850_FC_NONE, &iedModel_GenericIO_LLN0_report8 },
+    { "GenericIO/LLN0$ST$Mod$q", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_LLN0_Mod_q },
+    { "GenericIO/GGIO1$MX$AnIn2$mag", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn2_mag },
+    { "GenericIO/GGIO1.SPCSO3.q", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO3_q },
+    { "GenericIO/GGIO1$ST$SPCSO4$t", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO4_t },
+    { "GenericIO/GGIO1$CO$SPCSO1$Oper$origin$orIdent", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO1_Oper_origin_orIdent },
+    { "GenericIO/GGIO1$MX$AnIn1$mag", MODEL_INDEX_NODE, IEC61850_FC_MX, &iedModel_GenericIO_GGIO1_AnIn1_mag },
+    { "GenericIO/GGIO1$ST$SPCSO2$q", MODEL_INDEX_NODE, IEC61850_FC_ST, &iedModel_GenericIO_GGIO1_SPCSO2_q },
+    { "GenericIO/GGIO1.AnIn3.t", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_AnIn3_t },
+    { "GenericIO/GGIO1.SPCSO2.Oper.Test", MODEL_INDEX_NODE, IEC61850_FC_NONE, &iedModel_GenericIO_GGIO1_SPCSO2_Oper_Test },
+    { "GenericIO/GGIO1$CO$SPCSO4$Oper", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO4_Oper },
+    { "GenericIO/GGIO1$CF$SPCSO4", MODEL_INDEX_NODE, IEC61850_FC_CF, &iedModel_GenericIO_GGIO1_SPCSO4 },
+    { "GenericIO/GGIO1$CO$SPCSO4$Oper$Check", MODEL_INDEX_NODE, IEC61850_FC_CO, &iedModel_GenericIO_GGIO1_SPCSO4_Oper_Check }
+};